@@ -77,6 +77,7 @@
 #include "EffectInfo.h"
 #include "Enums.h"
 #include "Exceptions.h"
+#include "Executor.h"
 #include "FFmpegReader.h"
 #include "FFmpegWriter.h"
 #include "Fraction.h"
@@ -89,9 +90,12 @@
 #include "QtImageReader.h"
 #include "QtPlayer.h"
 #include "QtTextReader.h"
+#include "QtTitleReader.h"
 #include "KeyFrame.h"
+#include "RenderCache.h"
 #include "RendererBase.h"
 #include "Settings.h"
+#include "ThumbnailExtractor.h"
 #include "TimelineBase.h"
 #include "Timeline.h"
 #include "ZmqLogger.h"
@@ -125,6 +129,55 @@
 	}
 }
 
+/* Release the GIL around long-running calls (decoding, rendering, encoding), so other
+ * Python threads can run in parallel. The GIL is re-acquired (by the guard's destructor)
+ * before any exception is converted to a Python error. */
+%{
+	class OpenShotReleaseGIL {
+	private:
+		PyThreadState *state;
+	public:
+		OpenShotReleaseGIL() { state = PyEval_SaveThread(); }
+		~OpenShotReleaseGIL() { PyEval_RestoreThread(state); }
+	};
+%}
+%define %openshot_release_gil(method)
+%exception method {
+	try {
+		OpenShotReleaseGIL release_gil;
+		$action
+	}
+	catch (std::exception &e) {
+		SWIG_exception_fail(SWIG_RuntimeError, e.what());
+	}
+}
+%enddef
+%openshot_release_gil(openshot::ReaderBase::GetFrame)
+%openshot_release_gil(openshot::FFmpegReader::GetFrame)
+%openshot_release_gil(openshot::Timeline::GetFrame)
+%openshot_release_gil(openshot::WriterBase::WriteFrame)
+%openshot_release_gil(openshot::FFmpegWriter::WriteFrame)
+
+%init %{
+#if PY_VERSION_HEX < 0x03070000
+	/* Python < 3.7 only creates the GIL on demand */
+	PyEval_InitThreads();
+#endif
+%}
+
+/* Python owns the settings copies it creates */
+%newobject openshot::Settings::Create;
+
+/* Compact binary strings (i.e. Timeline::Binary) are Python bytes objects, not text */
+%typemap(out) std::string Binary {
+	$result = PyBytes_FromStringAndSize($1.data(), $1.size());
+}
+%typemap(in) const std::string binary (char *buffer, Py_ssize_t length) {
+	if (PyBytes_AsStringAndSize($input, &buffer, &length) == -1)
+		SWIG_exception_fail(SWIG_TypeError, "expected a bytes object");
+	$1 = std::string(buffer, length);
+}
+
 /* Instantiate the required template specializations */
 %template() std::map<std::string, int>;
 
@@ -189,6 +242,7 @@
 %include "EffectInfo.h"
 %include "Enums.h"
 %include "Exceptions.h"
+%include "Executor.h"
 %include "FFmpegReader.h"
 %include "FFmpegWriter.h"
 %include "Fraction.h"
@@ -201,9 +255,12 @@
 %include "QtImageReader.h"
 %include "QtPlayer.h"
 %include "QtTextReader.h"
+%include "QtTitleReader.h"
 %include "KeyFrame.h"
+%include "RenderCache.h"
 %include "RendererBase.h"
 %include "Settings.h"
+%include "ThumbnailExtractor.h"
 %include "TimelineBase.h"
 %include "Timeline.h"
 %include "ZmqLogger.h"
@@ -233,6 +290,179 @@
 %include "effects/Wave.h"
 
 
+/* Zero-copy access to Frame pixels and audio (Python buffer protocol / NumPy) */
+%{
+	#include <stdexcept>
+
+	/* A minimal Python object, which exports a block of Frame memory through the buffer protocol.
+	 * It holds a shared reference to the C++ owner of that memory, so the memory remains valid for
+	 * as long as any memoryview (or NumPy array) is still using it. */
+	typedef struct {
+		PyObject_HEAD
+		std::shared_ptr<void> *owner;
+		void *data;
+		int ndim;
+		int readonly;
+		Py_ssize_t itemsize;
+		Py_ssize_t len;
+		Py_ssize_t shape[3];
+		Py_ssize_t strides[3];
+		const char *format;
+	} OpenShotBufferObject;
+
+	static PyTypeObject OpenShotBufferType = {
+		PyVarObject_HEAD_INIT(NULL, 0)
+		"openshot.FrameBuffer",
+		sizeof(OpenShotBufferObject)
+	};
+	static PyBufferProcs OpenShotBufferProcs;
+
+	static void OpenShotBuffer_dealloc(OpenShotBufferObject *self) {
+		delete self->owner;
+		PyObject_Del(self);
+	}
+
+	static int OpenShotBuffer_getbuffer(OpenShotBufferObject *self, Py_buffer *view, int flags) {
+		if ((flags & PyBUF_WRITABLE) && self->readonly) {
+			PyErr_SetString(PyExc_BufferError, "Frame buffer is read-only");
+			view->obj = NULL;
+			return -1;
+		}
+		view->obj = (PyObject *) self;
+		Py_INCREF(self);
+		view->buf = self->data;
+		view->len = self->len;
+		view->readonly = self->readonly;
+		view->itemsize = self->itemsize;
+		view->format = (flags & PyBUF_FORMAT) ? (char *) self->format : NULL;
+		view->ndim = self->ndim;
+		view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+		view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? self->strides : NULL;
+		view->suboffsets = NULL;
+		view->internal = NULL;
+		return 0;
+	}
+
+	/* Wrap a block of memory (owned by 'owner') in a memoryview, without copying it */
+	static PyObject *OpenShotBuffer_New(std::shared_ptr<void> owner, void *data, int ndim,
+			const Py_ssize_t *shape, const Py_ssize_t *strides, Py_ssize_t itemsize, const char *format, bool readonly) {
+		static bool type_ready = false;
+		if (!type_ready) {
+			OpenShotBufferProcs.bf_getbuffer = (getbufferproc) OpenShotBuffer_getbuffer;
+			OpenShotBufferProcs.bf_releasebuffer = NULL;
+			OpenShotBufferType.tp_dealloc = (destructor) OpenShotBuffer_dealloc;
+			OpenShotBufferType.tp_as_buffer = &OpenShotBufferProcs;
+			OpenShotBufferType.tp_flags = Py_TPFLAGS_DEFAULT;
+			OpenShotBufferType.tp_doc = "Zero-copy buffer of openshot.Frame image or audio data";
+			if (PyType_Ready(&OpenShotBufferType) < 0)
+				return NULL;
+			type_ready = true;
+		}
+
+		OpenShotBufferObject *buffer = PyObject_New(OpenShotBufferObject, &OpenShotBufferType);
+		if (!buffer)
+			return NULL;
+		buffer->owner = new std::shared_ptr<void>(owner);
+		buffer->data = data;
+		buffer->ndim = ndim;
+		buffer->readonly = readonly ? 1 : 0;
+		buffer->itemsize = itemsize;
+		buffer->format = format;
+		buffer->len = itemsize;
+		for (int d = 0; d < ndim; d++) {
+			buffer->shape[d] = shape[d];
+			buffer->strides[d] = strides[d];
+			buffer->len *= shape[d];
+		}
+
+		PyObject *view = PyMemoryView_FromObject((PyObject *) buffer);
+		Py_DECREF(buffer);
+		return view;
+	}
+
+	/* QImage cleanup function, which releases a Python buffer (once Frame is done with the pixels) */
+	static void OpenShotBuffer_release(void *info) {
+		Py_buffer *view = (Py_buffer *) info;
+		if (Py_IsInitialized()) {
+			PyGILState_STATE state = PyGILState_Ensure();
+			PyBuffer_Release(view);
+			PyGILState_Release(state);
+		}
+		delete view;
+	}
+%}
+
+%inline %{
+	/* Get a zero-copy memoryview of a frame's image, with shape (height, width, 4) and RGBA (premultiplied) bytes */
+	PyObject *FrameImageBuffer(std::shared_ptr<openshot::Frame> frame, bool writable = false) {
+		std::shared_ptr<QImage> image = frame->GetImage();
+		void *data = writable ? (void *) image->bits() : (void *) image->constBits();
+		Py_ssize_t shape[3] = {image->height(), image->width(), 4};
+		Py_ssize_t strides[3] = {image->bytesPerLine(), 4, 1};
+		return OpenShotBuffer_New(image, data, 3, shape, strides, 1, "B", !writable);
+	}
+
+	/* Get a zero-copy memoryview of a single channel of a frame's audio samples (float32).
+	 * The view is invalidated if the frame's audio buffer is later resized. */
+	PyObject *FrameAudioBuffer(std::shared_ptr<openshot::Frame> frame, int channel, bool writable = false) {
+		if (channel < 0 || channel >= frame->GetAudioChannelsCount())
+			throw std::out_of_range("Audio channel is out of range");
+		Py_ssize_t shape[1] = {frame->GetAudioSamplesCount()};
+		Py_ssize_t strides[1] = {sizeof(float)};
+		return OpenShotBuffer_New(frame, frame->GetAudioSamples(channel), 1, shape, strides, sizeof(float), "f", !writable);
+	}
+
+	/* Add (or replace) a frame's image with the contents of a (height, width, 4) uint8 buffer (such as a NumPy array)
+	 * of RGBA premultiplied pixels. The buffer is shared (not copied), and released when the frame's image is destroyed. */
+	void FrameAddImageBuffer(std::shared_ptr<openshot::Frame> frame, PyObject *buffer) {
+		Py_buffer *view = new Py_buffer;
+		bool writable = true;
+		if (PyObject_GetBuffer(buffer, view, PyBUF_STRIDES | PyBUF_FORMAT | PyBUF_WRITABLE) != 0) {
+			// Fall back to a read-only buffer (Qt will copy the pixels if the frame modifies them)
+			PyErr_Clear();
+			writable = false;
+			if (PyObject_GetBuffer(buffer, view, PyBUF_STRIDES | PyBUF_FORMAT) != 0) {
+				PyErr_Clear();
+				delete view;
+				throw std::invalid_argument("Object does not support the buffer protocol");
+			}
+		}
+
+		if (view->ndim != 3 || view->shape[2] != 4 || view->itemsize != 1 ||
+			(view->format && std::string(view->format) != "B") ||
+			view->strides[2] != 1 || view->strides[1] != 4 || view->strides[0] < view->shape[1] * 4) {
+			PyBuffer_Release(view);
+			delete view;
+			throw std::invalid_argument("Expected a (height, width, 4) uint8 buffer with contiguous RGBA pixels");
+		}
+
+		std::shared_ptr<QImage> image;
+		if (writable)
+			image = std::make_shared<QImage>((uchar *) view->buf, (int) view->shape[1], (int) view->shape[0],
+				(int) view->strides[0], QImage::Format_RGBA8888_Premultiplied, &OpenShotBuffer_release, view);
+		else
+			image = std::make_shared<QImage>((const uchar *) view->buf, (int) view->shape[1], (int) view->shape[0],
+				(int) view->strides[0], QImage::Format_RGBA8888_Premultiplied, &OpenShotBuffer_release, view);
+		frame->AddImage(image);
+	}
+%}
+
+%extend openshot::Frame {
+	%pythoncode %{
+		def ImageBuffer(self, writable=False):
+			"""Zero-copy memoryview of the image, shape (height, width, 4), RGBA premultiplied uint8 (i.e. numpy.asarray(f.ImageBuffer()))"""
+			return FrameImageBuffer(self, writable)
+
+		def AudioBuffer(self, channel, writable=False):
+			"""Zero-copy memoryview of one channel of audio samples (float32)"""
+			return FrameAudioBuffer(self, channel, writable)
+
+		def AddImageBuffer(self, buffer):
+			"""Add (or replace) the image from a (height, width, 4) RGBA premultiplied uint8 buffer, sharing its memory"""
+			FrameAddImageBuffer(self, buffer)
+	%}
+}
+
 /* Wrap std templates (list, vector, etc...) */
 %template(ClipList) std::list<openshot::Clip *>;
 %template(EffectBaseList) std::list<openshot::EffectBase *>;
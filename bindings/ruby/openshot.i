@@ -85,6 +85,7 @@
 #include "EffectInfo.h"
 #include "Enums.h"
 #include "Exceptions.h"
+#include "Executor.h"
 #include "FFmpegReader.h"
 #include "FFmpegWriter.h"
 #include "Fraction.h"
@@ -97,9 +98,12 @@
 #include "QtImageReader.h"
 #include "QtPlayer.h"
 #include "QtTextReader.h"
+#include "QtTitleReader.h"
 #include "KeyFrame.h"
+#include "RenderCache.h"
 #include "RendererBase.h"
 #include "Settings.h"
+#include "ThumbnailExtractor.h"
 #include "TimelineBase.h"
 #include "Timeline.h"
 #include "ZmqLogger.h"
@@ -154,6 +158,7 @@
 %include "EffectInfo.h"
 %include "Enums.h"
 %include "Exceptions.h"
+%include "Executor.h"
 
 /* Ruby and FFmpeg define competing RSHIFT macros,
  * so we move Ruby's out of the way for now. We'll
@@ -187,9 +192,12 @@
 %include "QtImageReader.h"
 %include "QtPlayer.h"
 %include "QtTextReader.h"
+%include "QtTitleReader.h"
 %include "KeyFrame.h"
+%include "RenderCache.h"
 %include "RendererBase.h"
 %include "Settings.h"
+%include "ThumbnailExtractor.h"
 %include "TimelineBase.h"
 %include "Timeline.h"
 %include "ZmqLogger.h"
@@ -234,13 +234,11 @@ std::shared_ptr<Frame> CacheDisk::GetFrame(int64_t frame_number)
 			auto image = std::make_shared<QImage>();
 			image->load(frame_path);
 
-			// Set pixel formatimage->
-			image = std::make_shared<QImage>(image->convertToFormat(QImage::Format_RGBA8888_Premultiplied));
-
-			// Create frame object
+			// Create frame object (which converts the loaded image to
+			// Format_RGBA8888_Premultiplied in place)
 			auto frame = std::make_shared<Frame>();
 			frame->number = frame_number;
-			frame->AddImage(image);
+			frame->AddImage(std::move(image));
 
 			// Get audio data (if found)
 			QString audio_path(path.path() + "/" + QString("%1").arg(frame_number) + ".audio");
@@ -310,6 +308,32 @@ std::shared_ptr<Frame> CacheDisk::GetSmallestFrame()
 	return f;
 }
 
+// Add the frames already saved in the cache directory to the cache
+void CacheDisk::Scan()
+{
+	// Create a scoped lock, to protect the cache from multiple threads
+	const GenericScopedLock<CriticalSection> lock(*cacheCriticalSection);
+
+	// Find all image files (named by frame number)
+	QStringList filters(QString("*.") + QString(image_format.c_str()).toLower());
+	for (const QFileInfo& image_file : path.entryInfoList(filters, QDir::Files)) {
+		bool is_number = false;
+		int64_t frame_number = image_file.baseName().toLongLong(&is_number);
+		if (!is_number || frames.count(frame_number))
+			continue;
+
+		// Add frame to queue and map
+		frames[frame_number] = frame_number;
+		frame_numbers.push_front(frame_number);
+		ordered_frame_numbers.push_back(frame_number);
+		needs_range_processing = true;
+
+		if (frame_size_bytes == 0)
+			// Get compressed size of frame image (to correctly apply max size against)
+			frame_size_bytes = image_file.size();
+	}
+}
+
 // Gets the maximum bytes value
 int64_t CacheDisk::GetBytes()
 {
@@ -112,6 +112,9 @@ namespace openshot {
 		/// Get the smallest frame number
 		std::shared_ptr<openshot::Frame> GetSmallestFrame();
 
+		/// Add the frames already saved in the cache directory (i.e. by a previous session) to the cache
+		void Scan();
+
 		/// @brief Move frame to front of queue (so it lasts longer)
 		/// @param frame_number The frame number of the cached frame
 		void MoveToFront(int64_t frame_number);
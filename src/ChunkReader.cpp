@@ -32,11 +32,14 @@
 #include "FFmpegReader.h"
 
 #include <QDir>
+#include <QDataStream>
+#include <cstring>
 
 using namespace openshot;
 
 ChunkReader::ChunkReader(std::string path, ChunkVersion chunk_version)
-		: path(path), chunk_size(24 * 3), is_open(false), version(chunk_version), local_reader(NULL)
+		: path(path), chunk_size(24 * 3), is_open(false), version(chunk_version), local_reader(NULL),
+		  mezzanine_file(NULL)
 {
 	// Check if folder exists?
 	if (!does_folder_exist(path))
@@ -52,6 +55,24 @@ ChunkReader::ChunkReader(std::string path, ChunkVersion chunk_version)
 	Close();
 }
 
+// Destructor
+ChunkReader::~ChunkReader()
+{
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+
+	// Close the MEZZANINE chunk file (if any)
+	close_mezzanine_chunk();
+
+	// Close and delete the reader of the current chunk (if any)
+	if (local_reader)
+	{
+		local_reader->Close();
+		delete local_reader;
+		local_reader = NULL;
+	}
+}
+
 // Check if folder path existing
 bool ChunkReader::does_folder_exist(std::string path)
 {
@@ -163,9 +184,21 @@ void ChunkReader::Open()
 // Close image file
 void ChunkReader::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open)
 	{
+		// Close MEZZANINE chunk file (if any), so the next GetFrame re-opens it
+		if (mezzanine_file)
+		{
+			close_mezzanine_chunk();
+			previous_location.number = 0;
+			previous_location.frame = 0;
+		}
+
 		// Mark as "closed"
 		is_open = false;
 	}
@@ -216,37 +249,51 @@ std::shared_ptr<Frame> ChunkReader::GetFrame(int64_t requested_frame)
 		case FINAL:
 			folder_name = "final";
 			break;
+		case MEZZANINE:
+			folder_name = "mezzanine";
+			break;
 		}
 
-		// Load path of chunk video
-		std::string chunk_video_path = get_chunk_path(location.number, folder_name, ".webm");
-
-		// Close existing reader (if needed)
-		if (local_reader)
+		if (version == MEZZANINE)
 		{
-			// Close and delete old reader
-			local_reader->Close();
-			delete local_reader;
+			// Load the frame offset table of the new chunk (no decoder is needed)
+			open_mezzanine_chunk(get_chunk_path(location.number, folder_name, ".osmz"), requested_frame, location);
 		}
-
-		try
-		{
-			// Load new FFmpegReader
-			local_reader = new FFmpegReader(chunk_video_path);
-			local_reader->Open(); // open reader
-
-		} catch (const InvalidFile& e)
+		else
 		{
-			// Invalid Chunk (possibly it is not found)
-			throw ChunkNotFound(path, requested_frame, location.number, location.frame);
+			// Load path of chunk video
+			std::string chunk_video_path = get_chunk_path(location.number, folder_name, ".webm");
+
+			// Close existing reader (if needed)
+			if (local_reader)
+			{
+				// Close and delete old reader
+				local_reader->Close();
+				delete local_reader;
+			}
+
+			try
+			{
+				// Load new FFmpegReader
+				local_reader = new FFmpegReader(chunk_video_path);
+				local_reader->Open(); // open reader
+
+			} catch (const InvalidFile& e)
+			{
+				// Invalid Chunk (possibly it is not found)
+				throw ChunkNotFound(path, requested_frame, location.number, location.frame);
+			}
 		}
 
 		// Set the new location
 		previous_location = location;
 	}
 
-	// Get the frame (from the current reader)
-	last_frame = local_reader->GetFrame(location.frame);
+	// Get the frame (from the current reader or MEZZANINE chunk)
+	if (version == MEZZANINE)
+		last_frame = read_mezzanine_frame(requested_frame, location);
+	else
+		last_frame = local_reader->GetFrame(location.frame);
 
 	// Update the frame number property
 	last_frame->number = requested_frame;
@@ -255,6 +302,113 @@ std::shared_ptr<Frame> ChunkReader::GetFrame(int64_t requested_frame)
 	return last_frame;
 }
 
+// Open a MEZZANINE chunk file, and load its frame offset table
+void ChunkReader::open_mezzanine_chunk(std::string chunk_path, int64_t requested_frame, ChunkLocation location)
+{
+	// Close previous chunk file (if any)
+	close_mezzanine_chunk();
+
+	mezzanine_file = new QFile(QString::fromStdString(chunk_path));
+	if (!mezzanine_file->open(QIODevice::ReadOnly))
+	{
+		// Invalid Chunk (possibly it is not found)
+		close_mezzanine_chunk();
+		throw ChunkNotFound(path, requested_frame, location.number, location.frame);
+	}
+
+	// Read and validate the header
+	QByteArray header = mezzanine_file->read(MEZZANINE_HEADER_SIZE);
+	QDataStream header_stream(header);
+	header_stream.setByteOrder(QDataStream::LittleEndian);
+	char magic[4] = {0, 0, 0, 0};
+	quint32 format_version = 0;
+	quint32 frame_count = 0;
+	quint32 reserved = 0;
+	quint64 index_offset = 0;
+	header_stream.readRawData(magic, 4);
+	header_stream >> format_version >> frame_count >> reserved >> index_offset;
+
+	if (header.size() != MEZZANINE_HEADER_SIZE || memcmp(magic, MEZZANINE_MAGIC, 4) != 0 ||
+		format_version != MEZZANINE_FORMAT_VERSION || index_offset == 0)
+	{
+		// Invalid (or unfinished) chunk file
+		close_mezzanine_chunk();
+		throw ChunkNotFound(path, requested_frame, location.number, location.frame);
+	}
+
+	// Read the frame offset table (at the end of the file)
+	mezzanine_file->seek(index_offset);
+	QByteArray index = mezzanine_file->read(frame_count * 2 * sizeof(quint64));
+	QDataStream index_stream(index);
+	index_stream.setByteOrder(QDataStream::LittleEndian);
+	for (quint32 i = 0; i < frame_count && !index_stream.atEnd(); i++)
+	{
+		quint64 offset = 0;
+		quint64 size = 0;
+		index_stream >> offset >> size;
+		ChunkFrameIndex entry = {(int64_t) offset, (int64_t) size};
+		mezzanine_index.push_back(entry);
+	}
+
+	ZmqLogger::Instance()->AppendDebugMethod("ChunkReader::open_mezzanine_chunk", "location.number", location.number, "frame_count", frame_count, "mezzanine_index.size()", mezzanine_index.size());
+}
+
+// Close the current MEZZANINE chunk file (if any)
+void ChunkReader::close_mezzanine_chunk()
+{
+	if (mezzanine_file)
+	{
+		mezzanine_file->close();
+		delete mezzanine_file;
+		mezzanine_file = NULL;
+	}
+	mezzanine_index.clear();
+}
+
+// Read a single frame record from the current MEZZANINE chunk file
+std::shared_ptr<Frame> ChunkReader::read_mezzanine_frame(int64_t requested_frame, ChunkLocation location)
+{
+	// Check that the frame is in the offset table
+	if (!mezzanine_file || location.frame < 1 || location.frame > (int64_t) mezzanine_index.size())
+		throw OutOfBoundsFrame("Frame is not contained in this MEZZANINE chunk.", requested_frame, info.video_length);
+
+	// Read the entire frame record (a single read)
+	const ChunkFrameIndex& entry = mezzanine_index[location.frame - 1];
+	mezzanine_file->seek(entry.offset);
+	QByteArray record = mezzanine_file->read(entry.size);
+	if (record.size() != entry.size)
+		throw ChunkNotFound(path, requested_frame, location.number, location.frame);
+
+	// Parse the record header
+	QDataStream stream(record);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	qint32 width = 0, height = 0, sample_rate = 0, channel_layout = 0;
+	qint32 channels = 0, samples = 0, image_size = 0;
+	stream >> width >> height >> sample_rate >> channel_layout >> channels >> samples >> image_size;
+
+	// Create the frame
+	auto frame = std::make_shared<Frame>(requested_frame, width, height, "#000000", samples, channels);
+	frame->SampleRate(sample_rate);
+	frame->ChannelsLayout((ChannelLayout) channel_layout);
+
+	// Decompress the image (a single decompress)
+	const int64_t header_size = 7 * sizeof(qint32);
+	if (image_size > 0 && width > 0 && height > 0)
+	{
+		QByteArray pixels = qUncompress((const uchar*) record.constData() + header_size, image_size);
+		if (pixels.size() == width * height * 4)
+			frame->AddImage(width, height, 4, QImage::Format_RGBA8888_Premultiplied, (const unsigned char*) pixels.constData());
+	}
+
+	// Add raw PCM audio samples (planar, one channel after another)
+	const float* audio = (const float*) (record.constData() + header_size + image_size);
+	if (record.size() >= header_size + image_size + (int64_t) channels * samples * (int64_t) sizeof(float))
+		for (int channel = 0; channel < channels; channel++)
+			frame->AddAudio(true, channel, 0, audio + (channel * samples), samples, 1.0f);
+
+	return frame;
+}
+
 // Generate JSON string of this object
 std::string ChunkReader::Json() const {
 
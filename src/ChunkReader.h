@@ -34,6 +34,8 @@
 #include "ReaderBase.h"
 #include <string>
 #include <memory>
+#include <vector>
+#include <QFile>
 
 #include "Frame.h"
 #include "Json.h"
@@ -55,6 +57,28 @@ namespace openshot
 		int64_t frame; ///< The frame number
 	};
 
+	/**
+	 * @brief This struct holds the location of a single frame record inside a
+	 * MEZZANINE chunk file.
+	 *
+	 * Each MEZZANINE chunk ends with a table of these entries (one per frame), which
+	 * allows any frame to be read with a single read and a single decompress.
+	 */
+	struct ChunkFrameIndex
+	{
+		int64_t offset; ///< The byte offset of the frame record (from the start of the file)
+		int64_t size; ///< The size of the frame record (in bytes)
+	};
+
+	/// Magic bytes at the start of every MEZZANINE chunk file
+	const char MEZZANINE_MAGIC[4] = {'O', 'S', 'M', 'Z'};
+
+	/// Current version of the MEZZANINE chunk file layout
+	const uint32_t MEZZANINE_FORMAT_VERSION = 1;
+
+	/// Size (in bytes) of the MEZZANINE chunk file header (magic, version, frame count, reserved, index offset)
+	const int64_t MEZZANINE_HEADER_SIZE = 24;
+
 	/**
 	 * @brief This enumeration allows the user to choose which version
 	 * of the chunk they would like (low, medium, or high quality).
@@ -69,7 +93,8 @@ namespace openshot
 	{
 		THUMBNAIL,	///< The lowest quality stream contained in this chunk file
 		PREVIEW,	///< The medium quality stream contained in this chunk file
-		FINAL		///< The highest quality stream contained in this chunk file
+		FINAL,		///< The highest quality stream contained in this chunk file
+		MEZZANINE	///< An indexed, intra-only version of each chunk (compressed RGBA + raw PCM), for fast random access
 	};
 
 	/**
@@ -93,6 +118,11 @@ namespace openshot
 	 * // Close the reader
 	 * r.Close();
 	 * \endcode
+	 *
+	 * The MEZZANINE version does not use FFmpeg at all. Each chunk is a single file, containing
+	 * zlib-compressed RGBA images, raw PCM audio, and a frame offset table. Seeking inside
+	 * a chunk (or across chunks) never requires decoding neighboring frames. This version is only
+	 * available if the ChunkWriter was asked to generate it (see ChunkWriter::SetMezzanine).
 	 */
 	class ChunkReader : public ReaderBase
 	{
@@ -104,6 +134,8 @@ namespace openshot
 		ChunkLocation previous_location;
 		ChunkVersion version;
 		std::shared_ptr<openshot::Frame> last_frame;
+		QFile *mezzanine_file;
+		std::vector<openshot::ChunkFrameIndex> mezzanine_index;
 
 		/// Check if folder path existing
 		bool does_folder_exist(std::string path);
@@ -117,14 +149,26 @@ namespace openshot
 		/// Load JSON meta data about this chunk folder
 		void load_json();
 
+		/// Open a MEZZANINE chunk file, and load its frame offset table
+		void open_mezzanine_chunk(std::string chunk_path, int64_t requested_frame, ChunkLocation location);
+
+		/// Close the current MEZZANINE chunk file (if any)
+		void close_mezzanine_chunk();
+
+		/// Read a single frame record from the current MEZZANINE chunk file
+		std::shared_ptr<openshot::Frame> read_mezzanine_frame(int64_t requested_frame, ChunkLocation location);
+
 	public:
 
 		/// @brief Constructor for ChunkReader.  This automatically opens the chunk file or folder and loads
 		/// frame 1, or it throws one of the following exceptions.
 		/// @param path				The folder path / location of a chunk (chunks are stored as folders)
-		/// @param chunk_version	Choose the video version / quality (THUMBNAIL, PREVIEW, or FINAL)
+		/// @param chunk_version	Choose the video version / quality (THUMBNAIL, PREVIEW, FINAL, or MEZZANINE)
 		ChunkReader(std::string path, ChunkVersion chunk_version);
 
+		/// Destructor
+		virtual ~ChunkReader();
+
 		/// Close the reader
 		void Close() override;
 
@@ -30,11 +30,14 @@
 
 #include "ChunkWriter.h"
 
+#include <QtCore/QDataStream>
+
 using namespace openshot;
 
 ChunkWriter::ChunkWriter(std::string path, ReaderBase *reader) :
 		local_reader(reader), path(path), chunk_size(24*3), chunk_count(1), frame_count(1), is_writing(false),
-		default_extension(".webm"), default_vcodec("libvpx"), default_acodec("libvorbis"), last_frame_needed(false), is_open(false)
+		default_extension(".webm"), default_vcodec("libvpx"), default_acodec("libvorbis"), last_frame_needed(false), is_open(false),
+		mezzanine(false), writer_mezzanine(NULL)
 {
 	// Change codecs to default
 	info.vcodec = default_vcodec;
@@ -107,6 +110,13 @@ void ChunkWriter::WriteFrame(std::shared_ptr<Frame> frame)
 		writer_thumb->SetAudioOptions(true, default_acodec, info.sample_rate, info.channels, info.channel_layout, 128000);
 		writer_thumb->SetVideoOptions(true, default_vcodec, info.fps, info.width * 0.25, info.height * 0.25, info.pixel_ratio, false, false, info.video_bit_rate * 0.25);
 
+		// Create MEZZANINE chunk file (if requested)
+		if (mezzanine)
+		{
+			create_folder(get_chunk_path(chunk_count, "mezzanine", ""));
+			open_mezzanine_chunk(get_chunk_path(chunk_count, "mezzanine", ".osmz"));
+		}
+
 		// Prepare Streams
 		writer_final->PrepareStreams();
 		writer_preview->PrepareStreams();
@@ -132,6 +142,8 @@ void ChunkWriter::WriteFrame(std::shared_ptr<Frame> frame)
 			writer_final->WriteFrame(last_frame);
 			writer_preview->WriteFrame(last_frame);
 			writer_thumb->WriteFrame(last_frame);
+			if (writer_mezzanine)
+				write_mezzanine_frame(last_frame);
 		} else {
 			// Write the 1st frame (of the 1st chunk)... since no previous chunk is available
 			auto blank_frame = std::make_shared<Frame>(
@@ -141,6 +153,8 @@ void ChunkWriter::WriteFrame(std::shared_ptr<Frame> frame)
 			writer_final->WriteFrame(blank_frame);
 			writer_preview->WriteFrame(blank_frame);
 			writer_thumb->WriteFrame(blank_frame);
+			if (writer_mezzanine)
+				write_mezzanine_frame(blank_frame);
 		}
 
 		// disable last frame
@@ -153,6 +167,8 @@ void ChunkWriter::WriteFrame(std::shared_ptr<Frame> frame)
 	writer_final->WriteFrame(frame);
 	writer_preview->WriteFrame(frame);
 	writer_thumb->WriteFrame(frame);
+	if (writer_mezzanine)
+		write_mezzanine_frame(frame);
 	//////////////////////////////////////////////////
 
 
@@ -178,6 +194,10 @@ void ChunkWriter::WriteFrame(std::shared_ptr<Frame> frame)
 		writer_preview->Close();
 		writer_thumb->Close();
 
+		// Finish MEZZANINE chunk (no padding frames are needed, since every frame is intra-only)
+		if (writer_mezzanine)
+			close_mezzanine_chunk();
+
 		// Increment chunk count
 		chunk_count++;
 
@@ -246,6 +266,10 @@ void ChunkWriter::Close()
 		writer_preview->Close();
 		writer_thumb->Close();
 
+		// Finish MEZZANINE chunk (no padding frames are needed, since every frame is intra-only)
+		if (writer_mezzanine)
+			close_mezzanine_chunk();
+
 		// Increment chunk count
 		chunk_count++;
 
@@ -277,6 +301,88 @@ void ChunkWriter::write_json_meta_data()
 	myfile.close();
 }
 
+// create a new MEZZANINE chunk file (and write a placeholder header)
+void ChunkWriter::open_mezzanine_chunk(std::string chunk_path)
+{
+	writer_mezzanine = new QFile(QString::fromStdString(chunk_path));
+	if (!writer_mezzanine->open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		delete writer_mezzanine;
+		writer_mezzanine = NULL;
+		throw InvalidFile("MEZZANINE chunk could not be created.", chunk_path);
+	}
+	mezzanine_index.clear();
+
+	// Write placeholder header (the frame count and index offset are updated when the chunk is closed)
+	QByteArray header;
+	QDataStream stream(&header, QIODevice::WriteOnly);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData(MEZZANINE_MAGIC, 4);
+	stream << (quint32) MEZZANINE_FORMAT_VERSION << (quint32) 0 << (quint32) 0 << (quint64) 0;
+	writer_mezzanine->write(header);
+}
+
+// append a single frame record to the current MEZZANINE chunk file
+void ChunkWriter::write_mezzanine_frame(std::shared_ptr<Frame> frame)
+{
+	// Get tightly packed RGBA pixels (premultiplied, the native format of openshot::Frame)
+	std::shared_ptr<QImage> image = frame->GetImage();
+	int width = image->width();
+	int height = image->height();
+	QByteArray pixels;
+	pixels.reserve(width * height * 4);
+	for (int row = 0; row < height; row++)
+		pixels.append((const char*) image->constScanLine(row), width * 4);
+
+	// Favor speed over size (this is an intermediate format)
+	QByteArray compressed_pixels = qCompress(pixels, 1);
+
+	// Build the frame record: header, compressed image, then planar float PCM
+	int channels = frame->GetAudioChannelsCount();
+	int samples = frame->GetAudioSamplesCount();
+	QByteArray record;
+	QDataStream stream(&record, QIODevice::WriteOnly);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream << (qint32) width << (qint32) height << (qint32) frame->SampleRate() << (qint32) frame->ChannelsLayout()
+		   << (qint32) channels << (qint32) samples << (qint32) compressed_pixels.size();
+	stream.writeRawData(compressed_pixels.constData(), compressed_pixels.size());
+	for (int channel = 0; channel < channels; channel++)
+		stream.writeRawData((const char*) frame->GetAudioSamples(channel), samples * sizeof(float));
+
+	// Append record, and remember its location
+	ChunkFrameIndex entry = {writer_mezzanine->pos(), record.size()};
+	mezzanine_index.push_back(entry);
+	writer_mezzanine->write(record);
+}
+
+// write the frame offset table and final header, and close the current MEZZANINE chunk file
+void ChunkWriter::close_mezzanine_chunk()
+{
+	// Append frame offset table
+	quint64 index_offset = writer_mezzanine->pos();
+	QByteArray index;
+	QDataStream index_stream(&index, QIODevice::WriteOnly);
+	index_stream.setByteOrder(QDataStream::LittleEndian);
+	for (const auto& entry : mezzanine_index)
+		index_stream << (quint64) entry.offset << (quint64) entry.size;
+	writer_mezzanine->write(index);
+
+	// Update header (now that the frame count and index offset are known)
+	QByteArray header;
+	QDataStream header_stream(&header, QIODevice::WriteOnly);
+	header_stream.setByteOrder(QDataStream::LittleEndian);
+	header_stream.writeRawData(MEZZANINE_MAGIC, 4);
+	header_stream << (quint32) MEZZANINE_FORMAT_VERSION << (quint32) mezzanine_index.size() << (quint32) 0 << index_offset;
+	writer_mezzanine->seek(0);
+	writer_mezzanine->write(header);
+
+	// Close file
+	writer_mezzanine->close();
+	delete writer_mezzanine;
+	writer_mezzanine = NULL;
+	mezzanine_index.clear();
+}
+
 // check for chunk folder
 void ChunkWriter::create_folder(std::string path)
 {
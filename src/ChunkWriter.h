@@ -31,6 +31,7 @@
 #ifndef OPENSHOT_CHUNK_WRITER_H
 #define OPENSHOT_CHUNK_WRITER_H
 
+#include "ChunkReader.h"
 #include "ReaderBase.h"
 #include "WriterBase.h"
 #include "FFmpegWriter.h"
@@ -46,7 +47,9 @@
 #include <sstream>
 #include <unistd.h>
 #include <omp.h>
+#include <vector>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
 
 
 namespace openshot
@@ -77,6 +80,10 @@ namespace openshot
 	 * w.Close();
 	 * r.Close();
 	 * @endcode
+	 *
+	 * Optionally, an additional MEZZANINE version of each chunk can be written (see SetMezzanine). It stores
+	 * intra-only frames (zlib-compressed RGBA and raw PCM) with a frame offset table, so a ChunkReader can
+	 * read any frame with a single read and a single decompress (no codec seeking).
 	 */
 	class ChunkWriter : public WriterBase
 	{
@@ -96,6 +103,9 @@ namespace openshot
 	    std::string default_extension;
 	    std::string default_vcodec;
 	    std::string default_acodec;
+		bool mezzanine;
+		QFile *writer_mezzanine;
+		std::vector<openshot::ChunkFrameIndex> mezzanine_index;
 
 		/// check for chunk folder
 		void create_folder(std::string path);
@@ -109,6 +119,15 @@ namespace openshot
 		/// write json meta data
 		void write_json_meta_data();
 
+		/// create a new MEZZANINE chunk file (and write a placeholder header)
+		void open_mezzanine_chunk(std::string chunk_path);
+
+		/// append a single frame record to the current MEZZANINE chunk file
+		void write_mezzanine_frame(std::shared_ptr<openshot::Frame> frame);
+
+		/// write the frame offset table and final header, and close the current MEZZANINE chunk file
+		void close_mezzanine_chunk();
+
 	public:
 
 		/// @brief Constructor for ChunkWriter. Throws one of the following exceptions.
@@ -122,6 +141,9 @@ namespace openshot
 		/// Get the chunk size (number of frames to write in each chunk)
 		int64_t GetChunkSize() { return chunk_size; };
 
+		/// Determine if a MEZZANINE version of each chunk is also written
+		bool GetMezzanine() { return mezzanine; };
+
 		/// Determine if writer is open or closed
 		bool IsOpen() { return is_open; };
 
@@ -132,6 +154,11 @@ namespace openshot
 		/// @param new_size The number of frames to write in this chunk file
 		void SetChunkSize(int64_t new_size) { chunk_size = new_size; };
 
+		/// @brief Enable or disable the MEZZANINE version of each chunk (indexed, intra-only, fast seeking).
+		/// This must be set before the first frame is written.
+		/// @param enabled Write an additional MEZZANINE version of each chunk
+		void SetMezzanine(bool enabled) { mezzanine = enabled; };
+
 		/// @brief Add a frame to the stack waiting to be encoded.
 		/// @param frame The openshot::Frame object that needs to be written to this chunk file.
 		void WriteFrame(std::shared_ptr<openshot::Frame> frame);
@@ -29,6 +29,8 @@
  */
 
 #include "Clip.h"
+
+#include <algorithm> // for std::min
 #include "FFmpegReader.h"
 #include "FrameMapper.h"
 #ifdef USE_IMAGEMAGICK
@@ -56,6 +58,8 @@ void Clip::init_settings()
 	display = FRAME_DISPLAY_NONE;
 	mixing = VOLUME_MIX_NONE;
 	waveform = false;
+	has_deferred_json = false;
+	resampler_next_frame = 0;
 	previous_properties = "";
 
 	// Init scale curves
@@ -112,7 +116,7 @@ void Clip::init_reader_settings() {
 		info = reader->info;
 
 		// Initialize Clip cache
-		cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
+		cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(reader->GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
 	}
 }
 
@@ -229,6 +233,9 @@ Clip::Clip(std::string path) : resampler(NULL), reader(NULL), allocated_reader(N
 // Destructor
 Clip::~Clip()
 {
+	// Wait for any running frame requests of this clip
+	wait_for_requests();
+
 	// Delete the reader if clip created it
 	if (allocated_reader) {
 		delete allocated_reader;
@@ -270,6 +277,9 @@ void Clip::Open()
 {
 	if (reader)
 	{
+		// Load keyframes and effects (if deferred)
+		LoadDeferredJson();
+
 		// Open the reader
 		reader->Open();
 		is_open = true;
@@ -289,6 +299,9 @@ void Clip::Open()
 // Close the internal reader
 void Clip::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	wait_for_requests();
+
 	is_open = false;
 	if (reader) {
 		ZmqLogger::Instance()->AppendDebugMethod("Clip::Close");
@@ -344,6 +357,54 @@ std::shared_ptr<Frame> Clip::GetFrame(int64_t frame_number)
 		throw ReaderClosed("No Reader has been initialized for this Clip.  Call Reader(*reader) before calling this method.");
 }
 
+// Get a range of sequential frames of this clip
+std::vector<std::shared_ptr<Frame>> Clip::GetFrames(int64_t start, int64_t count)
+{
+	// Check for open reader (or throw exception)
+	if (!is_open)
+		throw ReaderClosed("The Clip is closed.  Call Open() before calling this method.");
+	if (!reader)
+		throw ReaderClosed("No Reader has been initialized for this Clip.  Call Reader(*reader) before calling this method.");
+
+	std::vector<std::shared_ptr<Frame>> frames;
+	if (count <= 0)
+		return frames;
+	start = adjust_frame_number_minimum(start);
+
+	// Request the frames of the reader as a single range (starting at the first frame which is not cached
+	// by this clip). Time mapped clips request each frame by itself, since their reader frames can be out of order.
+	if (time.GetLength() <= 1) {
+		int64_t first_frame = start;
+		while (first_frame < start + count && cache.GetFrame(first_frame))
+			first_frame++;
+		int64_t last_frame = start + count - 1;
+		if (reader->info.video_length > 0)
+			last_frame = std::min(last_frame, reader->info.video_length);
+
+		// Debug output
+		ZmqLogger::Instance()->AppendDebugMethod("Clip::GetFrames", "start", start, "count", count, "first_frame", first_frame, "last_frame", last_frame);
+
+		if (first_frame <= last_frame) {
+			try {
+				// The frames are cached by the reader, and used by GetFrame
+				reader->GetFrames(first_frame, last_frame - first_frame + 1);
+			} catch (const ReaderClosed & e) {
+				// ...
+			} catch (const TooManySeeks & e) {
+				// ...
+			} catch (const OutOfBoundsFrame & e) {
+				// ...
+			}
+		}
+	}
+
+	// Apply the keyframes and effects of each frame (in order)
+	frames.reserve(count);
+	for (int64_t frame_number = start; frame_number < start + count; frame_number++)
+		frames.push_back(GetFrame(frame_number));
+	return frames;
+}
+
 // Use an existing openshot::Frame object and draw this Clip's frame onto it
 std::shared_ptr<Frame> Clip::GetFrame(std::shared_ptr<openshot::Frame> frame, int64_t frame_number)
 {
@@ -366,13 +427,28 @@ std::shared_ptr<Frame> Clip::GetFrame(std::shared_ptr<openshot::Frame> frame, in
 			return cached_frame;
 		}
 
+		// Get keyframe values for this frame (precomputed, if baked)
+		ClipFrameValues values = GetFrameValues(frame_number);
+
+		// Re-use the image of an identical frame (if it has already been rendered)
+		std::shared_ptr<Frame> identical_frame;
+		int64_t identical_frame_number = GetIdenticalFrame(frame_number);
+		if (identical_frame_number != frame_number) {
+			identical_frame = cache.GetFrame(identical_frame_number);
+			if (!identical_frame && GetIdenticalFrame(frame_number - 1) == identical_frame_number) {
+				// The previous frame is identical too (and more likely to still be cached)
+				identical_frame_number = frame_number - 1;
+				identical_frame = cache.GetFrame(identical_frame_number);
+			}
+		}
+
 		// Adjust has_video and has_audio overrides
-		int enabled_audio = has_audio.GetInt(frame_number);
+		int enabled_audio = values.has_audio;
 		if (enabled_audio == -1 && reader && reader->info.has_audio)
 			enabled_audio = 1;
 		else if (enabled_audio == -1 && reader && !reader->info.has_audio)
 			enabled_audio = 0;
-		int enabled_video = has_video.GetInt(frame_number);
+		int enabled_video = values.has_video;
 		if (enabled_video == -1 && reader && reader->info.has_video)
 			enabled_video = 1;
 		else if (enabled_video == -1 && reader && !reader->info.has_audio)
@@ -380,7 +456,7 @@ std::shared_ptr<Frame> Clip::GetFrame(std::shared_ptr<openshot::Frame> frame, in
 
 		// Is a time map detected
 		int64_t new_frame_number = frame_number;
-		int64_t time_mapped_number = adjust_frame_number_minimum(time.GetLong(frame_number));
+		int64_t time_mapped_number = adjust_frame_number_minimum(values.time);
 		if (time.GetLength() > 1)
 			new_frame_number = time_mapped_number;
 
@@ -388,9 +464,13 @@ std::shared_ptr<Frame> Clip::GetFrame(std::shared_ptr<openshot::Frame> frame, in
 		std::shared_ptr<Frame> original_frame;
 		original_frame = GetOrCreateFrame(new_frame_number);
 
-		// Copy the image from the odd field
-		if (enabled_video)
-			frame->AddImage(std::make_shared<QImage>(*original_frame->GetImage()));
+		// Copy the image from the odd field (solid color frames stay solid, without drawing their pixels)
+		if (enabled_video && !identical_frame) {
+			if (original_frame->IsSolidColor())
+				frame->AddColor(original_frame->GetWidth(), original_frame->GetHeight(), original_frame->SolidColor());
+			else
+				frame->AddImage(std::make_shared<QImage>(*original_frame->GetImage()));
+		}
 
 		// Loop through each channel, add audio
 		if (enabled_audio && reader->info.has_audio)
@@ -404,24 +484,33 @@ std::shared_ptr<Frame> Clip::GetFrame(std::shared_ptr<openshot::Frame> frame, in
 		// Adjust # of samples to match requested (the interaction with time curves will make this tricky)
 		// TODO: Implement move samples to/from next frame
 
-		// Apply effects to the frame (if any)
-		apply_effects(frame);
-
-		// Determine size of image (from Timeline or Reader)
-		int width = 0;
-		int height = 0;
-		if (timeline) {
-			// Use timeline size (if available)
-			width = timeline->preview_width;
-			height = timeline->preview_height;
+		if (identical_frame) {
+			// Copy the already rendered image (no effects or keyframes need to be applied)
+			ZmqLogger::Instance()->AppendDebugMethod("Clip::GetFrame", "re-used identical frame", identical_frame_number, "frame_number", frame_number);
+			if (identical_frame->IsSolidColor())
+				frame->AddColor(identical_frame->GetWidth(), identical_frame->GetHeight(), identical_frame->SolidColor());
+			else
+				frame->AddImage(std::make_shared<QImage>(*identical_frame->GetImage()));
 		} else {
-			// Fallback to clip size
-			width = reader->info.width;
-			height = reader->info.height;
-		}
+			// Apply effects to the frame (if any)
+			apply_effects(frame);
+
+			// Determine size of image (from Timeline or Reader)
+			int width = 0;
+			int height = 0;
+			if (timeline) {
+				// Use timeline size (if available)
+				width = timeline->preview_width;
+				height = timeline->preview_height;
+			} else {
+				// Fallback to clip size
+				width = reader->info.width;
+				height = reader->info.height;
+			}
 
-		// Apply keyframe / transforms
-		apply_keyframes(frame, width, height);
+			// Apply keyframe / transforms
+			apply_keyframes(frame, width, height);
+		}
 
 		// Cache frame
 		cache.Add(frame);
@@ -437,6 +526,9 @@ std::shared_ptr<Frame> Clip::GetFrame(std::shared_ptr<openshot::Frame> frame, in
 // Look up an effect by ID
 openshot::EffectBase* Clip::GetEffect(const std::string& id)
 {
+	// Load effects (if deferred)
+	LoadDeferredJson();
+
 	// Find the matching effect (if any)
 	for (const auto& effect : effects) {
 		if (effect->Id() == id) {
@@ -446,6 +538,135 @@ openshot::EffectBase* Clip::GetEffect(const std::string& id)
 	return nullptr;
 }
 
+// Compare the keyframe values which affect the video of a frame
+static bool is_same_video(const ClipFrameValues& a, const ClipFrameValues& b)
+{
+	return a.alpha == b.alpha && a.scale_x == b.scale_x && a.scale_y == b.scale_y &&
+		   a.location_x == b.location_x && a.location_y == b.location_y && a.rotation == b.rotation &&
+		   a.shear_x == b.shear_x && a.shear_y == b.shear_y && a.origin_x == b.origin_x &&
+		   a.origin_y == b.origin_y && a.has_video == b.has_video;
+}
+
+// Precompute the keyframe values for a range of frames
+void Clip::Bake(int64_t start_frame, int64_t end_frame)
+{
+	// Load keyframes and effects (if deferred)
+	LoadDeferredJson();
+
+	start_frame = adjust_frame_number_minimum(start_frame);
+	if (end_frame < start_frame) {
+		ClearBake();
+		return;
+	}
+	int64_t number_of_frames = end_frame - start_frame + 1;
+
+	ZmqLogger::Instance()->AppendDebugMethod("Clip::Bake", "start_frame", start_frame, "end_frame", end_frame);
+
+	std::shared_ptr<BakedValues> new_baked = std::make_shared<BakedValues>();
+	new_baked->start_frame = start_frame;
+	new_baked->values.resize(number_of_frames);
+
+	// Evaluate each keyframe for the whole range at once
+	const std::pair<const Keyframe*, float ClipFrameValues::*> float_keyframes[] = {
+		{&alpha, &ClipFrameValues::alpha}, {&scale_x, &ClipFrameValues::scale_x}, {&scale_y, &ClipFrameValues::scale_y},
+		{&location_x, &ClipFrameValues::location_x}, {&location_y, &ClipFrameValues::location_y},
+		{&rotation, &ClipFrameValues::rotation}, {&shear_x, &ClipFrameValues::shear_x}, {&shear_y, &ClipFrameValues::shear_y},
+		{&origin_x, &ClipFrameValues::origin_x}, {&origin_y, &ClipFrameValues::origin_y}, {&volume, &ClipFrameValues::volume}
+	};
+	for (const auto& keyframe : float_keyframes) {
+		std::vector<double> keyframe_values = keyframe.first->GetValues(start_frame, number_of_frames);
+		for (int64_t index = 0; index < number_of_frames; index++)
+			new_baked->values[index].*(keyframe.second) = keyframe_values[index];
+	}
+	const std::pair<const Keyframe*, int ClipFrameValues::*> int_keyframes[] = {
+		{&channel_filter, &ClipFrameValues::channel_filter}, {&channel_mapping, &ClipFrameValues::channel_mapping},
+		{&has_audio, &ClipFrameValues::has_audio}, {&has_video, &ClipFrameValues::has_video}
+	};
+	for (const auto& keyframe : int_keyframes) {
+		std::vector<double> keyframe_values = keyframe.first->GetValues(start_frame, number_of_frames);
+		for (int64_t index = 0; index < number_of_frames; index++)
+			new_baked->values[index].*(keyframe.second) = int(round(keyframe_values[index]));
+	}
+	std::vector<double> time_values = time.GetValues(start_frame, number_of_frames);
+	for (int64_t index = 0; index < number_of_frames; index++)
+		new_baked->values[index].time = long(round(time_values[index]));
+
+	// Find frames with identical video (the same source image, keyframe values, and no frame dependent effects)
+	bool is_static = effects.empty() && !waveform && display == FRAME_DISPLAY_NONE;
+	bool single_image = reader && reader->info.has_single_image;
+	bool time_mapped = time.GetLength() > 1;
+	new_baked->identical_frames.resize(number_of_frames);
+	for (int64_t index = 0; index < number_of_frames; index++) {
+		new_baked->identical_frames[index] = start_frame + index;
+		if (index > 0 && is_static) {
+			const ClipFrameValues& current = new_baked->values[index];
+			const ClipFrameValues& previous = new_baked->values[index - 1];
+			bool same_source = single_image || (time_mapped && current.time == previous.time);
+			if (same_source && is_same_video(current, previous))
+				new_baked->identical_frames[index] = new_baked->identical_frames[index - 1];
+		}
+	}
+
+	// Largest scale (used by readers)
+	new_baked->max_scale = QSizeF(scale_x.GetMaxPoint().co.Y, scale_y.GetMaxPoint().co.Y);
+
+	std::atomic_store(&baked, std::shared_ptr<const BakedValues>(new_baked));
+}
+
+// Remove any precomputed keyframe values
+void Clip::ClearBake()
+{
+	std::atomic_store(&baked, std::shared_ptr<const BakedValues>());
+}
+
+// Get the keyframe values of a frame
+ClipFrameValues Clip::GetFrameValues(int64_t frame_number) const
+{
+	// Use precomputed values (if any)
+	std::shared_ptr<const BakedValues> current = std::atomic_load(&baked);
+	if (current && frame_number >= current->start_frame &&
+		frame_number - current->start_frame < (int64_t) current->values.size())
+		return current->values[frame_number - current->start_frame];
+
+	ClipFrameValues values;
+	values.alpha = alpha.GetValue(frame_number);
+	values.scale_x = scale_x.GetValue(frame_number);
+	values.scale_y = scale_y.GetValue(frame_number);
+	values.location_x = location_x.GetValue(frame_number);
+	values.location_y = location_y.GetValue(frame_number);
+	values.rotation = rotation.GetValue(frame_number);
+	values.shear_x = shear_x.GetValue(frame_number);
+	values.shear_y = shear_y.GetValue(frame_number);
+	values.origin_x = origin_x.GetValue(frame_number);
+	values.origin_y = origin_y.GetValue(frame_number);
+	values.volume = volume.GetValue(frame_number);
+	values.channel_filter = channel_filter.GetInt(frame_number);
+	values.channel_mapping = channel_mapping.GetInt(frame_number);
+	values.has_audio = has_audio.GetInt(frame_number);
+	values.has_video = has_video.GetInt(frame_number);
+	values.time = time.GetLong(frame_number);
+	return values;
+}
+
+// Get the first frame with identical video to this frame
+int64_t Clip::GetIdenticalFrame(int64_t frame_number) const
+{
+	std::shared_ptr<const BakedValues> current = std::atomic_load(&baked);
+	if (current && frame_number >= current->start_frame &&
+		frame_number - current->start_frame < (int64_t) current->identical_frames.size())
+		return current->identical_frames[frame_number - current->start_frame];
+	return frame_number;
+}
+
+// Get the largest scale_x and scale_y values
+QSizeF Clip::GetMaxScale() const
+{
+	std::shared_ptr<const BakedValues> current = std::atomic_load(&baked);
+	if (current)
+		return current->max_scale;
+	return QSizeF(scale_x.GetMaxPoint().co.Y, scale_y.GetMaxPoint().co.Y);
+}
+
 // Get file extension
 std::string Clip::get_file_extension(std::string path)
 {
@@ -496,8 +717,15 @@ void Clip::get_time_mapped_frame(std::shared_ptr<Frame> frame, int64_t frame_num
 
 		// create buffer and resampler
 		juce::AudioSampleBuffer *samples = NULL;
+		if (resampler && frame_number != resampler_next_frame) {
+			// Not the next frame of the resampler (i.e. after a seek). Start a new resampler,
+			// since its buffered samples belong to a different position.
+			delete resampler;
+			resampler = NULL;
+		}
 		if (!resampler)
 			resampler = new AudioResampler();
+		resampler_next_frame = frame_number + 1;
 
 		// Get new frame number
 		int new_frame_number = frame->number;
@@ -749,6 +977,9 @@ std::string Clip::Json() const {
 // Get all properties for a specific frame
 std::string Clip::PropertiesJSON(int64_t requested_frame) const {
 
+	// Load keyframes (if deferred). This only completes the loading of this clip, so it is still logically const.
+	const_cast<Clip*>(this)->LoadDeferredJson();
+
 	// Generate JSON properties list
 	Json::Value root;
 	root["id"] = add_property_json("ID", 0.0, "string", Id(), NULL, -1, -1, true, requested_frame);
@@ -834,6 +1065,9 @@ std::string Clip::PropertiesJSON(int64_t requested_frame) const {
 // Generate Json::Value for this object
 Json::Value Clip::JsonValue() const {
 
+	// Load keyframes and effects (if deferred)
+	const_cast<Clip*>(this)->LoadDeferredJson();
+
 	// Create root json object
 	Json::Value root = ClipBase::JsonValue(); // get parent properties
 	root["gravity"] = gravity;
@@ -886,6 +1120,30 @@ Json::Value Clip::JsonValue() const {
 	return root;
 }
 
+// Generate compact binary string of this object
+std::string Clip::Binary() const {
+
+	// Return encoded string
+	return openshot::jsonToBinary(JsonValue());
+}
+
+// Load compact binary string into this object
+void Clip::SetBinary(const std::string binary) {
+
+	// Decode binary string into JSON objects
+	try
+	{
+		const Json::Value root = openshot::binaryToJson(binary);
+		// Set all values that match
+		SetJsonValue(root);
+	}
+	catch (const std::exception& e)
+	{
+		// Error decoding binary JSON (or missing keys)
+		throw InvalidJSON("Binary JSON is invalid (missing keys or invalid data types)");
+	}
+}
+
 // Load JSON string into this object
 void Clip::SetJson(const std::string value) {
 
@@ -906,11 +1164,15 @@ void Clip::SetJson(const std::string value) {
 // Load Json::Value into this object
 void Clip::SetJsonValue(const Json::Value root) {
 
+	// Load deferred JSON first (so it does not overwrite these newer values later)
+	LoadDeferredJson();
+
 	// Set parent data
 	ClipBase::SetJsonValue(root);
 
-	// Clear cache
+	// Clear cache (and precomputed keyframe values)
 	cache.Clear();
+	ClearBake();
 
 	// Set data from Json (if key is found)
 	if (!root["gravity"].isNull())
@@ -1077,6 +1339,48 @@ void Clip::SetJsonValue(const Json::Value root) {
 	}
 }
 
+// Store JSON which is loaded the first time this clip is used
+void Clip::DeferJson(const std::string value)
+{
+	// Load any previously deferred JSON first (to preserve the order of changes)
+	LoadDeferredJson();
+
+	const GenericScopedLock<juce::CriticalSection> lock(getFrameCriticalSection);
+	deferred_json = value;
+	has_deferred_json = !deferred_json.empty();
+}
+
+// Load any deferred JSON into this clip (if any)
+void Clip::LoadDeferredJson()
+{
+	if (!has_deferred_json)
+		return;
+
+	const GenericScopedLock<juce::CriticalSection> lock(getFrameCriticalSection);
+	if (deferred_json.empty())
+		return; // Already loaded by another thread (or being loaded by this one)
+
+	// Take the deferred JSON (so SetJsonValue does not try to load it again)
+	std::string value;
+	value.swap(deferred_json);
+
+	ZmqLogger::Instance()->AppendDebugMethod("Clip::LoadDeferredJson", "value.size()", value.size());
+
+	// Parse and apply the JSON (other threads wait on the lock until this is done)
+	try
+	{
+		SetJsonValue(openshot::stringToJson(value));
+	}
+	catch (const std::exception& e)
+	{
+		has_deferred_json = false;
+
+		// Error parsing JSON (or missing keys)
+		throw InvalidJSON("JSON is invalid (missing keys or invalid data types)");
+	}
+	has_deferred_json = false;
+}
+
 // Sort effects by order
 void Clip::sort_effects()
 {
@@ -1087,6 +1391,9 @@ void Clip::sort_effects()
 // Add an effect to the clip
 void Clip::AddEffect(EffectBase* effect)
 {
+	// Load existing effects (if deferred)
+	LoadDeferredJson();
+
 	// Set parent clip pointer
 	effect->ParentClip(this);
 
@@ -1096,17 +1403,22 @@ void Clip::AddEffect(EffectBase* effect)
 	// Sort effects
 	sort_effects();
 
-	// Clear cache
+	// Clear cache (and precomputed keyframe values)
 	cache.Clear();
+	ClearBake();
 }
 
 // Remove an effect from the clip
 void Clip::RemoveEffect(EffectBase* effect)
 {
+	// Load existing effects (if deferred)
+	LoadDeferredJson();
+
 	effects.remove(effect);
 
-	// Clear cache
+	// Clear cache (and precomputed keyframe values)
 	cache.Clear();
+	ClearBake();
 }
 
 // Apply effects to the source frame (if any)
@@ -1131,8 +1443,10 @@ bool Clip::isEqual(double a, double b)
 // Apply keyframes to the source frame (if any)
 void Clip::apply_keyframes(std::shared_ptr<Frame> frame, int width, int height)
 {
-	// Get actual frame image data
-	std::shared_ptr<QImage> source_image = frame->GetImage();
+	// Get actual frame image data (solid color frames are only drawn if they need to be transformed)
+	std::shared_ptr<QImage> source_image;
+	if (!frame->IsSolidColor())
+		source_image = frame->GetImage();
 
 	/* REPLACE IMAGE WITH WAVEFORM IMAGE (IF NEEDED) */
 	if (Waveform())
@@ -1150,32 +1464,13 @@ void Clip::apply_keyframes(std::shared_ptr<Frame> frame, int width, int height)
 		source_image = frame->GetWaveform(width, height, red, green, blue, alpha);
 		frame->AddImage(std::shared_ptr<QImage>(source_image));
 	}
+	QSize image_size = source_image ? source_image->size() : QSize(frame->GetWidth(), frame->GetHeight());
 
-	/* ALPHA & OPACITY */
-	if (alpha.GetValue(frame->number) != 1.0)
-	{
-		float alpha_value = alpha.GetValue(frame->number);
-
-		// Get source image's pixels
-		unsigned char *pixels = source_image->bits();
-
-		// Loop through pixels
-		for (int pixel = 0, byte_index=0; pixel < source_image->width() * source_image->height(); pixel++, byte_index+=4)
-		{
-			// Apply alpha to pixel values (since we use a premultiplied value, we must
-			// multiply the alpha with all colors).
-			pixels[byte_index + 0] *= alpha_value;
-			pixels[byte_index + 1] *= alpha_value;
-			pixels[byte_index + 2] *= alpha_value;
-			pixels[byte_index + 3] *= alpha_value;
-		}
-
-		// Debug output
-		ZmqLogger::Instance()->AppendDebugMethod("Clip::apply_keyframes (Set Alpha & Opacity)", "alpha_value", alpha_value, "frame->number", frame->number);
-	}
+	// Get keyframe values for this frame (precomputed, if baked)
+	ClipFrameValues values = GetFrameValues(frame->number);
 
 	/* RESIZE SOURCE IMAGE - based on scale type */
-	QSize source_size = source_image->size();
+	QSize source_size = image_size;
 	switch (scale)
 	{
 		case (SCALE_FIT): {
@@ -1218,8 +1513,8 @@ void Clip::apply_keyframes(std::shared_ptr<Frame> frame, int width, int height)
 	float y = 0.0; // top
 
 	// Adjust size for scale x and scale y
-	float sx = scale_x.GetValue(frame->number); // percentage X scale
-	float sy = scale_y.GetValue(frame->number); // percentage Y scale
+	float sx = values.scale_x; // percentage X scale
+	float sy = values.scale_y; // percentage Y scale
 	float scaled_source_width = source_size.width() * sx;
 	float scaled_source_height = source_size.height() * sy;
 
@@ -1262,13 +1557,13 @@ void Clip::apply_keyframes(std::shared_ptr<Frame> frame, int width, int height)
 	ZmqLogger::Instance()->AppendDebugMethod("Clip::apply_keyframes (Gravity)", "frame->number", frame->number, "source_clip->gravity", gravity, "scaled_source_width", scaled_source_width, "scaled_source_height", scaled_source_height);
 
 	/* LOCATION, ROTATION, AND SCALE */
-	float r = rotation.GetValue(frame->number); // rotate in degrees
-	x += (width * location_x.GetValue(frame->number)); // move in percentage of final width
-	y += (height * location_y.GetValue(frame->number)); // move in percentage of final height
-	float shear_x_value = shear_x.GetValue(frame->number);
-	float shear_y_value = shear_y.GetValue(frame->number);
-	float origin_x_value = origin_x.GetValue(frame->number);
-	float origin_y_value = origin_y.GetValue(frame->number);
+	float r = values.rotation; // rotate in degrees
+	x += (width * values.location_x); // move in percentage of final width
+	y += (height * values.location_y); // move in percentage of final height
+	float shear_x_value = values.shear_x;
+	float shear_y_value = values.shear_y;
+	float origin_x_value = values.origin_x;
+	float origin_y_value = values.origin_y;
 
 	QTransform transform;
 
@@ -1291,13 +1586,55 @@ void Clip::apply_keyframes(std::shared_ptr<Frame> frame, int width, int height)
 	}
 
 	// SCALE CLIP (if needed)
-	float source_width_scale = (float(source_size.width()) / float(source_image->width())) * sx;
-	float source_height_scale = (float(source_size.height()) / float(source_image->height())) * sy;
+	float source_width_scale = (float(source_size.width()) / float(image_size.width())) * sx;
+	float source_height_scale = (float(source_size.height()) / float(image_size.height())) * sy;
 
 	if (!isEqual(source_width_scale, 1.0) || !isEqual(source_height_scale, 1.0)) {
 		transform.scale(source_width_scale, source_height_scale);
 	}
 
+	/* SOLID COLOR - a solid color frame which still covers the whole frame (not rotated or sheared, and
+	 * without frame numbers) stays a solid color, so the Timeline can composite it without drawing pixels */
+	if (!source_image && transform.type() <= QTransform::TxScale && (!timeline || display == FRAME_DISPLAY_NONE)) {
+		QRectF covered = transform.mapRect(QRectF(QPointF(0, 0), QSizeF(image_size)));
+		if (covered.left() <= 0.01 && covered.top() <= 0.01 && covered.right() >= width - 0.01 && covered.bottom() >= height - 0.01) {
+			// Apply alpha to the color
+			QColor solid_color(QString::fromStdString(frame->SolidColor()));
+			solid_color.setAlphaF(solid_color.alphaF() * values.alpha);
+
+			// Debug output
+			ZmqLogger::Instance()->AppendDebugMethod("Clip::apply_keyframes (Solid color)", "frame->number", frame->number, "width", width, "height", height);
+
+			frame->AddColor(width, height, solid_color.name(QColor::HexArgb).toStdString());
+			return;
+		}
+	}
+	if (!source_image)
+		source_image = frame->GetImage();
+
+	/* ALPHA & OPACITY */
+	if (values.alpha != 1.0)
+	{
+		float alpha_value = values.alpha;
+
+		// Get source image's pixels
+		unsigned char *pixels = source_image->bits();
+
+		// Loop through pixels
+		for (int pixel = 0, byte_index=0; pixel < source_image->width() * source_image->height(); pixel++, byte_index+=4)
+		{
+			// Apply alpha to pixel values (since we use a premultiplied value, we must
+			// multiply the alpha with all colors).
+			pixels[byte_index + 0] *= alpha_value;
+			pixels[byte_index + 1] *= alpha_value;
+			pixels[byte_index + 2] *= alpha_value;
+			pixels[byte_index + 3] *= alpha_value;
+		}
+
+		// Debug output
+		ZmqLogger::Instance()->AppendDebugMethod("Clip::apply_keyframes (Set Alpha & Opacity)", "alpha_value", alpha_value, "frame->number", frame->number);
+	}
+
 	// Debug output
 	ZmqLogger::Instance()->AppendDebugMethod("Clip::apply_keyframes (Transform: Composite Image Layer: Prepare)", "frame->number", frame->number);
 
@@ -31,8 +31,11 @@
 #ifndef OPENSHOT_CLIP_H
 #define OPENSHOT_CLIP_H
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
+#include <QtCore/QSizeF>
 #include <QtGui/QImage>
 #include "AudioResampler.h"
 #include "ClipBase.h"
@@ -60,6 +63,26 @@ namespace openshot {
 			return false;
 	}};
 
+	/// Keyframe values of a clip at a single frame (see Clip::GetFrameValues)
+	struct ClipFrameValues {
+		float alpha; ///< Alpha (0 to 1)
+		float scale_x; ///< Horizontal scale (0 to 1)
+		float scale_y; ///< Vertical scale (0 to 1)
+		float location_x; ///< Relative X position (-1 to 1)
+		float location_y; ///< Relative Y position (-1 to 1)
+		float rotation; ///< Rotation in degrees
+		float shear_x; ///< X shear angle
+		float shear_y; ///< Y shear angle
+		float origin_x; ///< X origin point of rotation and shear (0 to 1)
+		float origin_y; ///< Y origin point of rotation and shear (0 to 1)
+		float volume; ///< Volume (0 to 1)
+		int channel_filter; ///< Audio channel to filter (-1 for none)
+		int channel_mapping; ///< Audio channel to map to (-1 for none)
+		int has_audio; ///< Audio override (-1=undefined, 0=no, 1=yes)
+		int has_video; ///< Video override (-1=undefined, 0=no, 1=yes)
+		int64_t time; ///< Time mapped frame number
+	};
+
 	/**
 	 * @brief This class represents a clip (used to arrange readers on the timeline)
 	 *
@@ -101,6 +124,15 @@ namespace openshot {
 		/// Init default settings for a clip
 		void init_settings();
 
+		/// Keyframe values precomputed for a range of frames (see Bake)
+		struct BakedValues {
+			int64_t start_frame; ///< Frame number of the first values
+			std::vector<openshot::ClipFrameValues> values; ///< Keyframe values of each frame
+			std::vector<int64_t> identical_frames; ///< The first frame with identical video (for each frame)
+			QSizeF max_scale; ///< The largest scale_x and scale_y values
+		};
+		std::shared_ptr<const BakedValues> baked; ///< Precomputed keyframe values (if any)
+
 		/// Init reader info details
 		void init_reader_settings();
 
@@ -111,9 +143,12 @@ namespace openshot {
 		bool waveform; ///< Should a waveform be used instead of the clip's image
 		std::list<openshot::EffectBase*> effects; ///<List of clips on this timeline
 		bool is_open;	///> Is Reader opened
+		std::string deferred_json; ///< JSON (keyframes and effects) not loaded yet, see DeferJson()
+		std::atomic<bool> has_deferred_json; ///< Is there any deferred JSON to load
 
 		// Audio resampler (if time mapping)
 		openshot::AudioResampler *resampler;
+		int64_t resampler_next_frame; ///< The frame number which continues the audio of the resampler
 
 		// File Reader object
 		openshot::ReaderBase* reader;
@@ -185,15 +220,48 @@ namespace openshot {
 		/// @param effect Add an effect to the clip. An effect can modify the audio or video of an openshot::Frame.
 		void AddEffect(openshot::EffectBase* effect);
 
+		/// @brief Precompute the keyframe values (transforms, alpha and audio gains) for a range of frames
+		///
+		/// This is useful before rendering a long range of frames (i.e. an export), since keyframes are evaluated
+		/// once for the whole range, instead of for each property of each frame. It also records which frames have
+		/// identical video, so GetFrame() can re-use an already rendered image. The values are cleared when JSON
+		/// is loaded or effects are changed. Call ClearBake() after changing keyframes directly.
+		/// @param start_frame The first frame number of the clip
+		/// @param end_frame The last frame number of the clip
+		void Bake(int64_t start_frame, int64_t end_frame);
+
+		/// Remove any precomputed keyframe values
+		void ClearBake();
+
 		/// Close the internal reader
 		void Close() override;
 
+		/// @brief Store JSON which is loaded the first time this clip is used (i.e. keyframes and effects)
+		///
+		/// The JSON is applied with SetJsonValue() when the clip is opened, rendered, modified or converted
+		/// to JSON, which saves time and memory when loading very large projects. Keyframe members accessed
+		/// directly (i.e. clip.alpha) require Open() or LoadDeferredJson() to be called first.
+		/// @param value A JSON object string
+		void DeferJson(const std::string value);
+
+		/// Load any deferred JSON into this clip (if any)
+		void LoadDeferredJson();
+
 		/// Return the list of effects on the timeline
-		std::list<openshot::EffectBase*> Effects() { return effects; };
+		std::list<openshot::EffectBase*> Effects() { LoadDeferredJson(); return effects; };
 
 		/// Look up an effect by ID
 		openshot::EffectBase* GetEffect(const std::string& id);
 
+		/// Get the keyframe values of a frame (precomputed, if the frame was baked)
+		openshot::ClipFrameValues GetFrameValues(int64_t frame_number) const;
+
+		/// Get the first frame with identical video to this frame (or the same frame number, if not known)
+		int64_t GetIdenticalFrame(int64_t frame_number) const;
+
+		/// Get the largest scale_x and scale_y values (used by readers to choose the size of decoded images)
+		QSizeF GetMaxScale() const;
+
 		/// @brief Get an openshot::Frame object for a specific frame number of this timeline. The image size and number
 		/// of samples match the source reader.
 		///
@@ -213,6 +281,14 @@ namespace openshot {
 		/// @param frame_number The frame number (starting at 1) of the clip or effect on the timeline.
 		std::shared_ptr<openshot::Frame> GetFrame(std::shared_ptr<openshot::Frame> frame, int64_t frame_number) override;
 
+		/// @brief Get a range of sequential frames of this clip (see GetFrame). The frames of the reader are
+		/// requested as a single range (i.e. FFmpegReader::GetFrames), unless the clip is time mapped.
+		///
+		/// @returns The frames (in order)
+		/// @param start The first frame number (starting at 1) of the clip
+		/// @param count The number of frames
+		std::vector<std::shared_ptr<openshot::Frame>> GetFrames(int64_t start, int64_t count);
+
 		/// Open the internal reader
 		void Open() override;
 
@@ -225,7 +301,7 @@ namespace openshot {
 
 		/// Override End() method
 		float End() const; ///< Get end position (in seconds) of clip (trim end of video), which can be affected by the time curve.
-		void End(float value) { end = value; } ///< Set end position (in seconds) of clip (trim end of video)
+		void End(float value) { end = value; properties_cache.valid = false; } ///< Set end position (in seconds) of clip (trim end of video)
 
 		/// Get and Set JSON methods
 		std::string Json() const override; ///< Generate JSON string of this object
@@ -233,6 +309,10 @@ namespace openshot {
 		Json::Value JsonValue() const override; ///< Generate Json::Value for this object
 		void SetJsonValue(const Json::Value root) override; ///< Load Json::Value into this object
 
+		/// Get and Set compact binary methods (see openshot::jsonToBinary)
+		std::string Binary() const; ///< Generate compact binary string of this object
+		void SetBinary(const std::string binary); ///< Load compact binary string into this object
+
 		/// Get all properties for a specific frame (perfect for a UI to display the current state
 		/// of all properties at any time)
 		std::string PropertiesJSON(int64_t requested_frame) const override;
@@ -243,7 +323,7 @@ namespace openshot {
 
 		/// Waveform property
 		bool Waveform() { return waveform; } ///< Get the waveform property of this clip
-		void Waveform(bool value) { waveform = value; } ///< Set the waveform property of this clip
+		void Waveform(bool value) { waveform = value; properties_cache.valid = false; } ///< Set the waveform property of this clip
 
 		// Scale, Location, and Alpha curves
 		openshot::Keyframe scale_x; ///< Curve representing the horizontal scaling in percent (0 to 1)
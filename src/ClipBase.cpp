@@ -32,6 +32,50 @@
 
 using namespace openshot;
 
+// Keyframes passed to add_property_json (only while this thread is updating the properties cache)
+static thread_local std::vector<const Keyframe*>* recorded_keyframes = NULL;
+
+// Set the keyframe details of a property
+static void set_property_keyframe_json(Json::Value& prop, const Keyframe* keyframe, int64_t requested_frame) {
+
+	// Requested Point
+	const Point requested_point(requested_frame, requested_frame);
+
+	prop["keyframe"] = keyframe->Contains(requested_point);
+	prop["points"] = int(keyframe->GetCount());
+	Point closest_point = keyframe->GetClosestPoint(requested_point);
+	prop["interpolation"] = closest_point.interpolation;
+	prop["closest_point_x"] = closest_point.co.X;
+	prop["previous_point_x"] = keyframe->GetPreviousPoint(closest_point).co.X;
+}
+
+// Find the properties which depend on keyframes (marked by add_property_json)
+static void find_keyframe_properties(Json::Value& node, std::vector<std::string>& path, const std::vector<const Keyframe*>& keyframes, std::vector<PropertiesCache::KeyframeProperty>& found) {
+
+	if (!node.isObject())
+		return;
+
+	if (node.isMember("recorded_keyframe")) {
+		unsigned int index = node["recorded_keyframe"].asUInt();
+		node.removeMember("recorded_keyframe");
+		if (index < keyframes.size()) {
+			PropertiesCache::KeyframeProperty property;
+			property.property = &node;
+			property.keyframe = keyframes[index];
+			property.path = path;
+			property.has_value = node["type"].asString() != "color";
+			found.push_back(property);
+		}
+	}
+
+	// Look for nested properties (i.e. the red, green and blue of a color)
+	for (const std::string& key : node.getMemberNames()) {
+		path.push_back(key);
+		find_keyframe_properties(node[key], path, keyframes, found);
+		path.pop_back();
+	}
+}
+
 // Generate Json::Value for this object
 Json::Value ClipBase::JsonValue() const {
 
@@ -51,6 +95,9 @@ Json::Value ClipBase::JsonValue() const {
 // Load Json::Value into this object
 void ClipBase::SetJsonValue(const Json::Value root) {
 
+	// Clear cached properties
+	properties_cache.valid = false;
+
 	// Set data from Json (if key is found)
 	if (!root["id"].isNull())
 		Id(root["id"].asString());
@@ -67,9 +114,6 @@ void ClipBase::SetJsonValue(const Json::Value root) {
 // Generate JSON for a property
 Json::Value ClipBase::add_property_json(std::string name, float value, std::string type, std::string memo, const Keyframe* keyframe, float min_value, float max_value, bool readonly, int64_t requested_frame) const {
 
-	// Requested Point
-	const Point requested_point(requested_frame, requested_frame);
-
 	// Create JSON Object
 	Json::Value prop = Json::Value(Json::objectValue);
 	prop["name"] = name;
@@ -79,12 +123,13 @@ Json::Value ClipBase::add_property_json(std::string name, float value, std::stri
 	prop["min"] = min_value;
 	prop["max"] = max_value;
 	if (keyframe) {
-		prop["keyframe"] = keyframe->Contains(requested_point);
-		prop["points"] = int(keyframe->GetCount());
-		Point closest_point = keyframe->GetClosestPoint(requested_point);
-		prop["interpolation"] = closest_point.interpolation;
-		prop["closest_point_x"] = closest_point.co.X;
-		prop["previous_point_x"] = keyframe->GetPreviousPoint(closest_point).co.X;
+		set_property_keyframe_json(prop, keyframe, requested_frame);
+
+		// Mark this property (when updating the properties cache)
+		if (recorded_keyframes) {
+			prop["recorded_keyframe"] = (unsigned int) recorded_keyframes->size();
+			recorded_keyframes->push_back(keyframe);
+		}
 	}
 	else {
 		prop["keyframe"] = false;
@@ -112,3 +157,83 @@ Json::Value ClipBase::add_property_choice_json(std::string name, int value, int
 	// return JsonValue
 	return new_choice;
 }
+
+// Rebuild the cached properties
+void ClipBase::update_properties_cache() const {
+
+	// Generate the properties once, recording which ones depend on keyframes
+	std::vector<const Keyframe*> keyframes;
+	std::string properties;
+	recorded_keyframes = &keyframes;
+	try {
+		properties = PropertiesJSON(1);
+	}
+	catch (...) {
+		recorded_keyframes = NULL;
+		throw;
+	}
+	recorded_keyframes = NULL;
+
+	properties_cache.properties = openshot::stringToJson(properties);
+	properties_cache.keyframes.clear();
+	std::vector<std::string> path;
+	find_keyframe_properties(properties_cache.properties, path, keyframes, properties_cache.keyframes);
+	properties_cache.valid = true;
+}
+
+// Get all properties for a specific frame, re-using the cached names, ranges and choices
+std::string ClipBase::PropertiesSnapshotJSON(int64_t requested_frame) const {
+
+	std::lock_guard<std::mutex> lock(properties_cache.mutex);
+	if (!properties_cache.valid)
+		update_properties_cache();
+
+	// Only update the properties which depend on keyframes
+	for (const auto& item : properties_cache.keyframes) {
+		Json::Value& prop = *item.property;
+		set_property_keyframe_json(prop, item.keyframe, requested_frame);
+		if (item.has_value) {
+			prop["value"] = (float) item.keyframe->GetValue(requested_frame);
+
+			// Update selected choice (if any)
+			int selected_value = item.keyframe->GetInt(requested_frame);
+			for (Json::Value& choice : prop["choices"])
+				choice["selected"] = (choice["value"].asInt() == selected_value);
+		}
+	}
+
+	// Return compact string
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+	return Json::writeString(builder, properties_cache.properties);
+}
+
+// Get the values of all keyframe properties for a range of frames
+std::string ClipBase::PropertiesValuesJSON(int64_t start_frame, int64_t number_of_frames) const {
+
+	std::lock_guard<std::mutex> lock(properties_cache.mutex);
+	if (!properties_cache.valid)
+		update_properties_cache();
+
+	Json::Value root = Json::Value(Json::objectValue);
+	for (const auto& item : properties_cache.keyframes) {
+		if (!item.has_value)
+			continue;
+
+		// Find (or create) the nested location of this property
+		Json::Value* values = &root;
+		for (const std::string& key : item.path)
+			values = &(*values)[key];
+
+		*values = Json::Value(Json::arrayValue);
+		std::vector<double> keyframe_values = item.keyframe->GetValues(start_frame, number_of_frames);
+		values->resize(keyframe_values.size());
+		for (size_t index = 0; index < keyframe_values.size(); index++)
+			(*values)[(Json::ArrayIndex) index] = (float) keyframe_values[index];
+	}
+
+	// Return compact string
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+	return Json::writeString(builder, root);
+}
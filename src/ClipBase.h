@@ -31,8 +31,11 @@
 #ifndef OPENSHOT_CLIPBASE_H
 #define OPENSHOT_CLIPBASE_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <vector>
 #include "CacheMemory.h"
 #include "Exceptions.h"
 #include "Frame.h"
@@ -43,6 +46,30 @@
 
 
 namespace openshot {
+	/**
+	 * @brief Cached properties of a clip or effect (used by ClipBase::PropertiesSnapshotJSON)
+	 *
+	 * Copies of this object start out empty, since the cached keyframe pointers belong to the original object.
+	 */
+	struct PropertiesCache {
+		/// A property which depends on a keyframe
+		struct KeyframeProperty {
+			Json::Value* property; ///< The property (inside the cached properties)
+			const openshot::Keyframe* keyframe; ///< The keyframe which determines the value of this property
+			std::vector<std::string> path; ///< The keys of this property (i.e. "wave_color", "red")
+			bool has_value; ///< Is the value of the property the value of the keyframe (i.e. not a color)
+		};
+
+		std::mutex mutex; ///< Section lock for multiple threads
+		std::atomic<bool> valid; ///< Are the cached properties up to date
+		Json::Value properties; ///< All properties (with names, ranges and choices)
+		std::vector<KeyframeProperty> keyframes; ///< Properties which depend on keyframes
+
+		PropertiesCache() : valid(false) {}
+		PropertiesCache(const PropertiesCache&) : valid(false) {}
+		PropertiesCache& operator=(const PropertiesCache&) { valid = false; return *this; }
+	};
+
 	/**
 	 * @brief This abstract class is the base class, used by all clips in libopenshot.
 	 *
@@ -58,6 +85,10 @@ namespace openshot {
 		float end; ///< The position in seconds to end playing (used to trim the ending of a clip)
 		std::string previous_properties; ///< This string contains the previous JSON properties
 		openshot::TimelineBase* timeline; ///< Pointer to the parent timeline instance (if any)
+		mutable openshot::PropertiesCache properties_cache; ///< Cached properties (see PropertiesSnapshotJSON)
+
+		/// Rebuild the cached properties (properties_cache.mutex must be locked)
+		void update_properties_cache() const;
 
 		/// Generate JSON for a property
 		Json::Value add_property_json(std::string name, float value, std::string type, std::string memo, const Keyframe* keyframe, float min_value, float max_value, bool readonly, int64_t requested_frame) const;
@@ -115,10 +146,10 @@ namespace openshot {
 
 		/// Set basic properties
 		void Id(std::string value) { id = value; } ///> Set the Id of this clip object
-		void Position(float value) { position = value; } ///< Set position on timeline (in seconds)
-		void Layer(int value) { layer = value; } ///< Set layer of clip on timeline (lower number is covered by higher numbers)
-		void Start(float value) { start = value; } ///< Set start position (in seconds) of clip (trim start of video)
-		void End(float value) { end = value; } ///< Set end position (in seconds) of clip (trim end of video)
+		void Position(float value) { position = value; properties_cache.valid = false; } ///< Set position on timeline (in seconds)
+		void Layer(int value) { layer = value; properties_cache.valid = false; } ///< Set layer of clip on timeline (lower number is covered by higher numbers)
+		void Start(float value) { start = value; properties_cache.valid = false; } ///< Set start position (in seconds) of clip (trim start of video)
+		void End(float value) { end = value; properties_cache.valid = false; } ///< Set end position (in seconds) of clip (trim end of video)
 		void ParentTimeline(openshot::TimelineBase* new_timeline) { timeline = new_timeline; } ///< Set associated Timeline pointer
 
 		/// Get and Set JSON methods
@@ -131,6 +162,23 @@ namespace openshot {
 		/// of all properties at any time)
 		virtual std::string PropertiesJSON(int64_t requested_frame) const = 0;
 
+		/// @brief Get all properties for a specific frame, re-using the cached names, ranges and choices
+		///
+		/// This returns the same properties as PropertiesJSON() (as compact JSON), but only the keyframe
+		/// values are evaluated on each call (which is much faster for a UI that updates as the playhead moves).
+		/// The cache is cleared by SetJsonValue() and the basic property setters. Call ClearPropertiesCache()
+		/// after changing any other (non-keyframe) member directly.
+		std::string PropertiesSnapshotJSON(int64_t requested_frame) const;
+
+		/// @brief Get the values of all keyframe properties for a range of frames
+		/// @returns A JSON object (with the same keys as PropertiesJSON) containing an array of values for each keyframe
+		/// @param start_frame The first frame number
+		/// @param number_of_frames The number of frames
+		std::string PropertiesValuesJSON(int64_t start_frame, int64_t number_of_frames) const;
+
+		/// Clear the cached properties (used by PropertiesSnapshotJSON)
+		void ClearPropertiesCache() { properties_cache.valid = false; }
+
 		virtual ~ClipBase() = default;
 	};
 
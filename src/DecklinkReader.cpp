@@ -146,6 +146,9 @@ DecklinkReader::DecklinkReader(int device, int video_mode, int pixel_format, int
 // destructor
 DecklinkReader::~DecklinkReader()
 {
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+
 	if (displayModeIterator != NULL)
 	{
 		displayModeIterator->Release();
@@ -214,6 +217,10 @@ void DecklinkReader::Open()
 // Close device and video stream
 void DecklinkReader::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open)
 	{
@@ -87,6 +87,8 @@ DummyReader::DummyReader(Fraction fps, int width, int height, int sample_rate, i
 }
 
 DummyReader::~DummyReader() {
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
 }
 
 // Open image file
@@ -106,6 +108,10 @@ void DummyReader::Open()
 // Close image file
 void DummyReader::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open)
 	{
@@ -29,9 +29,13 @@
  */
 
 #include "EffectBase.h"
+#include "Clip.h"
 
 using namespace openshot;
 
+// Constructor for the base effect
+EffectBase::EffectBase() : order(0), clip(NULL), executor(NULL) { }
+
 // Initialize the values of the EffectInfo struct
 void EffectBase::InitEffectInfo()
 {
@@ -148,4 +152,21 @@ openshot::ClipBase* EffectBase::ParentClip() {
 /// Set parent clip object of this reader
 void EffectBase::ParentClip(openshot::ClipBase* new_clip) {
 	clip = new_clip;
+}
+
+// Get the executor used by the parallel sections of this effect
+openshot::Executor* EffectBase::GetExecutor() {
+	if (executor)
+		return executor;
+
+	// Use the executor of the parent clip's reader (if any)
+	Clip* parent = dynamic_cast<Clip*>(clip);
+	if (parent) {
+		try {
+			return parent->Reader()->GetExecutor();
+		} catch (const ReaderClosed& e) {
+			// Clip has no reader
+		}
+	}
+	return Executor::Default();
 }
\ No newline at end of file
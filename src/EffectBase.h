@@ -35,6 +35,7 @@
 #include <iomanip>
 #include <memory>
 #include "ClipBase.h"
+#include "Executor.h"
 #include "Json.h"
 #include "Frame.h"
 
@@ -70,9 +71,13 @@ namespace openshot
 
 	protected:
 		openshot::ClipBase* clip; ///< Pointer to the parent clip instance (if any)
+		openshot::Executor* executor; ///< Pointer to the executor of this effect (or NULL for the executor of the parent clip's reader)
 
 	public:
 
+		/// Constructor for the base effect (without a parent clip or executor)
+		EffectBase();
+
 		/// Information about the current effect
 		EffectInfoStruct info;
 
@@ -92,6 +97,14 @@ namespace openshot
 		/// Set parent clip object of this effect
 		void ParentClip(openshot::ClipBase* new_clip);
 
+		/// Get the executor used by the parallel sections of this effect (its own executor, the executor
+		/// of its parent clip's reader, or the default executor)
+		openshot::Executor* GetExecutor();
+
+		/// Set the executor used by the parallel sections of this effect (NULL = use the parent clip's reader).
+		/// You must manage the lifecycle of the executor (this effect will not delete it for you).
+		void SetExecutor(openshot::Executor* new_executor) { executor = new_executor; };
+
 		/// Get and Set JSON methods
 		virtual std::string Json() const = 0; ///< Generate JSON string of this object
 		virtual void SetJson(const std::string value) = 0; ///< Load JSON string into this object
@@ -80,5 +80,15 @@ namespace openshot
 		VOLUME_MIX_AVERAGE,	///< Evenly divide the overlapping clips volume keyframes, so that the sum does not exceed 100%
 		VOLUME_MIX_REDUCE 	///< Reduce volume by about %25, and then mix (louder, but could cause pops if the sum exceeds 100%)
 	};
+
+	/// This enumeration determines how much work is spent decoding video (lower quality for faster previews).
+	enum DecodeMode
+	{
+		DECODE_FULL,			///< Decode every frame at full quality
+		DECODE_FAST,			///< Skip the loop filter and IDCT refinements (some blocking artifacts)
+		DECODE_LOWRES,			///< Decode at a lower resolution (if supported by the codec, when the reader is opened), and skip the loop filter
+		DECODE_REFERENCE_ONLY,	///< Only decode reference frames (skipped frames repeat the previous image)
+		DECODE_KEYFRAMES_ONLY	///< Only decode keyframes (for fast shuttle)
+	};
 }
 #endif
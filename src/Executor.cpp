@@ -0,0 +1,260 @@
+/**
+ * @file
+ * @brief Source file for Executor class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Executor.h"
+#include "OpenMPUtilities.h"
+
+#include <cerrno>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace openshot;
+
+namespace {
+	// The affinity and priority successfully applied to each worker thread (since OpenMP
+	// reuses its threads for the parallel sections of every executor)
+	thread_local bool thread_configured = false;
+	thread_local std::vector<int> thread_affinity;
+	thread_local int thread_priority = 0;
+#ifdef __linux__
+	thread_local cpu_set_t thread_original_affinity;
+#endif
+
+	// The cores and priority of the thread before each (nested) parallel section
+	thread_local std::vector<std::pair<std::vector<int>, int>> thread_previous_states;
+
+	// Set the cores and priority of the calling thread (empty cores = the original cores)
+	void set_thread_state(const std::vector<int>& cores, int priority) {
+#ifdef __linux__
+		// Pin thread to cores (or restore the original cores)
+		if (thread_affinity != cores) {
+			cpu_set_t cpu_set;
+			if (cores.empty()) {
+				cpu_set = thread_original_affinity;
+			} else {
+				CPU_ZERO(&cpu_set);
+				for (int cpu : cores)
+					if (cpu >= 0 && cpu < CPU_SETSIZE)
+						CPU_SET(cpu, &cpu_set);
+			}
+			if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) == 0)
+				thread_affinity = cores;
+		}
+
+		// Set thread priority (on Linux, the nice value of a thread id only affects that thread). Only
+		// privileged processes can lower the nice value again, so this can fail (and is retried later).
+		if (thread_priority != priority) {
+			if (setpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid), priority) == 0)
+				thread_priority = priority;
+		}
+#endif
+	}
+
+	// Parse a sysfs CPU (or node) list (i.e. "0-11,24-35")
+	std::vector<int> parse_cpu_list(const std::string& cpu_list) {
+		std::vector<int> cores;
+		std::stringstream ranges(cpu_list);
+		std::string range;
+		while (std::getline(ranges, range, ',')) {
+			if (range.empty())
+				continue;
+			size_t dash = range.find('-');
+			try {
+				int first = std::stoi(range.substr(0, dash));
+				int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+				for (int core = first; core <= last; core++)
+					cores.push_back(core);
+			} catch (const std::exception& e) {
+				// Ignore invalid ranges
+			}
+		}
+		return cores;
+	}
+}
+
+// Default constructor
+Executor::Executor() : thread_count(0), priority(0), numa_spread(false) { }
+
+// Constructor with a thread count, CPU cores, and priority
+Executor::Executor(int thread_count, std::vector<int> affinity, int priority)
+	: thread_count(thread_count), affinity(affinity), priority(priority), numa_spread(false) { }
+
+// Get the number of threads to use for each parallel section
+int Executor::ThreadCount() const
+{
+	if (thread_count > 0)
+		return thread_count;
+	else
+		return OPEN_MP_NUM_PROCESSORS;
+}
+
+// Get the CPU cores for the calling thread
+std::vector<int> Executor::thread_cores() const
+{
+	if (!affinity.empty() || !numa_spread)
+		return affinity;
+
+	// Pin contiguous groups of threads to each NUMA node. The group is based on the outermost
+	// parallel section, since nested sections (i.e. a reader inside a Timeline) only have a single
+	// thread each, and would otherwise pin every thread of the outer section to node 0.
+	const std::vector<std::vector<int>>& nodes = NumaNodes();
+	if (nodes.size() < 2 || omp_get_level() < 1)
+		return affinity;
+	return nodes[NumaNodeOfThread(omp_get_ancestor_thread_num(1), omp_get_team_size(1), nodes.size())];
+}
+
+// Get the NUMA node of a thread (when spreading a team of threads across the nodes)
+int Executor::NumaNodeOfThread(int thread_number, int number_of_threads, int number_of_nodes)
+{
+	if (number_of_nodes < 1)
+		return 0;
+	int node = (std::max(0, thread_number) * number_of_nodes) / std::max(1, number_of_threads);
+	return std::min(node, number_of_nodes - 1);
+}
+
+// Apply the affinity and priority to the calling thread
+void Executor::ApplyToCurrentThread() const
+{
+	// Remember the current state of this thread (restored at the end of the parallel section)
+	thread_previous_states.push_back(std::make_pair(thread_affinity, thread_priority));
+
+	// Never change the thread which started the parallel section (i.e. the GUI, Python or player thread),
+	// since it keeps running the caller's code afterwards. Only the worker threads of OpenMP are configured.
+	if (omp_get_level() == 0 || omp_get_ancestor_thread_num(1) == 0)
+		return;
+
+	std::vector<int> cores = thread_cores();
+
+	// Skip threads which already match this executor (or which have never been changed, and don't need to be)
+	if (thread_configured && thread_affinity == cores && thread_priority == priority)
+		return;
+	if (!thread_configured && cores.empty() && priority == 0)
+		return;
+
+#ifdef __linux__
+	// Remember the original cores of this thread (the first time it is changed). If they are
+	// unknown, the thread is left alone (since its cores could never be restored).
+	if (!thread_configured) {
+		if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &thread_original_affinity) != 0)
+			return;
+
+		// Also remember the original priority (which is restored at the end of the section)
+		errno = 0;
+		int original_priority = getpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid));
+		if (errno == 0) {
+			thread_priority = original_priority;
+			thread_previous_states.back().second = original_priority;
+		}
+		thread_configured = true;
+	}
+#endif
+
+	set_thread_state(cores, priority);
+}
+
+// Restore the affinity and priority of the calling thread (from before the matching ApplyToCurrentThread)
+void Executor::RestoreCurrentThread() const
+{
+	if (thread_previous_states.empty())
+		return;
+	std::pair<std::vector<int>, int> previous_state = thread_previous_states.back();
+	thread_previous_states.pop_back();
+
+	// Threads which were never changed have nothing to restore
+	if (thread_configured)
+		set_thread_state(previous_state.first, previous_state.second);
+}
+
+// Get the default executor
+Executor * Executor::Default()
+{
+	static Executor default_executor;
+	return &default_executor;
+}
+
+// Create an executor which only runs on the cores of a single NUMA node
+Executor Executor::ForNumaNode(int node, int thread_count)
+{
+	const std::vector<std::vector<int>>& nodes = NumaNodes();
+	if (node < 0 || node >= (int) nodes.size() || nodes.size() < 2)
+		// Invalid node (or no NUMA), so run on any core
+		return Executor(thread_count);
+
+	std::vector<int> cores = nodes[node];
+	if (thread_count <= 0)
+		thread_count = cores.size();
+	return Executor(thread_count, cores);
+}
+
+// Get the CPU cores of each NUMA node
+const std::vector<std::vector<int>>& Executor::NumaNodes()
+{
+	// The topology does not change, so only read it once
+	static std::vector<std::vector<int>> nodes;
+	static std::once_flag nodes_read;
+	std::call_once(nodes_read, []() {
+		// Read the online nodes (which can be sparse), and then the cores of each node
+		std::ifstream online_file("/sys/devices/system/node/online");
+		std::string online;
+		if (online_file.is_open())
+			std::getline(online_file, online);
+		for (int node : parse_cpu_list(online)) {
+			std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+			if (!cpu_list_file.is_open())
+				continue;
+			std::string cpu_list;
+			std::getline(cpu_list_file, cpu_list);
+			std::vector<int> cores = parse_cpu_list(cpu_list);
+			if (!cores.empty())
+				// Skip nodes without cores (i.e. memory-only nodes)
+				nodes.push_back(cores);
+		}
+
+		if (nodes.empty()) {
+			// No NUMA information, so all cores are on a single node
+			std::vector<int> cores;
+			for (int core = 0; core < omp_get_num_procs(); core++)
+				cores.push_back(core);
+			nodes.push_back(cores);
+		}
+	});
+	return nodes;
+}
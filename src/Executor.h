@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Header file for Executor class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPENSHOT_EXECUTOR_H
+#define OPENSHOT_EXECUTOR_H
+
+#include <vector>
+
+namespace openshot {
+
+	/**
+	 * @brief This class describes the threads used by the parallel sections of a Timeline, reader or writer.
+	 *
+	 * Instead of changing the global OpenMP state of the host process, each parallel section
+	 * requests the number of threads of its executor. Each thread can also be pinned to a list
+	 * of CPU cores (affinity), and given a scheduling priority (Linux only). For example, two
+	 * renders in the same process can each be isolated to their own cores:
+	 *
+	 * @code
+	 * openshot::Executor preview(2, {0, 1});
+	 * openshot::Executor export_render(6, {2, 3, 4, 5, 6, 7}, 10);
+	 * preview_timeline.SetExecutor(&preview);
+	 * export_timeline.SetExecutor(&export_render);
+	 * @endcode
+	 *
+	 * On NUMA systems (i.e. multi-socket render nodes), an executor can be limited to the cores of a
+	 * single NUMA node (ForNumaNode), or it can spread its threads across all nodes in groups
+	 * (NumaSpread), with each group pinned to one node. Since memory is allocated on the node of the
+	 * thread which first writes to it, the image and audio buffers of a frame stay on the node of
+	 * the thread which produced it. To keep an entire render within one node, use a separate
+	 * Timeline (and executor) per node. The node topology is read from /sys/devices/system/node.
+	 *
+	 * Executors are not owned by the objects they are assigned to, and must remain allocated
+	 * while in use. Objects without an executor use the Default() executor.
+	 */
+	class Executor {
+	private:
+		int thread_count; ///< Number of threads (0 = Settings::Instance()->OMP_THREADS, limited to the # of processors)
+		std::vector<int> affinity; ///< CPU cores which the threads are allowed to run on (empty = any)
+		int priority; ///< Scheduling priority (nice value) of the threads (0 = normal)
+		bool numa_spread; ///< Pin groups of threads to each NUMA node (when no affinity is set)
+
+		/// Get the CPU cores for the calling thread (based on the affinity, or its NUMA group)
+		std::vector<int> thread_cores() const;
+
+	public:
+		/// Default constructor (using the thread count from Settings, on any core, at normal priority)
+		Executor();
+
+		/// Constructor with a thread count, an optional list of CPU cores, and an optional priority (nice value)
+		Executor(int thread_count, std::vector<int> affinity = std::vector<int>(), int priority = 0);
+
+		/// Get the number of threads to use for each parallel section
+		int ThreadCount() const;
+
+		/// Set the number of threads to use for each parallel section (0 = use Settings)
+		void ThreadCount(int new_thread_count) { thread_count = new_thread_count; };
+
+		/// Get the CPU cores which the threads are allowed to run on (empty = any)
+		std::vector<int> Affinity() const { return affinity; };
+
+		/// Set the CPU cores which the threads are allowed to run on (empty = any)
+		void Affinity(std::vector<int> new_affinity) { affinity = new_affinity; };
+
+		/// Get the scheduling priority (nice value) of the threads
+		int Priority() const { return priority; };
+
+		/// Set the scheduling priority (nice value) of the threads (0 = normal, higher values are lower priority)
+		void Priority(int new_priority) { priority = new_priority; };
+
+		/// Get whether groups of threads are pinned to each NUMA node
+		bool NumaSpread() const { return numa_spread; };
+
+		/// Pin groups of threads to each NUMA node, i.e. with 2 nodes, the first half of the threads
+		/// of each parallel section run on node 0, and the second half on node 1 (ignored if an affinity is set)
+		void NumaSpread(bool new_numa_spread) { numa_spread = new_numa_spread; };
+
+		/// Apply the affinity and priority to the calling thread. This is called by each thread at
+		/// the start of a parallel section, and only changes the thread when needed. The thread which
+		/// started the parallel section (thread 0, i.e. the caller's own thread) is never changed.
+		/// Each call must be matched by a call to RestoreCurrentThread at the end of the section.
+		void ApplyToCurrentThread() const;
+
+		/// Restore the affinity and priority which the calling thread had before the matching call to
+		/// ApplyToCurrentThread. This is called by each thread at the end of a parallel section, so the
+		/// pooled threads of OpenMP (which also run the sections of other executors and libraries) are not
+		/// left pinned. Nested sections restore the cores and priority of their enclosing section.
+		void RestoreCurrentThread() const;
+
+		/// Get the default executor (used by objects without an executor)
+		static Executor * Default();
+
+		/// Create an executor which only runs on the cores of a single NUMA node
+		///
+		/// @param node The NUMA node number (an invalid node results in an executor which runs on any core)
+		/// @param thread_count The number of threads (0 = the number of cores of the node)
+		static Executor ForNumaNode(int node, int thread_count = 0);
+
+		/// Get the CPU cores of each NUMA node (from sysfs). Systems without NUMA information
+		/// return a single node. The topology is only read once (and shared by all callers).
+		static const std::vector<std::vector<int>>& NumaNodes();
+
+		/// Get the NUMA node of a thread, when a team of threads is spread across the nodes in
+		/// contiguous groups (i.e. with 8 threads and 2 nodes, threads 0-3 run on node 0)
+		///
+		/// @param thread_number The number of the thread in its team (of the outermost parallel section)
+		/// @param number_of_threads The number of threads in the team
+		/// @param number_of_nodes The number of NUMA nodes
+		static int NumaNodeOfThread(int thread_number, int number_of_threads, int number_of_nodes);
+	};
+
+}
+
+#endif
@@ -33,6 +33,7 @@
 
 #include "FFmpegReader.h"
 
+#include <algorithm> // for std::sort, std::unique
 #include <thread>    // for std::this_thread::sleep_for
 #include <chrono>    // for std::chrono::milliseconds
 
@@ -92,22 +93,16 @@ FFmpegReader::FFmpegReader(const std::string& path, bool inspect_reader)
 		  check_fps(false), enable_seek(true), is_open(false), seek_audio_frame_found(0), seek_video_frame_found(0),
 		  prev_samples(0), prev_pts(0), pts_total(0), pts_counter(0), is_duration_known(false), largest_frame_processed(0),
 		  current_video_frame(0), has_missing_frames(false), num_packets_since_video_frame(0), num_checks_since_final(0),
-		  packet(NULL) {
-
-	// Configure OpenMP parallelism
-	// Default number of threads per section
-	omp_set_num_threads(OPEN_MP_NUM_PROCESSORS);
-	// Allow nested parallel sections as deeply as supported
-	omp_set_max_active_levels(OPEN_MP_MAX_ACTIVE);
+		  packet(NULL), decode_mode(DECODE_FULL) {
 
 	// Initialize FFMpeg, and register all formats and codecs
 	AV_REGISTER_ALL
 	AVCODEC_REGISTER_ALL
 
 	// Init cache
-	working_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * info.fps.ToDouble() * 2, info.width, info.height, info.sample_rate, info.channels);
-	missing_frames.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
-	final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
+	working_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * info.fps.ToDouble() * 2, info.width, info.height, info.sample_rate, info.channels);
+	missing_frames.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
+	final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
 
 	// Open and Close the reader, to populate its attributes (such as height, width, etc...)
 	if (inspect_reader) {
@@ -117,6 +112,9 @@ FFmpegReader::FFmpegReader(const std::string& path, bool inspect_reader)
 }
 
 FFmpegReader::~FFmpegReader() {
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+
 	if (is_open)
 		// Auto close reader if not already done
 		Close();
@@ -229,7 +227,7 @@ void FFmpegReader::Open() {
 		// Initialize format context
 		pFormatCtx = NULL;
 		{
-			hw_de_on = (openshot::Settings::Instance()->HARDWARE_DECODER == 0 ? 0 : 1);
+			hw_de_on = (GetSettings()->HARDWARE_DECODER == 0 ? 0 : 1);
 		}
 
 		// Open video file
@@ -283,7 +281,7 @@ void FFmpegReader::Open() {
 				retry_decode_open = 0;
 
 				// Set number of threads equal to number of processors (not to exceed 16)
-				pCodecCtx->thread_count = std::min(FF_NUM_PROCESSORS, 16);
+				pCodecCtx->thread_count = std::min(FF_NUM_PROCESSORS_FOR(GetSettings()), 16);
 
 				if (pCodec == NULL) {
 					throw InvalidCodec("A valid video codec could not be found for this file.", path);
@@ -298,7 +296,7 @@ void FFmpegReader::Open() {
 					char adapter[256];
 					char *adapter_ptr = NULL;
 					int adapter_num;
-					adapter_num = openshot::Settings::Instance()->HW_DE_DEVICE_SET;
+					adapter_num = GetSettings()->HW_DE_DEVICE_SET;
 					fprintf(stderr, "Hardware decoding device number: %d\n", adapter_num);
 
 					// Set hardware pix format (callback)
@@ -308,7 +306,7 @@ void FFmpegReader::Open() {
 #if defined(__linux__)
 						snprintf(adapter,sizeof(adapter),"/dev/dri/renderD%d", adapter_num+128);
 						adapter_ptr = adapter;
-						i_decoder_hw = openshot::Settings::Instance()->HARDWARE_DECODER;
+						i_decoder_hw = GetSettings()->HARDWARE_DECODER;
 						switch (i_decoder_hw) {
 								case 1:
 									hw_de_av_device_type = AV_HWDEVICE_TYPE_VAAPI;
@@ -329,7 +327,7 @@ void FFmpegReader::Open() {
 
 #elif defined(_WIN32)
 						adapter_ptr = NULL;
-						i_decoder_hw = openshot::Settings::Instance()->HARDWARE_DECODER;
+						i_decoder_hw = GetSettings()->HARDWARE_DECODER;
 						switch (i_decoder_hw) {
 							case 2:
 								hw_de_av_device_type = AV_HWDEVICE_TYPE_CUDA;
@@ -349,7 +347,7 @@ void FFmpegReader::Open() {
 						}
 #elif defined(__APPLE__)
 						adapter_ptr = NULL;
-						i_decoder_hw = openshot::Settings::Instance()->HARDWARE_DECODER;
+						i_decoder_hw = GetSettings()->HARDWARE_DECODER;
 						switch (i_decoder_hw) {
 							case 5:
 								hw_de_av_device_type =  AV_HWDEVICE_TYPE_VIDEOTOOLBOX;
@@ -422,10 +420,19 @@ void FFmpegReader::Open() {
 				}
 #endif // HAVE_HW_ACCEL
 
+#if IS_FFMPEG_3_2
+				// Decode at a lower resolution (which can only be set before the codec is opened)
+				if (GetSettings()->DECODE_MODE == DECODE_LOWRES && !(hw_de_on && hw_de_supported))
+					pCodecCtx->lowres = std::min(1, (int) pCodec->max_lowres);
+#endif
+
 				// Open video codec
 				if (avcodec_open2(pCodecCtx, pCodec, &opts) < 0)
 					throw InvalidCodec("A video codec was found, but could not be opened.", path);
 
+				// New codec contexts decode at full quality (until UpdateDecodeMode)
+				decode_mode = DECODE_FULL;
+
 #if HAVE_HW_ACCEL
 				if (hw_de_on && hw_de_supported) {
 					AVHWFramesConstraints *constraints = NULL;
@@ -464,9 +471,9 @@ void FFmpegReader::Open() {
 					else {
 						int max_h, max_w;
 						//max_h = ((getenv( "LIMIT_HEIGHT_MAX" )==NULL) ? MAX_SUPPORTED_HEIGHT : atoi(getenv( "LIMIT_HEIGHT_MAX" )));
-						max_h = openshot::Settings::Instance()->DE_LIMIT_HEIGHT_MAX;
+						max_h = GetSettings()->DE_LIMIT_HEIGHT_MAX;
 						//max_w = ((getenv( "LIMIT_WIDTH_MAX" )==NULL) ? MAX_SUPPORTED_WIDTH : atoi(getenv( "LIMIT_WIDTH_MAX" )));
-						max_w = openshot::Settings::Instance()->DE_LIMIT_WIDTH_MAX;
+						max_w = GetSettings()->DE_LIMIT_WIDTH_MAX;
 						ZmqLogger::Instance()->AppendDebugMethod("Constraints could not be found using default limit\n");
 						//cerr << "Constraints could not be found using default limit\n";
 						if (pCodecCtx->coded_width < 0  	||
@@ -518,7 +525,7 @@ void FFmpegReader::Open() {
 			aCodecCtx = AV_GET_CODEC_CONTEXT(aStream, aCodec);
 
 			// Set number of threads equal to number of processors (not to exceed 16)
-			aCodecCtx->thread_count = std::min(FF_NUM_PROCESSORS, 16);
+			aCodecCtx->thread_count = std::min(FF_NUM_PROCESSORS_FOR(GetSettings()), 16);
 
 			if (aCodec == NULL) {
 				throw InvalidCodec("A valid audio codec could not be found for this file.", path);
@@ -552,9 +559,9 @@ void FFmpegReader::Open() {
 		previous_packet_location.sample_start = 0;
 
 		// Adjust cache size based on size of frame and audio
-		working_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * info.fps.ToDouble() * 2, info.width, info.height, info.sample_rate, info.channels);
-		missing_frames.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
-		final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
+		working_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * info.fps.ToDouble() * 2, info.width, info.height, info.sample_rate, info.channels);
+		missing_frames.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
+		final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
 
 		// Mark as "open"
 		is_open = true;
@@ -562,6 +569,10 @@ void FFmpegReader::Open() {
 }
 
 void FFmpegReader::Close() {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open) {
 		// Mark as "closed"
@@ -818,6 +829,9 @@ std::shared_ptr<Frame> FFmpegReader::GetFrame(int64_t requested_frame) {
 	// Debug output
 	ZmqLogger::Instance()->AppendDebugMethod("FFmpegReader::GetFrame", "requested_frame", requested_frame, "last_frame", last_frame);
 
+	// Drop the frames which will not be requested again (if streaming)
+	release_streamed_frames(&final_cache, requested_frame);
+
 	// Check the cache for this frame
 	std::shared_ptr<Frame> frame = final_cache.GetFrame(requested_frame);
 	if (frame) {
@@ -827,49 +841,93 @@ std::shared_ptr<Frame> FFmpegReader::GetFrame(int64_t requested_frame) {
 		// Return the cached frame
 		return frame;
 	} else {
-#pragma omp critical (ReadStream)
-		{
-			// Check the cache a 2nd time (due to a potential previous lock)
-			frame = final_cache.GetFrame(requested_frame);
-			if (frame) {
-				// Debug output
-				ZmqLogger::Instance()->AppendDebugMethod("FFmpegReader::GetFrame", "returned cached frame on 2nd look", requested_frame);
+		const GenericScopedLock<CriticalSection> lock(readStreamCriticalSection);
+		frame = ReadFrame(requested_frame);
+		return frame;
+	}
+}
 
-				// Return the cached frame
-			} else {
-				// Frame is not in cache
-				// Reset seek count
-				seek_count = 0;
-
-				// Check for first frame (always need to get frame 1 before other frames, to correctly calculate offsets)
-				if (last_frame == 0 && requested_frame != 1)
-					// Get first frame
-					ReadStream(1);
-
-				// Are we within X frames of the requested frame?
-				int64_t diff = requested_frame - last_frame;
-				if (diff >= 1 && diff <= 20) {
-					// Continue walking the stream
-					frame = ReadStream(requested_frame);
-				} else {
-					// Greater than 30 frames away, or backwards, we need to seek to the nearest key frame
-					if (enable_seek)
-						// Only seek if enabled
-						Seek(requested_frame);
-
-					else if (!enable_seek && diff < 0) {
-						// Start over, since we can't seek, and the requested frame is smaller than our position
-						Close();
-						Open();
-					}
+// Get a range of sequential frames (in a single pass of the stream)
+std::vector<std::shared_ptr<Frame>> FFmpegReader::GetFrames(int64_t start, int64_t count) {
+	// Check for open reader (or throw exception)
+	if (!is_open)
+		throw ReaderClosed("The FFmpegReader is closed.  Call Open() before calling this method.", path);
+	if (info.has_video && info.video_length == 0)
+		// Invalid duration of video file
+		throw InvalidFile("Could not detect the duration of the video or audio stream.", path);
 
-					// Then continue walking the stream
-					frame = ReadStream(requested_frame);
-				}
-			}
-		} //omp critical
+	std::vector<std::shared_ptr<Frame>> frames;
+	if (count <= 0)
+		return frames;
+	frames.reserve(count);
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("FFmpegReader::GetFrames", "start", start, "count", count, "last_frame", last_frame);
+
+	// Drop the frames which will not be requested again (if streaming)
+	release_streamed_frames(&final_cache, start);
+
+	// Lock the stream once for the entire range. Since the frames are sequential, only the
+	// first missing frame can require a seek, and the rest are decoded by walking the stream.
+	const GenericScopedLock<CriticalSection> lock(readStreamCriticalSection);
+	for (int64_t number = start; number < start + count; number++) {
+		// Adjust for a requested frame that is too small or too large
+		int64_t requested_frame = number;
+		if (requested_frame < 1)
+			requested_frame = 1;
+		if (requested_frame > info.video_length && is_duration_known)
+			requested_frame = info.video_length;
+
+		std::shared_ptr<Frame> frame = final_cache.GetFrame(requested_frame);
+		if (!frame)
+			frame = ReadFrame(requested_frame);
+		frames.push_back(frame);
+	}
+
+	return frames;
+}
+
+// Decode a frame which is not in the final cache (the caller holds the ReadStream lock)
+std::shared_ptr<Frame> FFmpegReader::ReadFrame(int64_t requested_frame) {
+	// Check the cache a 2nd time (due to a potential previous lock)
+	std::shared_ptr<Frame> frame = final_cache.GetFrame(requested_frame);
+	if (frame) {
+		// Debug output
+		ZmqLogger::Instance()->AppendDebugMethod("FFmpegReader::GetFrame", "returned cached frame on 2nd look", requested_frame);
+
+		// Return the cached frame
 		return frame;
 	}
+
+	// Frame is not in cache
+	// Reset seek count
+	seek_count = 0;
+
+	// Check for first frame (always need to get frame 1 before other frames, to correctly calculate offsets)
+	if (last_frame == 0 && requested_frame != 1)
+		// Get first frame
+		ReadStream(1);
+
+	// Are we within X frames of the requested frame?
+	int64_t diff = requested_frame - last_frame;
+	if (diff >= 1 && diff <= 20) {
+		// Continue walking the stream
+		return ReadStream(requested_frame);
+	}
+
+	// Greater than 30 frames away, or backwards, we need to seek to the nearest key frame
+	if (enable_seek)
+		// Only seek if enabled
+		Seek(requested_frame);
+
+	else if (!enable_seek && diff < 0) {
+		// Start over, since we can't seek, and the requested frame is smaller than our position
+		Close();
+		Open();
+	}
+
+	// Then continue walking the stream
+	return ReadStream(requested_frame);
 }
 
 // Read the stream until we find the requested Frame
@@ -880,16 +938,21 @@ std::shared_ptr<Frame> FFmpegReader::ReadStream(int64_t requested_frame) {
 	bool frame_finished = false;
 	int packet_error = -1;
 
+	// Use the threads of this reader's executor
+	Executor* reader_executor = GetExecutor();
+
 	// Minimum number of packets to process (for performance reasons)
 	int packets_processed = 0;
-	int minimum_packets = OPEN_MP_NUM_PROCESSORS;
+	int minimum_packets = reader_executor->ThreadCount();
 	int max_packets = 4096;
 
 	// Debug output
-	ZmqLogger::Instance()->AppendDebugMethod("FFmpegReader::ReadStream", "requested_frame", requested_frame, "OPEN_MP_NUM_PROCESSORS", OPEN_MP_NUM_PROCESSORS);
+	ZmqLogger::Instance()->AppendDebugMethod("FFmpegReader::ReadStream", "requested_frame", requested_frame, "OPEN_MP_NUM_PROCESSORS", OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()));
 
-#pragma omp parallel
+#pragma omp parallel num_threads(reader_executor->ThreadCount())
 	{
+		reader_executor->ApplyToCurrentThread();
+
 #pragma omp single
 		{
 			// Loop through the stream until the correct frame is found
@@ -929,10 +992,10 @@ std::shared_ptr<Frame> FFmpegReader::ReadStream(int64_t requested_frame) {
 					num_packets_since_video_frame = 0;
 
 					// Check the status of a seek (if any)
-					if (is_seeking)
-#pragma omp critical (openshot_seek)
+					if (is_seeking) {
+						const GenericScopedLock<CriticalSection> lock(seekCriticalSection);
 						check_seek = CheckSeek(true);
-					else
+					} else
 						check_seek = false;
 
 					if (check_seek) {
@@ -956,7 +1019,7 @@ std::shared_ptr<Frame> FFmpegReader::ReadStream(int64_t requested_frame) {
 						// Process Video Packet
 						ProcessVideoPacket(requested_frame);
 
-						if (openshot::Settings::Instance()->WAIT_FOR_VIDEO_PROCESSING_TASK) {
+						if (GetSettings()->WAIT_FOR_VIDEO_PROCESSING_TASK) {
 							// Wait on each OMP task to complete before moving on to the next one. This slows
 							// down processing considerably, but might be more stable on some systems.
 #pragma omp taskwait
@@ -970,10 +1033,10 @@ std::shared_ptr<Frame> FFmpegReader::ReadStream(int64_t requested_frame) {
 					num_packets_since_video_frame++;
 
 					// Check the status of a seek (if any)
-					if (is_seeking)
-#pragma omp critical (openshot_seek)
+					if (is_seeking) {
+						const GenericScopedLock<CriticalSection> lock(seekCriticalSection);
 						check_seek = CheckSeek(false);
-					else
+					} else
 						check_seek = false;
 
 					if (check_seek) {
@@ -1016,6 +1079,8 @@ std::shared_ptr<Frame> FFmpegReader::ReadStream(int64_t requested_frame) {
 
 		} // end omp single
 
+		// Restore the previous cores and priority of this thread
+		reader_executor->RestoreCurrentThread();
 	} // end omp parallel
 
 	// Debug output
@@ -1052,8 +1117,8 @@ std::shared_ptr<Frame> FFmpegReader::ReadStream(int64_t requested_frame) {
 int FFmpegReader::GetNextPacket() {
 	int found_packet = 0;
 	AVPacket *next_packet;
-#pragma omp critical(getnextpacket)
 	{
+		const GenericScopedLock<CriticalSection> lock(packetCriticalSection);
 		next_packet = new AVPacket();
 		found_packet = av_read_frame(pFormatCtx, next_packet);
 
@@ -1082,8 +1147,12 @@ bool FFmpegReader::GetAVFrame() {
 
 	// Decode video frame
 	AVFrame *next_frame = AV_ALLOCATE_FRAME();
-#pragma omp critical (packet_cache)
 	{
+		const GenericScopedLock<CriticalSection> lock(decodeCriticalSection);
+
+		// Follow the decode mode of the settings (which the player changes during playback)
+		UpdateDecodeMode();
+
 #if IS_FFMPEG_3_2
 		frameFinished = 0;
 
@@ -1138,11 +1207,14 @@ bool FFmpegReader::GetAVFrame() {
 
 				// TODO also handle possible further frames
 				// Use only the first frame like avcodec_decode_video2
+				// (the decoded size is smaller than info.width x info.height when decoding in lowres)
 				if (frameFinished == 0 ) {
 					frameFinished = 1;
-					av_image_alloc(pFrame->data, pFrame->linesize, info.width, info.height, (AVPixelFormat)(pStream->codecpar->format), 1);
+					pFrame->width = next_frame->width;
+					pFrame->height = next_frame->height;
+					av_image_alloc(pFrame->data, pFrame->linesize, pFrame->width, pFrame->height, (AVPixelFormat)(pStream->codecpar->format), 1);
 					av_image_copy(pFrame->data, pFrame->linesize, (const uint8_t**)next_frame->data, next_frame->linesize,
-												(AVPixelFormat)(pStream->codecpar->format), info.width, info.height);
+												(AVPixelFormat)(pStream->codecpar->format), pFrame->width, pFrame->height);
 				}
 			}
 	#if HAVE_HW_ACCEL
@@ -1164,6 +1236,8 @@ bool FFmpegReader::GetAVFrame() {
 			avpicture_alloc((AVPicture *) pFrame, pCodecCtx->pix_fmt, info.width, info.height);
 			av_picture_copy((AVPicture *) pFrame, (AVPicture *) next_frame, pCodecCtx->pix_fmt, info.width,
 							info.height);
+			pFrame->width = info.width;
+			pFrame->height = info.height;
 		}
 #endif // IS_FFMPEG_3_2
 	}
@@ -1280,15 +1354,17 @@ void FFmpegReader::ProcessVideoPacket(int64_t requested_frame) {
 			}
 			if (parent->scale == SCALE_FIT || parent->scale == SCALE_STRETCH) {
 				// Best fit or Stretch scaling (based on max timeline size * scaling keyframes)
-				float max_scale_x = parent->scale_x.GetMaxPoint().co.Y;
-				float max_scale_y = parent->scale_y.GetMaxPoint().co.Y;
+				QSizeF max_scale = parent->GetMaxScale();
+				float max_scale_x = max_scale.width();
+				float max_scale_y = max_scale.height();
 				max_width = std::max(float(max_width), max_width * max_scale_x);
 				max_height = std::max(float(max_height), max_height * max_scale_y);
 
 			} else if (parent->scale == SCALE_CROP) {
 				// Cropping scale mode (based on max timeline size * cropped size * scaling keyframes)
-				float max_scale_x = parent->scale_x.GetMaxPoint().co.Y;
-				float max_scale_y = parent->scale_y.GetMaxPoint().co.Y;
+				QSizeF max_scale = parent->GetMaxScale();
+				float max_scale_x = max_scale.width();
+				float max_scale_y = max_scale.height();
 				QSize width_size(max_width * max_scale_x,
 								 round(max_width / (float(info.width) / float(info.height))));
 				QSize height_size(round(max_height / (float(info.height) / float(info.width))),
@@ -1307,10 +1383,16 @@ void FFmpegReader::ProcessVideoPacket(int64_t requested_frame) {
 				max_width = info.width;
 				max_height = info.height;
 			}
+		} else if (settings && settings->MAX_WIDTH > 0 && settings->MAX_HEIGHT > 0) {
+			// Not on a timeline, limit the image to the max size of this reader's own settings (i.e. for
+			// thumbnails). The global settings never limit a standalone reader.
+			max_width = settings->MAX_WIDTH;
+			max_height = settings->MAX_HEIGHT;
 		}
 
 		// Determine if image needs to be scaled (for performance reasons)
-		int original_height = height;
+		int original_width = my_frame->width;
+		int original_height = my_frame->height;
 		if (max_width != 0 && max_height != 0 && max_width < width && max_height < height) {
 			// Override width and height (but maintain aspect ratio)
 			float ratio = float(width) / float(height);
@@ -1331,17 +1413,16 @@ void FFmpegReader::ProcessVideoPacket(int64_t requested_frame) {
 		// Determine required buffer size and allocate buffer
 		numBytes = AV_GET_IMAGE_SIZE(PIX_FMT_RGBA, width, height);
 
-#pragma omp critical (video_buffer)
 		buffer = (uint8_t *) av_malloc(numBytes * sizeof(uint8_t));
 
 		// Copy picture data from one AVFrame (or AVPicture) to another one.
 		AV_COPY_PICTURE_DATA(pFrameRGB, buffer, PIX_FMT_RGBA, width, height);
 
 		int scale_mode = SWS_FAST_BILINEAR;
-		if (openshot::Settings::Instance()->HIGH_QUALITY_SCALING) {
+		if (GetSettings()->HIGH_QUALITY_SCALING) {
 			scale_mode = SWS_BICUBIC;
 		}
-		SwsContext *img_convert_ctx = sws_getContext(info.width, info.height, AV_GET_CODEC_PIXEL_FORMAT(pStream, pCodecCtx), width,
+		SwsContext *img_convert_ctx = sws_getContext(original_width, original_height, AV_GET_CODEC_PIXEL_FORMAT(pStream, pCodecCtx), width,
 															  height, PIX_FMT_RGBA, scale_mode, NULL, NULL, NULL);
 
 		// Resize / Convert to RGB
@@ -1358,8 +1439,10 @@ void FFmpegReader::ProcessVideoPacket(int64_t requested_frame) {
 		working_cache.Add(f);
 
 		// Keep track of last last_video_frame
-#pragma omp critical (video_buffer)
-		last_video_frame = f;
+		{
+			const GenericScopedLock<CriticalSection> lock(processingCriticalSection);
+			last_video_frame = f;
+		}
 
 		// Free the RGB image
 		av_free(buffer);
@@ -1409,8 +1492,8 @@ void FFmpegReader::ProcessAudioPacket(int64_t requested_frame, int64_t target_fr
 	int packet_samples = 0;
 	int data_size = 0;
 
-#pragma omp critical (ProcessAudioPacket)
 	{
+		const GenericScopedLock<CriticalSection> lock(audioDecodeCriticalSection);
 #if IS_FFMPEG_3_2
 		int ret = 0;
 		frame_finished = 1;
@@ -1737,7 +1820,7 @@ void FFmpegReader::Seek(int64_t requested_frame) {
 	seek_count++;
 
 	// If seeking near frame 1, we need to close and re-open the file (this is more reliable than seeking)
-	int buffer_amount = std::max(OPEN_MP_NUM_PROCESSORS, 8);
+	int buffer_amount = std::max(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()), 8);
 	if (requested_frame - buffer_amount < 20) {
 		// Close and re-open file (basically seeking to frame 1)
 		Close();
@@ -1841,6 +1924,85 @@ int64_t FFmpegReader::GetVideoPTS() {
 	return current_pts;
 }
 
+// Get the frame numbers of the video keyframes listed in the index of the container
+std::vector<int64_t> FFmpegReader::GetKeyframes() {
+	// Check for open reader (or throw exception)
+	if (!is_open)
+		throw ReaderClosed("The FFmpegReader is closed.  Call Open() before calling this method.", path);
+
+	std::vector<int64_t> keyframes;
+	if (!info.has_video)
+		return keyframes;
+
+	// Index timestamps start at the start time of the stream
+	int64_t start_time = (pStream->start_time != AV_NOPTS_VALUE) ? pStream->start_time : 0;
+
+#if (LIBAVFORMAT_VERSION_MAJOR > 58) || (LIBAVFORMAT_VERSION_MAJOR == 58 && LIBAVFORMAT_VERSION_MINOR >= 76)
+	int index_count = avformat_index_get_entries_count(pStream);
+#else
+	int index_count = pStream->nb_index_entries;
+#endif
+	for (int index = 0; index < index_count; index++) {
+#if (LIBAVFORMAT_VERSION_MAJOR > 58) || (LIBAVFORMAT_VERSION_MAJOR == 58 && LIBAVFORMAT_VERSION_MINOR >= 76)
+		const AVIndexEntry *entry = avformat_index_get_entry(pStream, index);
+#else
+		const AVIndexEntry *entry = &pStream->index_entries[index];
+#endif
+		if (!entry || !(entry->flags & AVINDEX_KEYFRAME))
+			continue;
+
+		// Convert the timestamp into a frame number
+		double seconds = double(entry->timestamp - start_time) * info.video_timebase.ToDouble();
+		int64_t frame = round(seconds * info.fps.ToDouble()) + 1;
+		if (frame >= 1 && frame <= info.video_length)
+			keyframes.push_back(frame);
+	}
+
+	// Sort and remove duplicates
+	std::sort(keyframes.begin(), keyframes.end());
+	keyframes.erase(std::unique(keyframes.begin(), keyframes.end()), keyframes.end());
+	return keyframes;
+}
+
+// Apply the decode mode of the settings to the video codec context (if it has changed)
+void FFmpegReader::UpdateDecodeMode() {
+	DecodeMode new_mode = GetSettings()->DECODE_MODE;
+	if (new_mode == decode_mode || !pCodecCtx)
+		return;
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("FFmpegReader::UpdateDecodeMode", "decode_mode", decode_mode, "new_mode", new_mode);
+
+	// Start from full quality decoding
+	pCodecCtx->skip_loop_filter = AVDISCARD_DEFAULT;
+	pCodecCtx->skip_idct = AVDISCARD_DEFAULT;
+	pCodecCtx->skip_frame = AVDISCARD_DEFAULT;
+#if (LIBAVCODEC_VERSION_MAJOR >= 57)
+	pCodecCtx->flags2 &= ~AV_CODEC_FLAG2_FAST;
+#else
+	pCodecCtx->flags2 &= ~CODEC_FLAG2_FAST;
+#endif
+
+	if (new_mode != DECODE_FULL) {
+		// Skip the loop filter, and the IDCT refinements of frames which nothing references
+		pCodecCtx->skip_loop_filter = AVDISCARD_ALL;
+		pCodecCtx->skip_idct = AVDISCARD_NONREF;
+#if (LIBAVCODEC_VERSION_MAJOR >= 57)
+		pCodecCtx->flags2 |= AV_CODEC_FLAG2_FAST;
+#else
+		pCodecCtx->flags2 |= CODEC_FLAG2_FAST;
+#endif
+	}
+
+	// Skip entire frames (the missing frame logic repeats the previous decoded image)
+	if (new_mode == DECODE_REFERENCE_ONLY)
+		pCodecCtx->skip_frame = AVDISCARD_NONREF;
+	else if (new_mode == DECODE_KEYFRAMES_ONLY)
+		pCodecCtx->skip_frame = AVDISCARD_NONKEY;
+
+	decode_mode = new_mode;
+}
+
 // Update PTS Offset (if any)
 void FFmpegReader::UpdatePTSOffset(bool is_video) {
 	// Determine the offset between the PTS and Frame number (only for 1st frame)
@@ -2184,7 +2346,7 @@ void FFmpegReader::CheckWorkingFrames(bool end_of_stream, int64_t requested_fram
 			break;
 
 		// Remove frames which are too old
-		if (f && f->number < (requested_frame - (OPEN_MP_NUM_PROCESSORS * 2))) {
+		if (f && f->number < (requested_frame - (OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2))) {
 			working_cache.Remove(f->number);
 		}
 
@@ -2392,8 +2554,8 @@ void FFmpegReader::RemoveAVFrame(AVFrame *remove_frame) {
 	// Remove pFrame (if exists)
 	if (remove_frame) {
 		// Free memory
-#pragma omp critical (packet_cache)
 		{
+			const GenericScopedLock<CriticalSection> lock(decodeCriticalSection);
 			av_freep(&remove_frame->data[0]);
 #ifndef WIN32
 			AV_FREE_FRAME(&remove_frame);
@@ -110,6 +110,13 @@ namespace openshot {
 		bool check_fps;
 		bool has_missing_frames;
 
+		// Section locks (for this reader only, so separate readers never block each other)
+		juce::CriticalSection readStreamCriticalSection; ///< Lock for reading the stream (seeking and walking packets)
+		juce::CriticalSection seekCriticalSection; ///< Lock for checking the status of a seek
+		juce::CriticalSection packetCriticalSection; ///< Lock for reading the next packet
+		juce::CriticalSection decodeCriticalSection; ///< Lock for decoding video packets (and freeing decoded frames)
+		juce::CriticalSection audioDecodeCriticalSection; ///< Lock for decoding audio packets
+
 		CacheMemory working_cache;
 		CacheMemory missing_frames;
 		std::map<int64_t, int64_t> processing_video_frames;
@@ -145,6 +152,7 @@ namespace openshot {
 		int64_t last_frame;
 		int64_t largest_frame_processed;
 		int64_t current_video_frame;    // can't reliably use PTS of video to determine this
+		openshot::DecodeMode decode_mode; ///< The decode mode applied to the video codec context
 
 		int hw_de_supported = 0;    // Is set by FFmpegReader
 #if HAVE_HW_ACCEL
@@ -207,6 +215,9 @@ namespace openshot {
 		/// Read the stream until we find the requested Frame
 		std::shared_ptr<openshot::Frame> ReadStream(int64_t requested_frame);
 
+		/// Decode a frame which is not in the final cache (seeking if needed). The caller must hold the ReadStream lock.
+		std::shared_ptr<openshot::Frame> ReadFrame(int64_t requested_frame);
+
 		/// Remove AVFrame from cache (and deallocate its memory)
 		void RemoveAVFrame(AVFrame *);
 
@@ -216,6 +227,9 @@ namespace openshot {
 		/// Seek to a specific Frame.  This is not always frame accurate, it's more of an estimation on many codecs.
 		void Seek(int64_t requested_frame);
 
+		/// Apply the decode mode of the settings to the video codec context (if it has changed)
+		void UpdateDecodeMode();
+
 		/// Update PTS Offset (if any)
 		void UpdatePTSOffset(bool is_video);
 
@@ -256,6 +270,18 @@ namespace openshot {
 		/// @param requested_frame	The frame number that is requested.
 		std::shared_ptr<openshot::Frame> GetFrame(int64_t requested_frame) override;
 
+		/// Get a range of sequential frames, decoding the whole range in a single pass of the stream
+		/// (only seeking once, if needed).
+		///
+		/// @returns The requested frames of video (in order)
+		/// @param start The first frame number that is requested.
+		/// @param count The number of frames requested.
+		std::vector<std::shared_ptr<openshot::Frame>> GetFrames(int64_t start, int64_t count) override;
+
+		/// Get the frame numbers of the video keyframes listed in the index of the container (sorted). Containers
+		/// without an index (or with an incomplete one) return fewer (or no) keyframes.
+		std::vector<int64_t> GetKeyframes();
+
 		/// Determine if reader is open or closed
 		bool IsOpen() override { return is_open; };
 
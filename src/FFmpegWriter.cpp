@@ -32,6 +32,7 @@
  */
 
 #include "FFmpegWriter.h"
+#include "Timeline.h"
 
 #include <iostream>
 
@@ -97,12 +98,6 @@ FFmpegWriter::FFmpegWriter(const std::string& path) :
 	info.has_audio = false;
 	info.has_video = false;
 
-	// Configure OpenMP parallelism
-	// Default number of threads per block
-	omp_set_num_threads(OPEN_MP_NUM_PROCESSORS);
-	// Allow nested parallel sections as deeply as supported
-	omp_set_max_active_levels(OPEN_MP_MAX_ACTIVE);
-
 	// Initialize FFMpeg, and register all formats and codecs
 	AV_REGISTER_ALL
 
@@ -727,8 +722,13 @@ void FFmpegWriter::write_queued_frames() {
 	// Create blank exception
 	bool has_error_encoding_video = false;
 
-#pragma omp parallel
+	// Use the threads of this writer's executor
+	Executor* writer_executor = GetExecutor();
+
+#pragma omp parallel num_threads(writer_executor->ThreadCount())
 	{
+		writer_executor->ApplyToCurrentThread();
+
 #pragma omp single
 		{
 			// Process all audio frames (in a separate thread)
@@ -805,6 +805,8 @@ void FFmpegWriter::write_queued_frames() {
 
 		} // end omp single
 
+		// Restore the previous cores and priority of this thread
+		writer_executor->RestoreCurrentThread();
 	} // end omp parallel
 
 	// Raise exception from main thread
@@ -816,14 +818,39 @@ void FFmpegWriter::write_queued_frames() {
 void FFmpegWriter::WriteFrame(ReaderBase *reader, int64_t start, int64_t length) {
 	ZmqLogger::Instance()->AppendDebugMethod("FFmpegWriter::WriteFrame (from Reader)", "start", start, "length", length);
 
-	// Loop through each frame (and encoded it)
-	for (int64_t number = start; number <= length; number++) {
-		// Get the frame
-		std::shared_ptr<Frame> f = reader->GetFrame(number);
-
-		// Encode frame
-		WriteFrame(f);
+	// Each frame is requested once, in order, so the caches of the reader (and its clips and
+	// readers) only keep a short window of frames, instead of every frame of the export
+	bool was_streaming = reader->GetStreaming();
+	reader->SetStreaming(true);
+
+	// Precompute the keyframe values of the clips of a timeline (for the frames being written)
+	Timeline* timeline = dynamic_cast<Timeline*>(reader);
+	if (timeline)
+		timeline->BakeClips(start, start + length - 1);
+
+	try {
+		// Loop through each batch of frames (the size of the spooled cache), so the reader
+		// can decode / render each batch in a single pass
+		for (int64_t number = start; number <= length; number += cache_size) {
+			// Get the frames
+			int64_t batch_size = std::min((int64_t) cache_size, length - number + 1);
+			std::vector<std::shared_ptr<Frame>> frames = reader->GetFrames(number, batch_size);
+
+			// Encode frames
+			for (auto f : frames)
+				WriteFrame(f);
+		}
+	} catch (...) {
+		// Restore the previous mode (before passing on the error)
+		reader->SetStreaming(was_streaming);
+		if (timeline)
+			timeline->ClearBakedClips();
+		throw;
 	}
+
+	reader->SetStreaming(was_streaming);
+	if (timeline)
+		timeline->ClearBakedClips();
 }
 
 // Write the file trailer (after all frames are written)
@@ -880,8 +907,8 @@ void FFmpegWriter::flush_encoders() {
 			int error_code = 0;
 
 #if IS_FFMPEG_3_2
-			#pragma omp critical (write_video_packet)
 			{
+				const GenericScopedLock<CriticalSection> lock(writeVideoCriticalSection);
 				// Encode video packet (latest version of FFmpeg)
 				error_code = avcodec_send_frame(video_codec_ctx, NULL);
 				got_packet = 0;
@@ -1045,6 +1072,10 @@ void FFmpegWriter::Close() {
 	if (image_rescalers.size() > 0)
 		RemoveScalers();
 
+	// Forget the converted solid color frame
+	solid_video_key.clear();
+	solid_video_data.clear();
+
 	if (!(fmt->flags & AVFMT_NOFILE)) {
 		/* close the output file */
 		avio_close(oc->pb);
@@ -1354,7 +1385,7 @@ void FFmpegWriter::open_audio(AVFormatContext *oc, AVStream *st) {
 	AV_GET_CODEC_FROM_STREAM(st, audio_codec_ctx)
 
 	// Set number of threads equal to number of processors (not to exceed 16)
-	audio_codec_ctx->thread_count = std::min(FF_NUM_PROCESSORS, 16);
+	audio_codec_ctx->thread_count = std::min(FF_NUM_PROCESSORS_FOR(GetSettings()), 16);
 
 	// Find the audio encoder
 	codec = avcodec_find_encoder_by_name(info.acodec.c_str());
@@ -1425,7 +1456,7 @@ void FFmpegWriter::open_video(AVFormatContext *oc, AVStream *st) {
 	AV_GET_CODEC_FROM_STREAM(st, video_codec_ctx)
 
 	// Set number of threads equal to number of processors (not to exceed 16)
-	video_codec_ctx->thread_count = std::min(FF_NUM_PROCESSORS, 16);
+	video_codec_ctx->thread_count = std::min(FF_NUM_PROCESSORS_FOR(GetSettings()), 16);
 
 #if HAVE_HW_ACCEL
 	if (hw_en_on && hw_en_supported) {
@@ -1434,7 +1465,7 @@ void FFmpegWriter::open_video(AVFormatContext *oc, AVStream *st) {
 		char *adapter_ptr = NULL;
 		int adapter_num;
 		// Use the hw device given in the environment variable HW_EN_DEVICE_SET or the default if not set
-		adapter_num = openshot::Settings::Instance()->HW_EN_DEVICE_SET;
+		adapter_num = GetSettings()->HW_EN_DEVICE_SET;
 		std::clog << "Encoding Device Nr: " << adapter_num << "\n";
 		if (adapter_num < 3 && adapter_num >=0) {
 #if defined(__linux__)
@@ -2013,11 +2044,14 @@ void FFmpegWriter::process_video_packet(std::shared_ptr<Frame> frame) {
 		AVFrame *frame_source = NULL;
 		const uchar *pixels = NULL;
 
-		// Get a list of pixels from source image
-		pixels = frame->GetPixels();
+		// Solid color frames (i.e. gaps on a timeline) have no pixels yet, and are only converted once per color
+		std::string solid_key;
+		if (frame->IsSolidColor()) {
+			std::stringstream solid_key_str;
+			solid_key_str << frame->SolidColor() << " " << source_image_width << "x" << source_image_height;
+			solid_key = solid_key_str.str();
+		}
 
-		// Init AVFrame for source image & final (converted image)
-		frame_source = allocate_avframe(PIX_FMT_RGBA, source_image_width, source_image_height, &bytes_source, (uint8_t *) pixels);
 #if IS_FFMPEG_3_2
 		AVFrame *frame_final;
 	#if HAVE_HW_ACCEL
@@ -2035,20 +2069,47 @@ void FFmpegWriter::process_video_packet(std::shared_ptr<Frame> frame) {
 		AVFrame *frame_final = allocate_avframe(video_codec_ctx->pix_fmt, info.width, info.height, &bytes_final, NULL);
 #endif // IS_FFMPEG_3_2
 
-		// Fill with data
-		AV_COPY_PICTURE_DATA(frame_source, (uint8_t *) pixels, PIX_FMT_RGBA, source_image_width, source_image_height);
-		ZmqLogger::Instance()->AppendDebugMethod("FFmpegWriter::process_video_packet", "frame->number", frame->number, "bytes_source", bytes_source, "bytes_final", bytes_final);
+		// Reuse the converted pixels of the previous solid color frame (if the same color and size)
+		bool is_converted = false;
+		if (!solid_key.empty()) {
+			const GenericScopedLock<CriticalSection> lock(avFramesCriticalSection);
+			if (solid_key == solid_video_key && (int) solid_video_data.size() == bytes_final) {
+				memcpy(frame_final->data[0], solid_video_data.data(), bytes_final);
+				is_converted = true;
+			}
+		}
+
+		if (!is_converted) {
+			// Get a list of pixels from source image
+			pixels = frame->GetPixels();
 
-		// Resize & convert pixel format
-		sws_scale(scaler, frame_source->data, frame_source->linesize, 0,
-		          source_image_height, frame_final->data, frame_final->linesize);
+			// Init AVFrame for source image
+			frame_source = allocate_avframe(PIX_FMT_RGBA, source_image_width, source_image_height, &bytes_source, (uint8_t *) pixels);
 
-		// Add resized AVFrame to av_frames map
-#pragma omp critical (av_frames_section)
-		add_avframe(frame, frame_final);
+			// Fill with data
+			AV_COPY_PICTURE_DATA(frame_source, (uint8_t *) pixels, PIX_FMT_RGBA, source_image_width, source_image_height);
+			ZmqLogger::Instance()->AppendDebugMethod("FFmpegWriter::process_video_packet", "frame->number", frame->number, "bytes_source", bytes_source, "bytes_final", bytes_final);
+
+			// Resize & convert pixel format
+			sws_scale(scaler, frame_source->data, frame_source->linesize, 0,
+			          source_image_height, frame_final->data, frame_final->linesize);
+
+			// Deallocate memory
+			AV_FREE_FRAME(&frame_source);
+
+			// Keep the converted pixels of a solid color frame (for the next frames of the same color)
+			if (!solid_key.empty()) {
+				const GenericScopedLock<CriticalSection> lock(avFramesCriticalSection);
+				solid_video_key = solid_key;
+				solid_video_data.assign(frame_final->data[0], frame_final->data[0] + bytes_final);
+			}
+		}
 
-		// Deallocate memory
-		AV_FREE_FRAME(&frame_source);
+		// Add resized AVFrame to av_frames map
+		{
+			const GenericScopedLock<CriticalSection> lock(avFramesCriticalSection);
+			add_avframe(frame, frame_final);
+		}
 
 	} // end task
 
@@ -2225,7 +2286,7 @@ void FFmpegWriter::OutputStreamInfo() {
 // Init a collection of software rescalers (thread safe)
 void FFmpegWriter::InitScalers(int source_width, int source_height) {
 	int scale_mode = SWS_FAST_BILINEAR;
-	if (openshot::Settings::Instance()->HIGH_QUALITY_SCALING) {
+	if (GetSettings()->HIGH_QUALITY_SCALING) {
 		scale_mode = SWS_BICUBIC;
 	}
 
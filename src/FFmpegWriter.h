@@ -48,6 +48,7 @@
 #include <cmath>
 #include <ctime>
 #include <unistd.h>
+#include <vector>
 #include "CacheMemory.h"
 #include "Exceptions.h"
 #include "OpenMPUtilities.h"
@@ -196,6 +197,10 @@ namespace openshot {
 		std::deque<std::shared_ptr<openshot::Frame> > deallocate_frames;
 
 		std::map<std::shared_ptr<openshot::Frame>, AVFrame *> av_frames;
+		juce::CriticalSection avFramesCriticalSection; ///< Section lock for the av_frames map (for this writer only)
+		std::string solid_video_key; ///< The color and size of the last converted solid color frame
+		std::vector<uint8_t> solid_video_data; ///< The converted pixels of the last solid color frame (reused by frames of the same color)
+		juce::CriticalSection writeVideoCriticalSection; ///< Section lock for encoding video packets (for this writer only)
 
 		/// Add an AVFrame to the cache
 		void add_avframe(std::shared_ptr<openshot::Frame> frame, AVFrame *av_frame);
@@ -362,6 +367,10 @@ namespace openshot {
 		/// @param start The starting frame number of the reader
 		/// @param length The number of frames to write
 		///
+		/// While writing, the reader is streamed (see ReaderBase::SetStreaming), so its caches only keep
+		/// a short window of frames, and the memory used by a long export stays flat. The keyframe values
+		/// of the clips of a Timeline are precomputed for the frames being written (see Timeline::BakeClips).
+		///
 		/// \note This is an overloaded function.
 		void WriteFrame(openshot::ReaderBase *reader, int64_t start, int64_t length);
 
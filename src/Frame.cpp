@@ -29,6 +29,7 @@
  */
 
 #include "Frame.h"
+#include "Executor.h"
 #include "JuceHeader.h"
 
 #include <QApplication>
@@ -45,6 +46,8 @@
 #include <QPointF>
 #include <QWidget>
 
+#include <cstdint>   // for uint32_t
+#include <omp.h>
 #include <thread>    // for std::this_thread::sleep_for
 #include <chrono>    // for std::chrono::milliseconds
 
@@ -108,8 +111,9 @@ void Frame::DeepCopy(const Frame& other)
 	color = other.color;
 	max_audio_sample = other.max_audio_sample;
 
-	if (other.image)
-		image = std::make_shared<QImage>(*(other.image));
+	std::shared_ptr<QImage> other_image = std::atomic_load(&other.image);
+	if (other_image)
+		std::atomic_store(&image, std::make_shared<QImage>(*other_image));
 	if (other.audio)
 		audio = std::make_shared<juce::AudioSampleBuffer>(*(other.audio));
 	if (other.wave_image)
@@ -448,7 +452,8 @@ juce::AudioSampleBuffer *Frame::GetAudioSampleBuffer()
 int64_t Frame::GetBytes()
 {
 	int64_t total_bytes = 0;
-	if (image)
+	if (std::atomic_load(&image))
+		// Solid color frames have no pixel memory (until their pixels are needed)
 		total_bytes += (width * height * sizeof(char) * 4);
 	if (audio) {
 		// approximate audio size (sample rate / 24 fps)
@@ -463,30 +468,36 @@ int64_t Frame::GetBytes()
 const unsigned char* Frame::GetPixels()
 {
 	// Check for blank image
-	if (!image)
-		// Fill with black
-		AddColor(width, height, color);
+	std::shared_ptr<QImage> current_image = std::atomic_load(&image);
+	if (!current_image) {
+		// Fill with solid color
+		draw_solid_color();
+		current_image = std::atomic_load(&image);
+	}
 
 	// Return array of pixel packets
-	return image->constBits();
+	return current_image->constBits();
 }
 
 // Get pixel data (for only a single scan-line)
 const unsigned char* Frame::GetPixels(int row)
 {
 	// Check for blank image
-	if (!image)
-		// Fill with black
-		AddColor(width, height, color);
+	std::shared_ptr<QImage> current_image = std::atomic_load(&image);
+	if (!current_image) {
+		// Fill with solid color
+		draw_solid_color();
+		current_image = std::atomic_load(&image);
+	}
 
 	// Return array of pixel packets
-	return image->constScanLine(row);
+	return current_image->constScanLine(row);
 }
 
 // Check a specific pixel color value (returns True/False)
 bool Frame::CheckPixel(int row, int col, int red, int green, int blue, int alpha, int threshold) {
 	int col_pos = col * 4; // Find column array position
-	if (!image || row < 0 || row >= (height - 1) ||
+	if ((!std::atomic_load(&image) && !has_image_data) || row < 0 || row >= (height - 1) ||
 		col_pos < 0 || col_pos >= (width - 1) ) {
 		// invalid row / col
 		return false;
@@ -675,8 +686,7 @@ void Frame::Thumbnail(std::string path, int new_width, int new_height, std::stri
 		overlay->load(QString::fromStdString(overlay_path));
 
 		// Set pixel format
-		overlay = std::make_shared<QImage>(
-			overlay->convertToFormat(QImage::Format_RGBA8888_Premultiplied));
+		ConvertImageInPlace(*overlay);
 
 		// Resize to fit
 		overlay = std::make_shared<QImage>(overlay->scaled(
@@ -695,8 +705,7 @@ void Frame::Thumbnail(std::string path, int new_width, int new_height, std::stri
 		mask->load(QString::fromStdString(mask_path));
 
 		// Set pixel format
-		mask = std::make_shared<QImage>(
-			mask->convertToFormat(QImage::Format_RGBA8888_Premultiplied));
+		ConvertImageInPlace(*mask);
 
 		// Resize to fit
 		mask = std::make_shared<QImage>(mask->scaled(
@@ -743,53 +752,242 @@ int Frame::constrain(int color_value)
 	return color_value;
 }
 
+// Pack 8-bit color components into a Format_RGBA8888 pixel (R, G, B, A bytes in memory)
+static inline uint32_t pack_rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+	return r | (g << 8) | (b << 16) | (a << 24);
+#else
+	return (r << 24) | (g << 16) | (b << 8) | a;
+#endif
+}
+
+// Multiply a color component by alpha / 255 (rounded, the same as Qt)
+static inline uint32_t multiply_alpha(uint32_t component, uint32_t alpha)
+{
+	uint32_t value = component * alpha;
+	return (value + (value >> 8) + 128) >> 8;
+}
+
+// Is a format converted by convert_row (instead of QImage::convertToFormat)
+static bool is_direct_format(QImage::Format format)
+{
+	switch (format) {
+		case QImage::Format_ARGB32:
+		case QImage::Format_ARGB32_Premultiplied:
+		case QImage::Format_RGB32:
+		case QImage::Format_RGBA8888:
+		case QImage::Format_RGB888:
+		case QImage::Format_Grayscale8:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Convert a row of pixels to Format_RGBA8888_Premultiplied. The loops have no dependencies
+// between pixels (so they are vectorized), and src can be the same row as dst for formats
+// with 4 bytes per pixel.
+static void convert_row(QImage::Format format, const unsigned char *src, unsigned char *dst, int width)
+{
+	uint32_t *out = (uint32_t *) dst;
+	switch (format) {
+		case QImage::Format_ARGB32: {
+			const uint32_t *in = (const uint32_t *) src;
+			#pragma omp simd
+			for (int x = 0; x < width; x++) {
+				uint32_t pixel = in[x];
+				uint32_t alpha = pixel >> 24;
+				out[x] = pack_rgba(multiply_alpha((pixel >> 16) & 0xff, alpha),
+				                   multiply_alpha((pixel >> 8) & 0xff, alpha),
+				                   multiply_alpha(pixel & 0xff, alpha), alpha);
+			}
+			break;
+		}
+		case QImage::Format_ARGB32_Premultiplied: {
+			const uint32_t *in = (const uint32_t *) src;
+			#pragma omp simd
+			for (int x = 0; x < width; x++) {
+				uint32_t pixel = in[x];
+				out[x] = pack_rgba((pixel >> 16) & 0xff, (pixel >> 8) & 0xff, pixel & 0xff, pixel >> 24);
+			}
+			break;
+		}
+		case QImage::Format_RGB32: {
+			const uint32_t *in = (const uint32_t *) src;
+			#pragma omp simd
+			for (int x = 0; x < width; x++) {
+				uint32_t pixel = in[x];
+				out[x] = pack_rgba((pixel >> 16) & 0xff, (pixel >> 8) & 0xff, pixel & 0xff, 255);
+			}
+			break;
+		}
+		case QImage::Format_RGBA8888: {
+			#pragma omp simd
+			for (int x = 0; x < width; x++) {
+				uint32_t alpha = src[x * 4 + 3];
+				out[x] = pack_rgba(multiply_alpha(src[x * 4], alpha), multiply_alpha(src[x * 4 + 1], alpha),
+				                   multiply_alpha(src[x * 4 + 2], alpha), alpha);
+			}
+			break;
+		}
+		case QImage::Format_RGB888: {
+			#pragma omp simd
+			for (int x = 0; x < width; x++)
+				out[x] = pack_rgba(src[x * 3], src[x * 3 + 1], src[x * 3 + 2], 255);
+			break;
+		}
+		case QImage::Format_Grayscale8: {
+			#pragma omp simd
+			for (int x = 0; x < width; x++)
+				out[x] = pack_rgba(src[x], src[x], src[x], 255);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+// Convert the rows of an image in parallel stripes
+static void convert_rows(QImage::Format format, const unsigned char *src, int src_stride,
+                         unsigned char *dst, int dst_stride, int width, int height)
+{
+	// Images added inside a parallel section (i.e. by the threads of a Timeline or reader) are
+	// converted on the calling thread, which keeps the affinity and priority of its own executor.
+	// Small images are also converted on the calling thread (since starting the threads costs more).
+	if (omp_in_parallel() || (int64_t) width * height < 256 * 256) {
+		for (int row = 0; row < height; row++)
+			convert_row(format, src + (int64_t) row * src_stride, dst + (int64_t) row * dst_stride, width);
+		return;
+	}
+
+	#pragma omp parallel for num_threads(Executor::Default()->ThreadCount()) schedule(static)
+	for (int row = 0; row < height; row++)
+		convert_row(format, src + (int64_t) row * src_stride, dst + (int64_t) row * dst_stride, width);
+}
+
+// Convert an image to Format_RGBA8888_Premultiplied (as a new image)
+QImage Frame::ConvertImage(const QImage &source)
+{
+	if (source.format() == QImage::Format_RGBA8888_Premultiplied)
+		return source;
+	if (!is_direct_format(source.format()))
+		return source.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+
+	// Convert directly into the new image (without any intermediate formats)
+	QImage target(source.size(), QImage::Format_RGBA8888_Premultiplied);
+	if (target.isNull())
+		return target;
+	convert_rows(source.format(), source.constBits(), source.bytesPerLine(),
+	             target.bits(), target.bytesPerLine(), source.width(), source.height());
+
+	// Keep the resolution of the source image
+	target.setDotsPerMeterX(source.dotsPerMeterX());
+	target.setDotsPerMeterY(source.dotsPerMeterY());
+	target.setDevicePixelRatio(source.devicePixelRatio());
+	return target;
+}
+
+// Convert an image to Format_RGBA8888_Premultiplied (in place, when possible)
+void Frame::ConvertImageInPlace(QImage &image)
+{
+	if (image.format() == QImage::Format_RGBA8888_Premultiplied)
+		return;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+	if (is_direct_format(image.format()) && image.depth() == 32) {
+		// Convert the pixels over themselves (bits() only copies the pixels if they are shared
+		// with another QImage). The destination pointer is requested first, since it detaches.
+		unsigned char *pixels = image.bits();
+		convert_rows(image.format(), pixels, image.bytesPerLine(),
+		             pixels, image.bytesPerLine(), image.width(), image.height());
+		image.reinterpretAsFormat(QImage::Format_RGBA8888_Premultiplied);
+		return;
+	}
+#endif
+
+	// Formats with a different pixel size need a new image
+	image = ConvertImage(image);
+}
+
 // Add (or replace) pixel data to the frame (based on a solid color)
 void Frame::AddColor(int new_width, int new_height, std::string new_color)
 {
-	// Set color
-	color = new_color;
-
-	// Create new image object, and fill with pixel data
+	// Remove any existing image. The color is only drawn into a new image when
+	// the pixels are needed (see draw_solid_color).
 	const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
-	#pragma omp critical (AddImage)
-	{
-		image = std::make_shared<QImage>(new_width, new_height, QImage::Format_RGBA8888_Premultiplied);
+	color = new_color;
+	std::atomic_store(&image, std::shared_ptr<QImage>());
 
-		// Fill with solid color
-		image->fill(QColor(QString::fromStdString(color)));
-	}
 	// Update height and width
-	width = image->width();
-	height = image->height();
+	width = new_width;
+	height = new_height;
 	has_image_data = true;
 }
 
+// Draw the solid color into an image (if no image exists yet)
+void Frame::draw_solid_color()
+{
+	if (std::atomic_load(&image))
+		return;
+
+	// Get the size and color
+	int new_width = 0;
+	int new_height = 0;
+	std::string new_color;
+	{
+		const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
+		new_width = width;
+		new_height = height;
+		new_color = color;
+	}
+
+	// Create new image object, and fill with pixel data (no lock needed, since
+	// nothing else can see this image yet)
+	auto new_image = std::make_shared<QImage>(new_width, new_height, QImage::Format_RGBA8888_Premultiplied);
+	new_image->fill(QColor(QString::fromStdString(new_color)));
+
+	// Publish the new image (unless another thread was first)
+	const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
+	if (!std::atomic_load(&image))
+		std::atomic_store(&image, new_image);
+}
+
+// Is this frame a single solid color (without any pixel memory)
+bool Frame::IsSolidColor()
+{
+	return !std::atomic_load(&image);
+}
+
+// Get the solid color of this frame
+std::string Frame::SolidColor()
+{
+	const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
+	return color;
+}
+
 // Add (or replace) pixel data to the frame
 void Frame::AddImage(
 	int new_width, int new_height, int bytes_per_pixel,
 	QImage::Format type, const unsigned char *pixels_)
 {
-	// Create new buffer
-	{
-		const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
-		int buffer_size = new_width * new_height * bytes_per_pixel;
-		qbuffer = new unsigned char[buffer_size]();
-
-		// Copy buffer data
-		memcpy((unsigned char*)qbuffer, pixels_, buffer_size);
+	// Create new buffer (no lock needed, since nothing else can see this buffer yet)
+	int buffer_size = new_width * new_height * bytes_per_pixel;
+	unsigned char *new_buffer = new unsigned char[buffer_size];
 
-	}  // Release addingImageSection lock
+	// Copy buffer data
+	memcpy(new_buffer, pixels_, buffer_size);
 
 	// Create new image object from pixel data
 	auto new_image = std::make_shared<QImage>(
-		qbuffer,
+		new_buffer,
 		new_width, new_height,
 		new_width * bytes_per_pixel,
 		type,
 		(QImageCleanupFunction) &openshot::Frame::cleanUpBuffer,
-		(void*) qbuffer
+		(void*) new_buffer
 	);
-	AddImage(new_image);
+	AddImage(std::move(new_image));
 }
 
 // Add (or replace) pixel data to the frame
@@ -799,21 +997,24 @@ void Frame::AddImage(std::shared_ptr<QImage> new_image)
 	if (!new_image)
 		return;
 
-	// assign image data
-	const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
-	#pragma omp critical (AddImage)
-	{
-		image = new_image;
+	// Always convert to Format_RGBA8888_Premultiplied (if different). This happens before
+	// taking the lock. Images only owned by this call are converted in place, and shared
+	// images are copied (since other threads may be using them).
+	if (new_image->format() != QImage::Format_RGBA8888_Premultiplied) {
+		if (new_image.use_count() == 1)
+			ConvertImageInPlace(*new_image);
+		else
+			new_image = std::make_shared<QImage>(ConvertImage(*new_image));
+	}
 
-		// Always convert to Format_RGBA8888_Premultiplied (if different)
-		if (image->format() != QImage::Format_RGBA8888_Premultiplied)
-			*image = image->convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+	// Publish the new image
+	const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
+	std::atomic_store(&image, new_image);
 
-		// Update height and width
-		width = image->width();
-		height = image->height();
-		has_image_data = true;
-	}
+	// Update height and width
+	width = new_image->width();
+	height = new_image->height();
+	has_image_data = true;
 }
 
 // Add (or replace) pixel data to the frame (for only the odd or even lines)
@@ -824,49 +1025,44 @@ void Frame::AddImage(std::shared_ptr<QImage> new_image, bool only_odd_lines)
 		return;
 
 	// Check for blank source image
-	if (!image) {
+	std::shared_ptr<QImage> current_image = std::atomic_load(&image);
+	if (!current_image && has_image_data) {
+		// Draw the solid color first (since only half of the lines are replaced)
+		draw_solid_color();
+		current_image = std::atomic_load(&image);
+	}
+	if (!current_image) {
 		// Replace the blank source image
 		AddImage(new_image);
 
 	} else {
-		// Ignore image of different sizes or formats
-		bool ret=false;
-		#pragma omp critical (AddImage)
-		{
-			if (image == new_image || image->size() != new_image->size()) {
-				ret = true;
-			}
-			else if (new_image->format() != QImage::Format_RGBA8888_Premultiplied) {
-				new_image = std::make_shared<QImage>(
-					new_image->convertToFormat(QImage::Format_RGBA8888_Premultiplied));
-			}
-		}
-		if (ret) {
+		// Ignore image of different sizes
+		if (current_image == new_image || current_image->size() != new_image->size())
 			return;
-		}
+
+		// Convert the new image (outside of the lock)
+		if (new_image->format() != QImage::Format_RGBA8888_Premultiplied)
+			new_image = std::make_shared<QImage>(ConvertImage(*new_image));
 
 		// Get the frame's image
 		const GenericScopedLock<juce::CriticalSection> lock(addingImageSection);
-		#pragma omp critical (AddImage)
-		{
-			unsigned char *pixels = image->bits();
-			const unsigned char *new_pixels = new_image->constBits();
-
-			// Loop through the scanlines of the image (even or odd)
-			int start = 0;
-			if (only_odd_lines)
-				start = 1;
+		unsigned char *pixels = current_image->bits();
+		const unsigned char *new_pixels = new_image->constBits();
 
-			for (int row = start; row < image->height(); row += 2) {
-				int offset = row * image->bytesPerLine();
-				memcpy(pixels + offset, new_pixels + offset, image->bytesPerLine());
-			}
+		// Loop through the scanlines of the image (even or odd)
+		int start = 0;
+		if (only_odd_lines)
+			start = 1;
 
-			// Update height and width
-			height = image->height();
-			width = image->width();
-			has_image_data = true;
+		for (int row = start; row < current_image->height(); row += 2) {
+			int offset = row * current_image->bytesPerLine();
+			memcpy(pixels + offset, new_pixels + offset, current_image->bytesPerLine());
 		}
+
+		// Update height and width
+		height = current_image->height();
+		width = current_image->width();
+		has_image_data = true;
 	}
 }
 
@@ -888,7 +1084,6 @@ void Frame::ResizeAudio(int channels, int length, int rate, ChannelLayout layout
 // Add audio samples to a specific channel
 void Frame::AddAudio(bool replaceSamples, int destChannel, int destStartSample, const float* source, int numSamples, float gainToApplyToSource = 1.0f) {
 	const GenericScopedLock<juce::CriticalSection> lock(addingAudioSection);
-	#pragma omp critical (adding_audio)
     {
 		// Clamp starting sample to 0
 		int destStartSampleAdjusted = max(destStartSample, 0);
@@ -928,11 +1123,11 @@ void Frame::ApplyGainRamp(int destChannel, int destStartSample, int numSamples,
 std::shared_ptr<QImage> Frame::GetImage()
 {
 	// Check for blank image
-	if (!image)
-		// Fill with black
-		AddColor(width, height, color);
+	if (!std::atomic_load(&image))
+		// Fill with solid color
+		draw_solid_color();
 
-	return image;
+	return std::atomic_load(&image);
 }
 
 #ifdef USE_IMAGEMAGICK
@@ -940,16 +1135,19 @@ std::shared_ptr<QImage> Frame::GetImage()
 std::shared_ptr<Magick::Image> Frame::GetMagickImage()
 {
 	// Check for blank image
-	if (!image)
-		// Fill with black
-		AddColor(width, height, "#000000");
+	std::shared_ptr<QImage> current_image = std::atomic_load(&image);
+	if (!current_image) {
+		// Fill with solid color
+		draw_solid_color();
+		current_image = std::atomic_load(&image);
+	}
 
 	// Get the pixels from the frame image
-	const QRgb *tmpBits = (const QRgb*)image->constBits();
+	const QRgb *tmpBits = (const QRgb*)current_image->constBits();
 
 	// Create new image object, and fill with pixel data
 	auto magick_image = std::make_shared<Magick::Image>(
-		image->width(), image->height(),"RGBA", Magick::CharPixel, tmpBits);
+		current_image->width(), current_image->height(),"RGBA", Magick::CharPixel, tmpBits);
 
 	// Give image a transparent background color
 	magick_image->backgroundColor(Magick::Color("none"));
@@ -977,15 +1175,12 @@ void Frame::AddMagickImage(std::shared_ptr<Magick::Image> new_image)
 	// TODO: Actually do something, if we get an exception here
 	MagickCore::ExportImagePixels(new_image->constImage(), 0, 0, new_image->columns(), new_image->rows(), "RGBA", Magick::CharPixel, buffer, &exception);
 
-	// Create QImage of frame data
-	image = std::make_shared<QImage>(
-		qbuffer, width, height, width * BPP, QImage::Format_RGBA8888_Premultiplied,
+	// Create QImage of frame data (ImageMagick exports straight alpha, which
+	// AddImage premultiplies in place)
+	auto new_qimage = std::make_shared<QImage>(
+		qbuffer, new_image->columns(), new_image->rows(), new_image->columns() * BPP, QImage::Format_RGBA8888,
 		(QImageCleanupFunction) &cleanUpBuffer, (void*) qbuffer);
-
-	// Update height and width
-	width = image->width();
-	height = image->height();
-	has_image_data = true;
+	AddImage(std::move(new_qimage));
 }
 #endif
 
@@ -117,6 +117,9 @@ namespace openshot
 		/// Constrain a color value from 0 to 255
 		int constrain(int color_value);
 
+		/// Draw the solid color into an image (if no image exists yet)
+		void draw_solid_color();
+
 	public:
 		int64_t number;	 ///< This is the frame number (starting at 1)
 		bool has_audio_data; ///< This frame has been loaded with audio data
@@ -144,7 +147,10 @@ namespace openshot
 		/// Destructor
 		virtual ~Frame();
 
-		/// Add (or replace) pixel data to the frame (based on a solid color)
+		/// @brief Add (or replace) pixel data to the frame (based on a solid color)
+		///
+		/// No pixel memory is used until the pixels are needed (i.e. GetImage or GetPixels). Until
+		/// then, IsSolidColor() is true, and the color is available from SolidColor().
 		void AddColor(int new_width, int new_height, std::string new_color);
 
 		/// Add (or replace) pixel data to the frame
@@ -180,6 +186,20 @@ namespace openshot
 		/// Clean up buffer after QImage is deleted
 		static void cleanUpBuffer(void *info);
 
+		/// @brief Convert an image to Format_RGBA8888_Premultiplied (the format of all frame images)
+		///
+		/// ARGB32, ARGB32_Premultiplied, RGB32, RGBA8888, RGB888 and Grayscale8 images are converted
+		/// directly (with vectorized loops, in parallel stripes of rows). Other formats use
+		/// QImage::convertToFormat.
+		static QImage ConvertImage(const QImage &source);
+
+		/// @brief Convert an image to Format_RGBA8888_Premultiplied, in place when possible
+		///
+		/// Formats with 4 bytes per pixel are converted over their own pixels, without allocating
+		/// a second image (unless the pixels are shared with another QImage). Other formats are
+		/// replaced by ConvertImage.
+		static void ConvertImageInPlace(QImage &image);
+
 		/// Clear the waveform image (and deallocate its memory)
 		void ClearWaveform();
 
@@ -218,6 +238,12 @@ namespace openshot
 		/// Get pointer to Qt QImage image object
 		std::shared_ptr<QImage> GetImage();
 
+		/// Is this frame a single solid color, without any pixel memory (see AddColor)
+		bool IsSolidColor();
+
+		/// Get the solid color of this frame (i.e. "#000000"), which is the background of blank frames
+		std::string SolidColor();
+
 #ifdef USE_IMAGEMAGICK
 		/// Get pointer to ImageMagick image object
 		std::shared_ptr<Magick::Image> GetMagickImage();
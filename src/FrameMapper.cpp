@@ -35,7 +35,7 @@ using namespace std;
 using namespace openshot;
 
 FrameMapper::FrameMapper(ReaderBase *reader, Fraction target, PulldownType target_pulldown, int target_sample_rate, int target_channels, ChannelLayout target_channel_layout) :
-		reader(reader), target(target), pulldown(target_pulldown), is_dirty(true), avr(NULL)
+		reader(reader), target(target), pulldown(target_pulldown), is_dirty(true), avr(NULL), avr_next_frame(0)
 {
 	// Set the original frame rate from the reader
 	original = Fraction(reader->info.fps.num, reader->info.fps.den);
@@ -57,12 +57,15 @@ FrameMapper::FrameMapper(ReaderBase *reader, Fraction target, PulldownType targe
 	field_toggle = true;
 
 	// Adjust cache size based on size of frame and audio
-	final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
+	final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
 }
 
 // Destructor
 FrameMapper::~FrameMapper() {
 
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+
 	// Auto Close if not already
 	Close();
 
@@ -361,6 +364,11 @@ std::shared_ptr<Frame> FrameMapper::GetOrCreateFrame(int64_t number)
 		// Debug output
 		ZmqLogger::Instance()->AppendDebugMethod("FrameMapper::GetOrCreateFrame (from reader)", "number", number, "samples_in_frame", samples_in_frame);
 
+		// Use the source frame requested by GetFrames (if any)
+		auto batch_frame = batch_frames.find(number);
+		if (batch_frame != batch_frames.end())
+			return batch_frame->second;
+
 		// Attempt to get a frame (but this could fail if a reader has just been closed)
 		new_frame = reader->GetFrame(number);
 
@@ -389,6 +397,9 @@ std::shared_ptr<Frame> FrameMapper::GetOrCreateFrame(int64_t number)
 // Get an openshot::Frame object for a specific frame number of this reader.
 std::shared_ptr<Frame> FrameMapper::GetFrame(int64_t requested_frame)
 {
+	// Drop the frames which will not be requested again (if streaming)
+	release_streamed_frames(&final_cache, requested_frame);
+
 	// Check final cache, and just return the frame (if it's available)
 	std::shared_ptr<Frame> final_frame = final_cache.GetFrame(requested_frame);
 	if (final_frame) return final_frame;
@@ -484,6 +495,16 @@ std::shared_ptr<Frame> FrameMapper::GetFrame(int64_t requested_frame)
 		// create a copy of mapped.Samples that will be used by copy loop
 		SampleRange copy_samples = mapped.Samples;
 
+		if (need_resampling && avr && frame_number != avr_next_frame)
+		{
+			// Not the next frame of the resampling context (i.e. after a seek). Start a new
+			// context, since its buffered samples belong to a different position.
+			ZmqLogger::Instance()->AppendDebugMethod("FrameMapper::GetFrame (restart audio resampling)", "frame_number", frame_number, "avr_next_frame", avr_next_frame);
+			SWR_CLOSE(avr);
+			SWR_FREE(&avr);
+			avr = NULL;
+		}
+
 		if (need_resampling)
 		{
 			// Resampling needed, modify copy of SampleRange object that
@@ -577,9 +598,11 @@ std::shared_ptr<Frame> FrameMapper::GetFrame(int64_t requested_frame)
 		}
 
 		// Resample audio on frame (if needed)
-		if (need_resampling)
+		if (need_resampling) {
 			// Resample audio and correct # of channels if needed
 			ResampleMappedAudio(frame, mapped.Odd.Frame);
+			avr_next_frame = frame_number + 1;
+		}
 
 		// Add frame to final cache
 		final_cache.Add(frame);
@@ -590,6 +613,99 @@ std::shared_ptr<Frame> FrameMapper::GetFrame(int64_t requested_frame)
 	return final_cache.GetFrame(requested_frame);
 }
 
+// Get a range of sequential frames from this reader
+std::vector<std::shared_ptr<Frame>> FrameMapper::GetFrames(int64_t start, int64_t count)
+{
+	std::vector<std::shared_ptr<Frame>> mapped_frames;
+	if (count <= 0)
+		return mapped_frames;
+	mapped_frames.reserve(count);
+
+	// Create a scoped lock, allowing only a single thread to run the following code at one time
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	// Drop the frames which will not be requested again (if streaming)
+	release_streamed_frames(&final_cache, start);
+
+	// Check if mappings are dirty (and need to be recalculated)
+	if (is_dirty)
+		// Recalculate mappings
+		Init();
+
+	// Determine the range of source frames needed by this range of mapped frames
+	int64_t source_start = 0;
+	int64_t source_end = 0;
+	if (reader && start >= 1) {
+		for (int64_t frame_number = start; frame_number < start + count; frame_number++) {
+			MappedFrame mapped = GetMappedFrame(frame_number);
+			int64_t first = std::min(std::min(mapped.Odd.Frame, mapped.Even.Frame), mapped.Samples.frame_start);
+			int64_t last = std::max(std::max(mapped.Odd.Frame, mapped.Even.Frame), mapped.Samples.frame_end);
+			if (source_start == 0 || first < source_start)
+				source_start = std::max(first, (int64_t) 1);
+			if (last > source_end)
+				source_end = last;
+		}
+	}
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("FrameMapper::GetFrames", "start", start, "count", count, "source_start", source_start, "source_end", source_end);
+
+	// Request the source frames in a single batch (unless the mapping skips over a large
+	// number of source frames, i.e. a large speed up, where decoding every frame is wasteful)
+	int64_t source_count = source_end - source_start + 1;
+	if (source_start > 0 && source_count > 0 && source_count <= count * 4) {
+		try {
+			std::vector<std::shared_ptr<Frame>> source_frames = reader->GetFrames(source_start, source_count);
+			for (int64_t index = 0; index < (int64_t) source_frames.size(); index++)
+				// Only use frames with matching numbers (i.e. not a repeated last frame at the end of a stream)
+				if (source_frames[index] && source_frames[index]->number == source_start + index)
+					batch_frames[source_start + index] = source_frames[index];
+		} catch (const ReaderClosed & e) {
+			// ...
+		} catch (const TooManySeeks & e) {
+			// ...
+		} catch (const OutOfBoundsFrame & e) {
+			// ...
+		}
+	}
+
+	try {
+		// Map each frame (using the batch of source frames)
+		for (int64_t frame_number = start; frame_number < start + count; frame_number++)
+			mapped_frames.push_back(GetFrame(frame_number));
+	} catch (...) {
+		batch_frames.clear();
+		throw;
+	}
+	batch_frames.clear();
+
+	return mapped_frames;
+}
+
+// Set the executor used by this reader (and the internal reader)
+void FrameMapper::SetExecutor(Executor* new_executor)
+{
+	executor = new_executor;
+	if (reader)
+		reader->SetExecutor(new_executor);
+}
+
+// Set the settings used by this reader (and the internal reader)
+void FrameMapper::SetSettings(Settings* new_settings)
+{
+	settings = new_settings;
+	if (reader)
+		reader->SetSettings(new_settings);
+}
+
+// Set whether the frames of this reader (and the internal reader) are requested once, in order
+void FrameMapper::SetStreaming(bool new_streaming)
+{
+	streaming = new_streaming;
+	if (reader)
+		reader->SetStreaming(new_streaming);
+}
+
 void FrameMapper::PrintMapping()
 {
 	// Check if mappings are dirty (and need to be recalculated)
@@ -630,6 +746,10 @@ void FrameMapper::Open()
 // Close the internal reader
 void FrameMapper::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	if (reader)
 	{
 		// Create a scoped lock, allowing only a single thread to run the following code at one time
@@ -733,7 +853,7 @@ void FrameMapper::ChangeMapping(Fraction target_fps, PulldownType target_pulldow
 	final_cache.Clear();
 
 	// Adjust cache size based on size of frame and audio
-	final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
+	final_cache.SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
 
 	// Deallocate resample buffer
 	if (avr) {
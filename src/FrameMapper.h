@@ -34,7 +34,9 @@
 #include <assert.h>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include <vector>
+#include <map>
 #include <memory>
 #include "CacheMemory.h"
 #include "ReaderBase.h"
@@ -146,6 +148,8 @@ namespace openshot
 		CacheMemory final_cache; 		// Cache of actual Frame objects
 		bool is_dirty; 			// When this is true, the next call to GetFrame will re-init the mapping
 		SWRCONTEXT *avr;	// Audio resampling context object
+		int64_t avr_next_frame;	// The frame number which continues the audio of the resampling context
+		std::map<int64_t, std::shared_ptr<Frame>> batch_frames;	// Source frames requested by GetFrames (while mapping a range)
 
 		// Internal methods used by init
 		void AddField(int64_t frame);
@@ -186,6 +190,15 @@ namespace openshot
 		/// Get the cache object used by this reader
 		CacheMemory* GetCache() override { return &final_cache; };
 
+		/// Set the executor used by this reader (and the internal reader)
+		void SetExecutor(Executor* new_executor) override;
+
+		/// Set the settings used by this reader (and the internal reader)
+		void SetSettings(Settings* new_settings) override;
+
+		/// Set whether the frames of this reader (and the internal reader) are requested once, in order
+		void SetStreaming(bool new_streaming) override;
+
 		/// @brief This method is required for all derived classes of ReaderBase, and return the
 		/// openshot::Frame object, which contains the image and audio information for that
 		/// frame of video.
@@ -194,6 +207,14 @@ namespace openshot
 		/// @param requested_frame The frame number that is requested.
 		std::shared_ptr<Frame> GetFrame(int64_t requested_frame) override;
 
+		/// Get a range of sequential frames (mapping the range while holding the lock once,
+		/// and requesting the source frames from the reader in a single batch).
+		///
+		/// @returns The requested frames of video (in order)
+		/// @param start The first frame number that is requested.
+		/// @param count The number of frames requested.
+		std::vector<std::shared_ptr<Frame>> GetFrames(int64_t start, int64_t count) override;
+
 		/// Determine if reader is open or closed
 		bool IsOpen() override;
 
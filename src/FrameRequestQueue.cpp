@@ -0,0 +1,138 @@
+/**
+ * @file
+ * @brief Source file for FrameRequestQueue class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameRequestQueue.h"
+#include "Settings.h"
+#include <algorithm>
+
+using namespace openshot;
+
+
+// Create or Get an instance of the request queue singleton
+FrameRequestQueue *FrameRequestQueue::Instance()
+{
+	// Created only once (and destroyed at exit, which joins the worker threads)
+	static FrameRequestQueue instance;
+	return &instance;
+}
+
+// Destructor
+FrameRequestQueue::~FrameRequestQueue()
+{
+	{
+		// Drop the waiting requests, and stop the worker threads
+		std::lock_guard<std::mutex> lock(requests_mutex);
+		is_stopping = true;
+		requests.clear();
+	}
+	requests_condition.notify_all();
+
+	// Wait for the running requests to finish
+	for (auto& worker : workers)
+		if (worker.joinable())
+			worker.join();
+}
+
+// Add a request (which is run on a worker thread)
+void FrameRequestQueue::Add(std::function<void()> request, const void* owner)
+{
+	{
+		std::lock_guard<std::mutex> lock(requests_mutex);
+		if (is_stopping)
+			return;
+
+		// Start the worker threads (on the first request)
+		if (workers.empty()) {
+			int number_of_threads = std::max(1, Settings::Instance()->FRAME_REQUEST_THREADS);
+			for (int index = 0; index < number_of_threads; index++)
+				workers.push_back(std::thread(&FrameRequestQueue::run, this));
+		}
+
+		requests.push_back(Request{request, owner});
+	}
+	requests_condition.notify_one();
+}
+
+// Drop the waiting requests of an owner
+void FrameRequestQueue::Cancel(const void* owner, bool wait)
+{
+	std::unique_lock<std::mutex> lock(requests_mutex);
+	requests.erase(std::remove_if(requests.begin(), requests.end(),
+		[owner](const Request& request) { return request.owner == owner; }), requests.end());
+
+	if (wait) {
+		// Wait for the running requests of the owner (other than this thread's request)
+		std::thread::id current_thread = std::this_thread::get_id();
+		finished_condition.wait(lock, [this, owner, current_thread] {
+			for (const auto& running : running_requests)
+				if (running.second == owner && running.first != current_thread)
+					return false;
+			return true;
+		});
+	}
+}
+
+// Get the number of requests which are waiting or running
+int FrameRequestQueue::Pending()
+{
+	std::lock_guard<std::mutex> lock(requests_mutex);
+	return requests.size() + running_requests.size();
+}
+
+// Worker thread loop
+void FrameRequestQueue::run()
+{
+	while (true) {
+		Request request;
+		{
+			// Wait for the next request (or for the queue to be destroyed)
+			std::unique_lock<std::mutex> lock(requests_mutex);
+			requests_condition.wait(lock, [this] { return is_stopping || !requests.empty(); });
+			if (is_stopping)
+				return;
+			request = requests.front();
+			requests.pop_front();
+			running_requests[std::this_thread::get_id()] = request.owner;
+		}
+
+		// Run request (errors are reported by the request itself)
+		try {
+			request.function();
+		} catch (...) {
+			// ...
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(requests_mutex);
+			running_requests.erase(std::this_thread::get_id());
+		}
+		finished_condition.notify_all();
+	}
+}
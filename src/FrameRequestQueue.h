@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Header file for FrameRequestQueue class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPENSHOT_FRAME_REQUEST_QUEUE_H
+#define OPENSHOT_FRAME_REQUEST_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openshot {
+
+	/**
+	 * @brief This class runs asynchronous frame requests (i.e. ReaderBase::RequestFrame) on a pool of worker threads.
+	 *
+	 * Requests are started in the order they are added, but many requests can be in flight at
+	 * once, and they can complete in any order. The number of worker threads is controlled by
+	 * Settings::Instance()->FRAME_REQUEST_THREADS (read when the first request is added).
+	 *
+	 * Each request has an owner (i.e. the reader), so the requests of a reader can be cancelled
+	 * when it is closed or destroyed. The worker threads are joined when the queue is destroyed
+	 * (at the exit of the process).
+	 */
+	class FrameRequestQueue {
+	private:
+		/// A request, and the object it belongs to
+		struct Request {
+			std::function<void()> function;
+			const void* owner;
+		};
+
+		std::deque<Request> requests; ///< Requests waiting for a worker thread
+		std::vector<std::thread> workers; ///< Worker threads
+		std::mutex requests_mutex; ///< Mutex to protect the list of requests
+		std::condition_variable requests_condition; ///< Signals the worker threads when requests are added
+		std::condition_variable finished_condition; ///< Signals Cancel when a running request finishes
+		std::map<std::thread::id, const void*> running_requests; ///< Owners of the running requests (by worker thread)
+		bool is_stopping; ///< Are the worker threads exiting
+
+		/// Default constructor
+		FrameRequestQueue() : is_stopping(false) {}; // Don't allow user to create an instance of this singleton
+
+		/// Default copy method
+		FrameRequestQueue(FrameRequestQueue const&) = delete; // Don't allow the user to assign this instance
+
+		/// Default assignment operator
+		FrameRequestQueue & operator=(FrameRequestQueue const&) = delete;  // Don't allow the user to assign this instance
+
+		/// Worker thread loop (runs requests until the queue is destroyed)
+		void run();
+
+	public:
+		/// Destructor (drops the waiting requests, and joins the worker threads)
+		~FrameRequestQueue();
+
+		/// Create or get an instance of this singleton (invoke the class with this method)
+		static FrameRequestQueue * Instance();
+
+		/// Add a request (which is run on a worker thread)
+		///
+		/// @param request The function to run
+		/// @param owner The object the request belongs to (used by Cancel)
+		void Add(std::function<void()> request, const void* owner = NULL);
+
+		/// Drop the waiting requests of an owner (running requests are not interrupted)
+		///
+		/// @param owner The object the requests belong to
+		/// @param wait Wait for the running requests of the owner to finish (except the request
+		/// running on the calling thread, if any)
+		void Cancel(const void* owner, bool wait = false);
+
+		/// Get the number of requests which are waiting or running
+		int Pending();
+	};
+
+}
+
+#endif
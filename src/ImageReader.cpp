@@ -44,6 +44,13 @@ ImageReader::ImageReader(const std::string& path, bool inspect_reader) : path(pa
 	}
 }
 
+// Destructor
+ImageReader::~ImageReader()
+{
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+}
+
 // Open image file
 void ImageReader::Open()
 {
@@ -100,6 +107,10 @@ void ImageReader::Open()
 // Close image file
 void ImageReader::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open)
 	{
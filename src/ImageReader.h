@@ -88,6 +88,9 @@ namespace openshot
 		/// when you are inflating the object using JSON after instantiation.
 		ImageReader(const std::string& path, bool inspect_reader=true);
 
+		/// Destructor
+		virtual ~ImageReader();
+
 		/// Close File
 		void Close() override;
 
@@ -29,6 +29,9 @@
  */
 
 #include "Json.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 
 const Json::Value openshot::stringToJson(const std::string value) {
 
@@ -48,3 +51,383 @@ const Json::Value openshot::stringToJson(const std::string value) {
 
 	return root;
 }
+
+const Json::Value openshot::rangeToJson(const JsonRange range) {
+
+	// Parse a range of JSON text into JSON objects
+	Json::Value root;
+	Json::CharReaderBuilder rbuilder;
+	Json::CharReader* reader(rbuilder.newCharReader());
+
+	std::string errors;
+	bool success = reader->parse(range.first, range.second, &root, &errors);
+	delete reader;
+
+	if (!success)
+		// Raise exception
+		throw openshot::InvalidJSON("JSON could not be parsed (or is invalid)");
+
+	return root;
+}
+
+// Skip whitespace
+static const char* skip_json_space(const char* pos, const char* end) {
+	while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+		pos++;
+	return pos;
+}
+
+// Skip a quoted string (pos points at the opening quote), and return the position after the closing quote
+static const char* skip_json_string(const char* pos, const char* end) {
+	for (pos++; pos < end; pos++) {
+		if (*pos == '\\')
+			pos++;
+		else if (*pos == '"')
+			return pos + 1;
+	}
+	throw openshot::InvalidJSON("JSON could not be parsed (unterminated string)");
+}
+
+// Skip a single value (string, number, literal, object or array), and return the position after it
+static const char* skip_json_value(const char* pos, const char* end) {
+	if (pos >= end)
+		throw openshot::InvalidJSON("JSON could not be parsed (missing value)");
+
+	if (*pos == '"')
+		return skip_json_string(pos, end);
+
+	if (*pos == '{' || *pos == '[') {
+		// Match up brackets (ignoring any inside of strings)
+		int depth = 0;
+		while (pos < end) {
+			if (*pos == '"') {
+				pos = skip_json_string(pos, end);
+				continue;
+			}
+			if (*pos == '{' || *pos == '[')
+				depth++;
+			else if (*pos == '}' || *pos == ']') {
+				depth--;
+				if (depth == 0)
+					return pos + 1;
+			}
+			pos++;
+		}
+		throw openshot::InvalidJSON("JSON could not be parsed (unterminated object or array)");
+	}
+
+	// Numbers and literals (true, false, null) end at the next delimiter
+	const char* start = pos;
+	while (pos < end && *pos != ',' && *pos != '}' && *pos != ']' &&
+		   *pos != ' ' && *pos != '\t' && *pos != '\n' && *pos != '\r')
+		pos++;
+	if (pos == start)
+		throw openshot::InvalidJSON("JSON could not be parsed (missing value)");
+	return pos;
+}
+
+std::vector<std::pair<std::string, openshot::JsonRange> > openshot::scanJsonObject(const JsonRange range) {
+
+	std::vector<std::pair<std::string, JsonRange> > members;
+	const char* end = range.second;
+	const char* pos = skip_json_space(range.first, end);
+	if (pos >= end || *pos != '{')
+		throw openshot::InvalidJSON("JSON could not be parsed (expected an object)");
+
+	pos = skip_json_space(pos + 1, end);
+	if (pos < end && *pos == '}')
+		return members;
+
+	while (pos < end) {
+		// Member name
+		if (*pos != '"')
+			throw openshot::InvalidJSON("JSON could not be parsed (expected a member name)");
+		const char* name_end = skip_json_string(pos, end);
+		std::string name(pos + 1, name_end - 1);
+		if (name.find('\\') != std::string::npos)
+			// Only decode names which contain escape sequences
+			name = rangeToJson(JsonRange(pos, name_end)).asString();
+
+		pos = skip_json_space(name_end, end);
+		if (pos >= end || *pos != ':')
+			throw openshot::InvalidJSON("JSON could not be parsed (expected ':')");
+
+		// Member value
+		const char* value_begin = skip_json_space(pos + 1, end);
+		const char* value_end = skip_json_value(value_begin, end);
+		members.push_back(std::make_pair(name, JsonRange(value_begin, value_end)));
+
+		pos = skip_json_space(value_end, end);
+		if (pos < end && *pos == ',')
+			pos = skip_json_space(pos + 1, end);
+		else if (pos < end && *pos == '}')
+			return members;
+		else
+			throw openshot::InvalidJSON("JSON could not be parsed (expected ',' or '}')");
+	}
+	throw openshot::InvalidJSON("JSON could not be parsed (unterminated object)");
+}
+
+std::vector<openshot::JsonRange> openshot::scanJsonArray(const JsonRange range) {
+
+	std::vector<JsonRange> elements;
+	const char* end = range.second;
+	const char* pos = skip_json_space(range.first, end);
+	if (pos >= end || *pos != '[')
+		throw openshot::InvalidJSON("JSON could not be parsed (expected an array)");
+
+	pos = skip_json_space(pos + 1, end);
+	if (pos < end && *pos == ']')
+		return elements;
+
+	while (pos < end) {
+		const char* value_end = skip_json_value(pos, end);
+		elements.push_back(JsonRange(pos, value_end));
+
+		pos = skip_json_space(value_end, end);
+		if (pos < end && *pos == ',')
+			pos = skip_json_space(pos + 1, end);
+		else if (pos < end && *pos == ']')
+			return elements;
+		else
+			throw openshot::InvalidJSON("JSON could not be parsed (expected ',' or ']')");
+	}
+	throw openshot::InvalidJSON("JSON could not be parsed (unterminated array)");
+}
+
+// Write the head of a CBOR data item (major type and argument)
+static void write_binary_head(std::string& out, unsigned char major, uint64_t argument) {
+	major <<= 5;
+	if (argument < 24)
+		out += (char) (major | argument);
+	else if (argument <= 0xff) {
+		out += (char) (major | 24);
+		out += (char) argument;
+	} else if (argument <= 0xffff) {
+		out += (char) (major | 25);
+		for (int shift = 8; shift >= 0; shift -= 8)
+			out += (char) (argument >> shift);
+	} else if (argument <= 0xffffffff) {
+		out += (char) (major | 26);
+		for (int shift = 24; shift >= 0; shift -= 8)
+			out += (char) (argument >> shift);
+	} else {
+		out += (char) (major | 27);
+		for (int shift = 56; shift >= 0; shift -= 8)
+			out += (char) (argument >> shift);
+	}
+}
+
+// Append a JSON value as a CBOR data item
+static void write_binary_value(std::string& out, const Json::Value& value) {
+	switch (value.type()) {
+		case Json::nullValue:
+			out += (char) 0xf6;
+			break;
+		case Json::booleanValue:
+			out += (char) (value.asBool() ? 0xf5 : 0xf4);
+			break;
+		case Json::intValue: {
+			Json::Int64 number = value.asInt64();
+			if (number >= 0)
+				write_binary_head(out, 0, (uint64_t) number);
+			else
+				write_binary_head(out, 1, (uint64_t) (-1 - number));
+			break;
+		}
+		case Json::uintValue:
+			write_binary_head(out, 0, value.asUInt64());
+			break;
+		case Json::realValue: {
+			double number = value.asDouble();
+			float small_number = (float) number;
+			if ((double) small_number == number) {
+				// Store as a 32-bit float (without losing precision)
+				uint32_t small_bits;
+				memcpy(&small_bits, &small_number, sizeof(small_bits));
+				out += (char) 0xfa;
+				for (int shift = 24; shift >= 0; shift -= 8)
+					out += (char) (small_bits >> shift);
+			} else {
+				uint64_t bits;
+				memcpy(&bits, &number, sizeof(bits));
+				out += (char) 0xfb;
+				for (int shift = 56; shift >= 0; shift -= 8)
+					out += (char) (bits >> shift);
+			}
+			break;
+		}
+		case Json::stringValue: {
+			const char* begin;
+			const char* end;
+			value.getString(&begin, &end);
+			write_binary_head(out, 3, end - begin);
+			out.append(begin, end);
+			break;
+		}
+		case Json::arrayValue:
+			write_binary_head(out, 4, value.size());
+			for (const Json::Value& item : value)
+				write_binary_value(out, item);
+			break;
+		case Json::objectValue:
+			write_binary_head(out, 5, value.size());
+			for (Json::Value::const_iterator item = value.begin(); item != value.end(); item++) {
+				const char* end;
+				const char* begin = item.memberName(&end);
+				write_binary_head(out, 3, end - begin);
+				out.append(begin, end);
+				write_binary_value(out, *item);
+			}
+			break;
+	}
+}
+
+const std::string openshot::jsonToBinary(const Json::Value& root) {
+	std::string out;
+	write_binary_value(out, root);
+	return out;
+}
+
+namespace {
+
+// Reads CBOR data items from a string
+class BinaryJsonReader {
+private:
+	const unsigned char* pos;
+	const unsigned char* end;
+
+	// Read a big-endian unsigned integer of a number of bytes
+	uint64_t read_bytes(int count) {
+		if (end - pos < count)
+			throw openshot::InvalidJSON("Binary JSON could not be decoded (unexpected end of data)");
+		uint64_t result = 0;
+		for (int index = 0; index < count; index++)
+			result = (result << 8) | *pos++;
+		return result;
+	}
+
+	// Read the argument of a data item (the count, length or number)
+	uint64_t read_argument(unsigned char info) {
+		if (info < 24)
+			return info;
+		else if (info == 24)
+			return read_bytes(1);
+		else if (info == 25)
+			return read_bytes(2);
+		else if (info == 26)
+			return read_bytes(4);
+		else if (info == 27)
+			return read_bytes(8);
+		throw openshot::InvalidJSON("Binary JSON could not be decoded (unsupported length)");
+	}
+
+	// Read a text string of a specific length
+	std::string read_text(uint64_t length) {
+		if ((uint64_t) (end - pos) < length)
+			throw openshot::InvalidJSON("Binary JSON could not be decoded (unexpected end of data)");
+		std::string text((const char*) pos, length);
+		pos += length;
+		return text;
+	}
+
+public:
+	BinaryJsonReader(const std::string& value) :
+		pos((const unsigned char*) value.data()), end((const unsigned char*) value.data() + value.size()) { }
+
+	bool AtEnd() { return pos == end; }
+
+	// Read the next data item
+	Json::Value Read(int depth = 0) {
+		if (pos >= end)
+			throw openshot::InvalidJSON("Binary JSON could not be decoded (unexpected end of data)");
+		if (depth > 1000)
+			throw openshot::InvalidJSON("Binary JSON could not be decoded (too deeply nested)");
+
+		unsigned char major = *pos >> 5;
+		unsigned char info = *pos & 0x1f;
+		pos++;
+
+		switch (major) {
+			case 0: {
+				uint64_t number = read_argument(info);
+				// Match the value types used when parsing JSON text
+				if (number <= (uint64_t) Json::Value::maxInt)
+					return Json::Value((Json::Int64) number);
+				return Json::Value((Json::UInt64) number);
+			}
+			case 1: {
+				uint64_t number = read_argument(info);
+				if (number > (uint64_t) INT64_MAX)
+					throw openshot::InvalidJSON("Binary JSON could not be decoded (integer out of range)");
+				return Json::Value(-1 - (Json::Int64) number);
+			}
+			case 3:
+				return Json::Value(read_text(read_argument(info)));
+			case 4: {
+				uint64_t count = read_argument(info);
+				Json::Value array(Json::arrayValue);
+				for (uint64_t index = 0; index < count; index++)
+					array.append(Read(depth + 1));
+				return array;
+			}
+			case 5: {
+				uint64_t count = read_argument(info);
+				Json::Value object(Json::objectValue);
+				for (uint64_t index = 0; index < count; index++) {
+					if (pos >= end || (*pos >> 5) != 3)
+						throw openshot::InvalidJSON("Binary JSON could not be decoded (member names must be text)");
+					unsigned char name_info = *pos++ & 0x1f;
+					std::string name = read_text(read_argument(name_info));
+					object[name] = Read(depth + 1);
+				}
+				return object;
+			}
+			case 7:
+				if (info == 20)
+					return Json::Value(false);
+				else if (info == 21)
+					return Json::Value(true);
+				else if (info == 22 || info == 23)
+					return Json::Value();
+				else if (info == 25) {
+					// 16-bit float
+					uint64_t half = read_bytes(2);
+					int exponent = (half >> 10) & 0x1f;
+					double mantissa = half & 0x3ff;
+					double number;
+					if (exponent == 0)
+						number = ldexp(mantissa, -24);
+					else if (exponent == 31)
+						number = mantissa == 0 ? INFINITY : NAN;
+					else
+						number = ldexp(mantissa + 1024, exponent - 25);
+					return Json::Value((half & 0x8000) ? -number : number);
+				}
+				else if (info == 26) {
+					uint32_t bits = read_bytes(4);
+					float number;
+					memcpy(&number, &bits, sizeof(number));
+					return Json::Value((double) number);
+				}
+				else if (info == 27) {
+					uint64_t bits = read_bytes(8);
+					double number;
+					memcpy(&number, &bits, sizeof(number));
+					return Json::Value(number);
+				}
+				break;
+		}
+		throw openshot::InvalidJSON("Binary JSON could not be decoded (unsupported data item)");
+	}
+};
+
+}
+
+const Json::Value openshot::binaryToJson(const std::string& value) {
+	BinaryJsonReader reader(value);
+	Json::Value root = reader.Read();
+	if (!reader.AtEnd())
+		throw openshot::InvalidJSON("Binary JSON could not be decoded (unexpected data after value)");
+	return root;
+}
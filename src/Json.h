@@ -32,11 +32,38 @@
 #define OPENSHOT_JSON_H
 
 #include <string>
+#include <utility>
+#include <vector>
 #include "json/json.h"
 #include "Exceptions.h"
 
 namespace openshot {
     const Json::Value stringToJson(const std::string value);
+
+    /// A range of characters which contains a single (unparsed) JSON value
+    typedef std::pair<const char*, const char*> JsonRange;
+
+    /// Parse a range of characters (i.e. a single value found by scanJsonObject) into JSON objects
+    const Json::Value rangeToJson(const JsonRange range);
+
+    /// @brief Find the members of a JSON object, without parsing their values into Json::Value objects
+    ///
+    /// This is a light-weight scan of the JSON text (similar to a SAX parser), which only matches up
+    /// quotes and brackets. It returns each member name with the range of its value (in order), so large
+    /// values can be skipped, stored, or parsed later. Invalid JSON raises an openshot::InvalidJSON exception.
+    std::vector<std::pair<std::string, JsonRange> > scanJsonObject(const JsonRange range);
+
+    /// Find the elements of a JSON array, without parsing them into Json::Value objects
+    std::vector<JsonRange> scanJsonArray(const JsonRange range);
+
+    /// @brief Encode JSON objects into a compact binary string (CBOR, RFC 7049)
+    ///
+    /// Binary data is much faster to decode than JSON text (no number parsing, escaping or whitespace), and
+    /// real numbers which fit in a float (such as most keyframe values) are stored in 4 bytes.
+    const std::string jsonToBinary(const Json::Value& root);
+
+    /// Decode a compact binary string (CBOR, RFC 7049) into JSON objects
+    const Json::Value binaryToJson(const std::string& value);
 }
 
 #endif
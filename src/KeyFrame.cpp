@@ -282,6 +282,39 @@ double Keyframe::GetValue(int64_t index) const {
 	return InterpolateBetween(*predecessor, *candidate, index, 0.01);
 }
 
+// Get the values of a range of indexes
+std::vector<double> Keyframe::GetValues(int64_t start_index, int64_t count) const {
+	std::vector<double> values(count > 0 ? count : 0, 0.0);
+	if (Points.empty() || count <= 0) {
+		return values;
+	}
+
+	// Search for the first index only, and then walk forward through the points
+	std::vector<Point>::const_iterator candidate =
+		std::lower_bound(begin(Points), end(Points), static_cast<double>(start_index), IsPointBeforeX);
+
+	for (int64_t n = 0; n < count; n++) {
+		int64_t index = start_index + n;
+		while (candidate != end(Points) && candidate->co.X < index) {
+			candidate++;
+		}
+
+		if (candidate == end(Points)) {
+			// index is behind last point (and so are all following indexes)
+			std::fill(values.begin() + n, values.end(), Points.back().co.Y);
+			break;
+		}
+		if (candidate == begin(Points) || candidate->co.X == index) {
+			// index is at or before first point, or directly on a point
+			values[n] = candidate->co.Y;
+			continue;
+		}
+		std::vector<Point>::const_iterator predecessor = candidate - 1;
+		values[n] = InterpolateBetween(*predecessor, *candidate, index, 0.01);
+	}
+	return values;
+}
+
 // Get the rounded INT value at a specific index
 int Keyframe::GetInt(int64_t index) const {
 	return int(round(GetValue(index)));
@@ -341,6 +374,30 @@ Json::Value Keyframe::JsonValue() const {
 	return root;
 }
 
+// Generate compact binary string of this object
+std::string Keyframe::Binary() const {
+
+	// Return encoded string
+	return openshot::jsonToBinary(JsonValue());
+}
+
+// Load compact binary string into this object
+void Keyframe::SetBinary(const std::string binary) {
+
+	// Decode binary string into JSON objects
+	try
+	{
+		const Json::Value root = openshot::binaryToJson(binary);
+		// Set all values that match
+		SetJsonValue(root);
+	}
+	catch (const std::exception& e)
+	{
+		// Error decoding binary JSON (or missing keys)
+		throw InvalidJSON("Binary JSON is invalid (missing keys or invalid data types)");
+	}
+}
+
 // Load JSON string into this object
 void Keyframe::SetJson(const std::string value) {
 
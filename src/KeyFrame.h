@@ -94,6 +94,11 @@ namespace openshot {
 		/// Get the value at a specific index
 		double GetValue(int64_t index) const;
 
+		/// @brief Get the values of a range of indexes (faster than calling GetValue for each index)
+		/// @param start_index The first index
+		/// @param count The number of values
+		std::vector<double> GetValues(int64_t start_index, int64_t count) const;
+
 		/// Get the rounded INT value at a specific index
 		int GetInt(int64_t index) const;
 
@@ -137,6 +142,10 @@ namespace openshot {
 		void SetJson(const std::string value); ///< Load JSON string into this object
 		void SetJsonValue(const Json::Value root); ///< Load Json::Value into this object
 
+		/// Get and Set compact binary methods (see openshot::jsonToBinary)
+		std::string Binary() const; ///< Generate compact binary string of this object
+		void SetBinary(const std::string binary); ///< Load compact binary string into this object
+
 		/// Remove a point by matching a coordinate
 		void RemovePoint(Point p);
 
@@ -37,9 +37,13 @@
 
 #include "Settings.h"
 
-// Calculate the # of OpenMP Threads to allow
-#define OPEN_MP_NUM_PROCESSORS (std::min(omp_get_num_procs(), std::max(2, openshot::Settings::Instance()->OMP_THREADS) ))
-#define FF_NUM_PROCESSORS (std::min(omp_get_num_procs(), std::max(2, openshot::Settings::Instance()->FF_THREADS) ))
+// Calculate the # of OpenMP Threads to allow (for a specific Settings object, i.e. reader->GetSettings())
+#define OPEN_MP_NUM_PROCESSORS_FOR(settings) (std::min(omp_get_num_procs(), std::max(2, (settings)->OMP_THREADS) ))
+#define FF_NUM_PROCESSORS_FOR(settings) (std::min(omp_get_num_procs(), std::max(2, (settings)->FF_THREADS) ))
+
+// Calculate the # of OpenMP Threads to allow (for the global settings)
+#define OPEN_MP_NUM_PROCESSORS OPEN_MP_NUM_PROCESSORS_FOR(openshot::Settings::Instance())
+#define FF_NUM_PROCESSORS FF_NUM_PROCESSORS_FOR(openshot::Settings::Instance())
 
 // Set max-active-levels to the max supported, if possible
 // (supported_active_levels is OpenMP 5.0 (November 2018) or later, only.)
@@ -119,6 +119,7 @@
 #include "EffectInfo.h"
 #include "Enums.h"
 #include "Exceptions.h"
+#include "Executor.h"
 #include "ReaderBase.h"
 #include "WriterBase.h"
 #include "FFmpegReader.h"
@@ -126,6 +127,7 @@
 #include "Fraction.h"
 #include "Frame.h"
 #include "FrameMapper.h"
+#include "FrameRequestQueue.h"
 #ifdef USE_IMAGEMAGICK
 	#include "ImageReader.h"
 	#include "ImageWriter.h"
@@ -138,6 +140,9 @@
 #include "QtHtmlReader.h"
 #include "QtImageReader.h"
 #include "QtTextReader.h"
+#include "QtTitleReader.h"
+#include "RenderCache.h"
+#include "ThumbnailExtractor.h"
 #include "TimelineBase.h"
 #include "Timeline.h"
 #include "Settings.h"
@@ -31,6 +31,9 @@
 
 #include "PlayerPrivate.h"
 
+#include <algorithm> // for std::max, std::min
+#include <cmath>     // for std::pow, round
+#include <cstdlib>   // for std::abs
 #include <thread>    // for std::this_thread::sleep_for
 #include <chrono>    // for std::chrono milliseconds, high_resolution_clock
 
@@ -42,7 +45,9 @@ namespace openshot
     , audioPlayback(new openshot::AudioPlaybackThread())
     , videoPlayback(new openshot::VideoPlaybackThread(rb))
     , videoCache(new openshot::VideoCacheThread())
-    , speed(1), reader(NULL), last_video_position(1)
+    , speed(1), reader(NULL), last_video_position(1), frames_caught_up(0)
+    , base_decode_mode(openshot::DECODE_FULL), settings(NULL), render_latency(0.0), late_time(0.0), preview_level(0)
+    , frames_fast(0), base_preview_width(0), base_preview_height(0)
     { }
 
     // Destructor
@@ -52,6 +57,7 @@ namespace openshot
         delete audioPlayback;
         delete videoCache;
         delete videoPlayback;
+        delete settings;
     }
 
     // Start thread
@@ -90,6 +96,13 @@ namespace openshot
                 || (video_position > reader->info.video_length)
                ) {
                 speed = 0;
+                setDecodeMode(base_decode_mode);
+                late_time = 0.0;
+                if (preview_level > 0) {
+                    // Render the paused frame again at the full preview size
+                    setPreviewLevel(0);
+                    last_video_position = 0;
+                }
                 std::this_thread::sleep_for(frame_duration);
                 continue;
             }
@@ -122,6 +135,24 @@ namespace openshot
             // Calculate the amount of time to sleep (by subtracting the render time)
             auto sleep_time = duration_cast<ms>(frame_duration - render_time);
 
+            // Decode faster (at a lower quality) while the video is behind
+            updateDecodeMode(-video_frame_diff, render_time > frame_duration);
+
+            // Render a smaller preview while frames take too long
+            updatePreviewSize(render_time.count(), frame_duration.count());
+
+            // Drop frames which can no longer be shown in time (when there is no audio to
+            // follow; with audio, the drift correction below skips frames)
+            if (!reader->info.has_audio && speed != 0) {
+                late_time = std::max(0.0, late_time + (render_time - frame_duration).count());
+                int64_t dropped_frames = late_time / frame_duration.count();
+                if (dropped_frames > 0) {
+                    video_position = std::min(std::max(video_position + dropped_frames * speed, int64_t(1)), reader->info.video_length);
+                    late_time -= dropped_frames * frame_duration.count();
+                    ZmqLogger::Instance()->AppendDebugMethod("PlayerPrivate::run (drop frames)", "dropped_frames", dropped_frames, "video_position", video_position, "render_time(ms)", render_time.count());
+                }
+            }
+
             // Debug
             ZmqLogger::Instance()->AppendDebugMethod("PlayerPrivate::run (determine sleep)", "video_frame_diff", video_frame_diff, "video_position", video_position, "audio_position", audio_position, "speed", speed, "render_time(ms)", render_time.count(), "sleep_time(ms)", sleep_time.count());
 
@@ -182,12 +213,144 @@ namespace openshot
     return std::shared_ptr<openshot::Frame>();
     }
 
+    // Lower the decode quality of the reader when playback falls behind (and restore it once caught up)
+    void PlayerPrivate::updateDecodeMode(int64_t frames_behind, bool is_late)
+    {
+        openshot::DecodeMode current_mode = reader->GetSettings()->DECODE_MODE;
+        openshot::DecodeMode new_mode = base_decode_mode;
+        if (std::abs(speed) > 1)
+            // Fast shuttle (only keyframes are displayed)
+            new_mode = openshot::DECODE_KEYFRAMES_ONLY;
+        else if (frames_behind > 10)
+            new_mode = std::max(base_decode_mode, openshot::DECODE_REFERENCE_ONLY);
+        else if (frames_behind > 2 || is_late)
+            new_mode = std::max(base_decode_mode, openshot::DECODE_FAST);
+
+        // Only raise the quality again after a second of frames on time (to avoid toggling every frame).
+        // Shuttle switches immediately.
+        if (new_mode == openshot::DECODE_KEYFRAMES_ONLY || current_mode == openshot::DECODE_KEYFRAMES_ONLY
+            || new_mode >= current_mode) {
+            frames_caught_up = 0;
+        } else if (++frames_caught_up < reader->info.fps.ToDouble()) {
+            return;
+        } else {
+            frames_caught_up = 0;
+        }
+
+        setDecodeMode(new_mode);
+    }
+
+    // Set the decode mode of the reader's settings
+    void PlayerPrivate::setDecodeMode(openshot::DecodeMode new_mode)
+    {
+        if (!reader || reader->GetSettings()->DECODE_MODE == new_mode)
+            return;
+
+        openshot::DecodeMode old_mode = reader->GetSettings()->DECODE_MODE;
+        ZmqLogger::Instance()->AppendDebugMethod("PlayerPrivate::setDecodeMode", "old_mode", old_mode, "new_mode", new_mode, "video_position", video_position, "speed", speed);
+        reader->GetSettings()->DECODE_MODE = new_mode;
+
+        if (new_mode < old_mode)
+            // Frames decoded at the lower quality are still cached (by the reader and its clips)
+            clearDecodedFrames(reader);
+    }
+
+    // Clear the cached frames of a reader (and any readers it contains)
+    void PlayerPrivate::clearDecodedFrames(openshot::ReaderBase *cached_reader)
+    {
+        if (!cached_reader)
+            return;
+
+        if (cached_reader->Name() == "Timeline") {
+            openshot::Timeline *timeline = (openshot::Timeline *) cached_reader;
+            timeline->ClearAllCache();
+
+            // Nested timelines keep their cached frames when their parent is cleared
+            for (auto clip : timeline->Clips()) {
+                openshot::ReaderBase *clip_reader = clip->Reader();
+                if (clip_reader && clip_reader->Name() == "FrameMapper")
+                    clip_reader = ((openshot::FrameMapper *) clip_reader)->Reader();
+                if (clip_reader && clip_reader->Name() == "Timeline")
+                    clearDecodedFrames(clip_reader);
+            }
+        } else {
+            if (cached_reader->GetCache())
+                cached_reader->GetCache()->Clear();
+            if (cached_reader->Name() == "FrameMapper")
+                clearDecodedFrames(((openshot::FrameMapper *) cached_reader)->Reader());
+        }
+    }
+
+    // Step the preview resolution of a Timeline reader down (or back up) to hold real-time playback
+    void PlayerPrivate::updatePreviewSize(double render_ms, double frame_ms)
+    {
+        if (reader->Name() != "Timeline")
+            return;
+        openshot::Timeline *timeline = (openshot::Timeline *) reader;
+
+        // Follow preview size changes made outside the player (i.e. a resized preview window)
+        if (preview_level == 0) {
+            base_preview_width = timeline->preview_width;
+            base_preview_height = timeline->preview_height;
+        }
+
+        // Average the time to get a frame over the last few frames
+        render_latency = render_latency * 0.9 + render_ms * 0.1;
+
+        if (render_latency > frame_ms * 0.9 && preview_level < 3) {
+            // Too slow, render a smaller preview (and measure the new size from half a frame)
+            setPreviewLevel(preview_level + 1);
+            render_latency = frame_ms * 0.5;
+        }
+        else if (render_latency < frame_ms * 0.5 && preview_level > 0) {
+            // Well within time for a second, try a larger preview again
+            if (++frames_fast >= reader->info.fps.ToDouble())
+                setPreviewLevel(preview_level - 1);
+        }
+        else
+            frames_fast = 0;
+    }
+
+    // Set the preview resolution step of a Timeline reader (0 = the full preview size)
+    void PlayerPrivate::setPreviewLevel(int new_level)
+    {
+        if (!reader || reader->Name() != "Timeline" || new_level == preview_level)
+            return;
+        openshot::Timeline *timeline = (openshot::Timeline *) reader;
+
+        // Each step renders 3/4 of the previous preview size
+        double scale = std::pow(0.75, new_level);
+        ZmqLogger::Instance()->AppendDebugMethod("PlayerPrivate::setPreviewLevel", "preview_level", preview_level, "new_level", new_level, "base_preview_width", base_preview_width, "base_preview_height", base_preview_height, "scale", scale);
+
+        // The timeline locks itself while resizing (the cache thread can be getting frames)
+        timeline->SetMaxSize(round(base_preview_width * scale), round(base_preview_height * scale));
+
+        if (new_level == 0)
+            // Frames rendered at the smaller sizes are still cached (by the timeline and its clips)
+            timeline->ClearAllCache();
+
+        preview_level = new_level;
+        frames_fast = 0;
+    }
+
     // Start video/audio playback
     bool PlayerPrivate::startPlayback()
     {
         if (video_position < 0) return false;
 
         stopPlayback(-1);
+        if (reader) {
+            // Readers without their own settings use a copy of the global settings during playback, so
+            // lowering the decode mode never changes the global settings (used by other readers and writers)
+            if (reader->GetSettings() == openshot::Settings::Instance()) {
+                delete settings;
+                settings = openshot::Settings::Create();
+                reader->SetSettings(settings);
+            }
+            base_decode_mode = reader->GetSettings()->DECODE_MODE;
+        }
+        render_latency = 0.0;
+        late_time = 0.0;
         startThread(1);
         return true;
     }
@@ -195,10 +358,18 @@ namespace openshot
     // Stop video/audio playback
     void PlayerPrivate::stopPlayback(int timeOutMilliseconds)
     {
-        if (isThreadRunning()) stopThread(timeOutMilliseconds);
+        if (isThreadRunning()) {
+            stopThread(timeOutMilliseconds);
+            setDecodeMode(base_decode_mode);
+            setPreviewLevel(0);
+        }
         if (audioPlayback->isThreadRunning() && reader->info.has_audio) audioPlayback->stopThread(timeOutMilliseconds);
         if (videoCache->isThreadRunning() && reader->info.has_video) videoCache->stopThread(timeOutMilliseconds);
         if (videoPlayback->isThreadRunning() && reader->info.has_video) videoPlayback->stopThread(timeOutMilliseconds);
+
+        // Return the reader to the global settings (once nothing is reading frames)
+        if (reader && settings && reader->GetSettings() == settings)
+            reader->SetSettings(NULL);
     }
 
 }
@@ -33,6 +33,8 @@
 #define OPENSHOT_PLAYER_PRIVATE_H
 
 #include "../ReaderBase.h"
+#include "../Settings.h"
+#include "../Timeline.h"
 #include "../RendererBase.h"
 #include "../AudioReaderSource.h"
 #include "../Qt/AudioPlaybackThread.h"
@@ -57,6 +59,15 @@ namespace openshot
 	int speed; /// The speed and direction to playback a reader (1=normal, 2=fast, 3=faster, -1=rewind, etc...)
 	openshot::RendererBase *renderer;
 	int64_t last_video_position; /// The last frame actually displayed
+	int64_t frames_caught_up; /// The number of frames displayed on time (since the decode mode was last lowered)
+	openshot::DecodeMode base_decode_mode; /// The decode mode of the reader before playback started
+	openshot::Settings *settings; /// The settings used by a reader without its own settings during playback (so the global settings are never changed)
+	double render_latency; /// The moving average of the time to get a frame (in milliseconds)
+	double late_time; /// The time the video is running late (in milliseconds), which is caught up by dropping frames
+	int preview_level; /// The preview resolution step of a Timeline reader (0 = the full preview size)
+	int64_t frames_fast; /// The number of frames rendered well within time (since the preview level last changed)
+	int base_preview_width; /// The preview width of a Timeline reader (before the player lowered it)
+	int base_preview_height; /// The preview height of a Timeline reader (before the player lowered it)
 
 	/// Constructor
 	PlayerPrivate(openshot::RendererBase *rb);
@@ -75,6 +86,21 @@ namespace openshot
 	/// Get the next frame (based on speed and direction)
 	std::shared_ptr<openshot::Frame> getFrame();
 
+	/// Lower the decode quality of the reader when playback falls behind (and restore it once caught up)
+	void updateDecodeMode(int64_t frames_behind, bool is_late);
+
+	/// Set the decode mode of the reader's settings
+	void setDecodeMode(openshot::DecodeMode new_mode);
+
+	/// Clear the cached frames of a reader (and any readers it contains), i.e. frames decoded at a lower quality
+	void clearDecodedFrames(openshot::ReaderBase *cached_reader);
+
+	/// Step the preview resolution of a Timeline reader down (or back up) to hold real-time playback
+	void updatePreviewSize(double render_ms, double frame_ms);
+
+	/// Set the preview resolution step of a Timeline reader (0 = the full preview size)
+	void setPreviewLevel(int new_level);
+
 	/// The parent class of PlayerPrivate
 	friend class QtPlayer;
     };
@@ -52,7 +52,7 @@ VideoRenderWidget::VideoRenderWidget(QWidget *parent)
     pixel_ratio.num = 1;
     pixel_ratio.den = 1;
 
-    connect(renderer, SIGNAL(present(const QImage &)), this, SLOT(present(const QImage &)));
+    connect(renderer, &VideoRenderer::presentImage, this, &VideoRenderWidget::present);
 }
 
 VideoRenderWidget::~VideoRenderWidget()
@@ -68,6 +68,20 @@ void VideoRenderWidget::SetAspectRatio(openshot::Fraction new_aspect_ratio, open
 {
 	aspect_ratio = new_aspect_ratio;
 	pixel_ratio = new_pixel_ratio;
+	updatePresentationSize();
+}
+
+void VideoRenderWidget::updatePresentationSize()
+{
+	// Size of the viewport in device pixels (i.e. on high DPI displays)
+	QRect viewport = centeredViewport(width(), height());
+	renderer->SetPresentationSize(viewport.width() * devicePixelRatioF(), viewport.height() * devicePixelRatioF());
+}
+
+void VideoRenderWidget::resizeEvent(QResizeEvent *event)
+{
+	QWidget::resizeEvent(event);
+	updatePresentationSize();
 }
 
 QRect VideoRenderWidget::centeredViewport(int width, int height)
@@ -91,12 +105,13 @@ void VideoRenderWidget::paintEvent(QPaintEvent *event)
     // maintain aspect ratio
     painter.fillRect(event->rect(), palette().window());
     painter.setViewport(centeredViewport(width(), height()));
-    painter.drawImage(QRect(0, 0, width(), height()), image);
+    if (image)
+        painter.drawImage(QRect(0, 0, width(), height()), *image);
 
 }
 
-void VideoRenderWidget::present(const QImage &m)
+void VideoRenderWidget::present(std::shared_ptr<QImage> m)
 {
     image = m;
-    repaint();
+    update();
 }
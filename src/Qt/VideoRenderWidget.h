@@ -37,6 +37,8 @@
 #include <QWidget>
 #include <QImage>
 #include <QPaintEvent>
+#include <QResizeEvent>
+#include <memory>
 #include <QRect>
 
 class VideoRenderWidget : public QWidget
@@ -45,7 +47,7 @@ class VideoRenderWidget : public QWidget
 
 private:
     VideoRenderer *renderer;
-    QImage image;
+    std::shared_ptr<QImage> image;
     openshot::Fraction aspect_ratio;
     openshot::Fraction pixel_ratio;
 
@@ -58,11 +60,15 @@ public:
 
 protected:
     void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+
+    /// Tell the renderer the size of the viewport (so frame images are scaled before they are presented)
+    void updatePresentationSize();
 
     QRect centeredViewport(int width, int height);
 
 private slots:
-    void present(const QImage &image);
+    void present(std::shared_ptr<QImage> image);
 
 };
 
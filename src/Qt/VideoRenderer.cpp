@@ -32,8 +32,10 @@
 
 
 VideoRenderer::VideoRenderer(QObject *parent)
-    : QObject(parent)
+    : QObject(parent), override_widget(NULL)
 {
+    // Allow shared images to be passed across threads (queued signals)
+    qRegisterMetaType<std::shared_ptr<QImage>>("std::shared_ptr<QImage>");
 }
 
 VideoRenderer::~VideoRenderer()
@@ -50,6 +52,8 @@ void VideoRenderer::OverrideWidget(int64_t qwidget_address)
 
 void VideoRenderer::render(std::shared_ptr<QImage> image)
 {
-    if (image)
+    if (image) {
+        emit presentImage(image);
         emit present(*image);
+    }
 }
@@ -39,6 +39,8 @@
 
 class QPainter;
 
+Q_DECLARE_METATYPE(std::shared_ptr<QImage>)
+
 class VideoRenderer : public QObject, public openshot::RendererBase
 {
     Q_OBJECT
@@ -51,8 +53,12 @@ public:
     void OverrideWidget(int64_t qwidget_address);
 
 signals:
+	/// Present an image (the QImage shares the pixels of the frame image)
 	void present(const QImage &image);
 
+	/// Present an image (without copying, and keeping the frame image allocated while displayed)
+	void presentImage(std::shared_ptr<QImage> image);
+
 protected:
     //void render(openshot::OSPixelFormat format, int width, int height, int bytesPerLine, unsigned char *data);
     void render(std::shared_ptr<QImage> image);
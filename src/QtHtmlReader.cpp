@@ -55,62 +55,23 @@ QtHtmlReader::QtHtmlReader(int width, int height, int x_offset, int y_offset, Gr
 	Close();
 }
 
+// Destructor
+QtHtmlReader::~QtHtmlReader()
+{
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+}
+
 // Open reader
 void QtHtmlReader::Open()
 {
 	// Open reader if not already open
 	if (!is_open)
 	{
-		// create image
-		image = std::make_shared<QImage>(width, height, QImage::Format_RGBA8888_Premultiplied);
-		image->fill(QColor(background_color.c_str()));
-
-		//start painting
-		QPainter painter;
-		if (!painter.begin(image.get())) {
-			return;
-		}
-
-		//set background
-		painter.setBackground(QBrush(background_color.c_str()));
-
-		//draw text
-		QTextDocument text_document;
-
-		//disable redo/undo stack as not needed
-		text_document.setUndoRedoEnabled(false);
-
-		//create the HTML/CSS document
-		text_document.setTextWidth(width);
-		text_document.setDefaultStyleSheet(css.c_str());
-		text_document.setHtml(html.c_str());
-
-		int td_height = text_document.documentLayout()->documentSize().height();
-
- 		if (gravity == GRAVITY_TOP_LEFT || gravity == GRAVITY_TOP || gravity == GRAVITY_TOP_RIGHT) {
- 			painter.translate(x_offset, y_offset);
- 		} else if (gravity == GRAVITY_LEFT || gravity == GRAVITY_CENTER || gravity == GRAVITY_RIGHT) {
- 			painter.translate(x_offset, (height - td_height) / 2 + y_offset);
- 		} else if (gravity == GRAVITY_BOTTOM_LEFT || gravity == GRAVITY_BOTTOM_RIGHT || gravity == GRAVITY_BOTTOM) {
- 			painter.translate(x_offset, height - td_height + y_offset);
- 		}
-
- 		if (gravity == GRAVITY_TOP_LEFT || gravity == GRAVITY_LEFT || gravity == GRAVITY_BOTTOM_LEFT) {
- 			text_document.setDefaultTextOption(QTextOption(Qt::AlignLeft));
- 		} else if (gravity == GRAVITY_CENTER || gravity == GRAVITY_TOP || gravity == GRAVITY_BOTTOM) {
- 			text_document.setDefaultTextOption(QTextOption(Qt::AlignHCenter));
- 		} else if (gravity == GRAVITY_TOP_RIGHT || gravity == GRAVITY_RIGHT|| gravity == GRAVITY_BOTTOM_RIGHT) {
- 			text_document.setDefaultTextOption(QTextOption(Qt::AlignRight));
- 		}
-
- 		// Draw image
-		text_document.drawContents(&painter);
-
-		painter.end();
-
 		// Update image properties
 		info.has_audio = false;
 		info.has_video = true;
+		info.has_single_image = true;
 		info.file_size = 0;
 		info.vcodec = "QImage";
 		info.width = width;
@@ -142,25 +103,98 @@ void QtHtmlReader::Open()
 // Close reader
 void QtHtmlReader::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open)
 	{
-		// Mark as "closed"
+		// Mark as "closed" (while no frame is being rendered)
+		const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
 		is_open = false;
 
-		// Delete the image
-		image.reset();
+		// Delete the rendered images
+		rendered_images.clear();
 
 		info.vcodec = "";
 		info.acodec = "";
 	}
 }
 
+// Get the HTML rendered at a specific size (rendering it only once per size)
+std::shared_ptr<QImage> QtHtmlReader::get_image(QSize size)
+{
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	auto rendered = rendered_images.find(std::make_pair(size.width(), size.height()));
+	if (rendered != rendered_images.end())
+		return rendered->second;
+
+	// create image
+	auto image = std::make_shared<QImage>(size, QImage::Format_RGBA8888_Premultiplied);
+	image->fill(QColor(background_color.c_str()));
+
+	//start painting
+	QPainter painter;
+	if (painter.begin(image.get())) {
+		// Lay out and draw at the size of the reader (scaled to the size of the image)
+		painter.scale(double(size.width()) / width, double(size.height()) / height);
+
+		//set background
+		painter.setBackground(QBrush(background_color.c_str()));
+
+		//draw text
+		QTextDocument text_document;
+
+		//disable redo/undo stack as not needed
+		text_document.setUndoRedoEnabled(false);
+
+		//create the HTML/CSS document
+		text_document.setTextWidth(width);
+		text_document.setDefaultStyleSheet(css.c_str());
+		text_document.setHtml(html.c_str());
+
+		int td_height = text_document.documentLayout()->documentSize().height();
+
+		if (gravity == GRAVITY_TOP_LEFT || gravity == GRAVITY_TOP || gravity == GRAVITY_TOP_RIGHT) {
+			painter.translate(x_offset, y_offset);
+		} else if (gravity == GRAVITY_LEFT || gravity == GRAVITY_CENTER || gravity == GRAVITY_RIGHT) {
+			painter.translate(x_offset, (height - td_height) / 2 + y_offset);
+		} else if (gravity == GRAVITY_BOTTOM_LEFT || gravity == GRAVITY_BOTTOM_RIGHT || gravity == GRAVITY_BOTTOM) {
+			painter.translate(x_offset, height - td_height + y_offset);
+		}
+
+		if (gravity == GRAVITY_TOP_LEFT || gravity == GRAVITY_LEFT || gravity == GRAVITY_BOTTOM_LEFT) {
+			text_document.setDefaultTextOption(QTextOption(Qt::AlignLeft));
+		} else if (gravity == GRAVITY_CENTER || gravity == GRAVITY_TOP || gravity == GRAVITY_BOTTOM) {
+			text_document.setDefaultTextOption(QTextOption(Qt::AlignHCenter));
+		} else if (gravity == GRAVITY_TOP_RIGHT || gravity == GRAVITY_RIGHT|| gravity == GRAVITY_BOTTOM_RIGHT) {
+			text_document.setDefaultTextOption(QTextOption(Qt::AlignRight));
+		}
+
+		// Draw image
+		text_document.drawContents(&painter);
+
+		painter.end();
+	}
+
+	// Only keep a few sizes (i.e. the preview and export sizes)
+	if (rendered_images.size() >= 4)
+		rendered_images.clear();
+	rendered_images[std::make_pair(size.width(), size.height())] = image;
+
+	return image;
+}
+
 // Get an openshot::Frame object for a specific frame number of this reader.
 std::shared_ptr<Frame> QtHtmlReader::GetFrame(int64_t requested_frame)
 {
-	if (image)
+	if (is_open)
 	{
+		// Get the HTML rendered at the size needed (all frames share the same image data)
+		std::shared_ptr<QImage> image = get_image(render_size(width, height));
+
 		// Create or get frame object
 		auto image_frame = std::make_shared<Frame>(
 			requested_frame, image->size().width(), image->size().height(),
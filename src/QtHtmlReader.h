@@ -40,7 +40,9 @@
 #include <iostream>
 #include <omp.h>
 #include <stdio.h>
+#include <map>
 #include <memory>
+#include <QSize>
 #include "CacheMemory.h"
 #include "Enums.h"
 #include "Exceptions.h"
@@ -94,9 +96,12 @@ namespace openshot
 		std::string html;
 		std::string css;
 		std::string background_color;
-		std::shared_ptr<QImage> image;
+		std::map<std::pair<int, int>, std::shared_ptr<QImage>> rendered_images; ///< The HTML rendered at each size (width, height)
 		bool is_open;
 		openshot::GravityType gravity;
+
+		/// Get the HTML rendered at a specific size (rendering it only once per size)
+		std::shared_ptr<QImage> get_image(QSize size);
 	public:
 
 		/// Default constructor (blank text)
@@ -113,6 +118,9 @@ namespace openshot
 		/// @param background_color The background color of the frame image (valid values are a color string in \#RRGGBB or \#AARRGGBB notation, a CSS color name, or 'transparent')
 		QtHtmlReader(int width, int height, int x_offset, int y_offset, GravityType gravity, std::string html, std::string css, std::string background_color);
 
+		/// Destructor
+		virtual ~QtHtmlReader();
+
 		/// Close Reader
 		void Close() override;
 
@@ -120,7 +128,8 @@ namespace openshot
 		CacheBase* GetCache() override { return NULL; };
 
 		/// Get an openshot::Frame object for a specific frame number of this reader.  All numbers
-		/// return the same Frame, since they all share the same image data.
+		/// return the same image data. The HTML is rendered at the size the parent clip needs on
+		/// its timeline (i.e. the preview size), and each size is only rendered once.
 		///
 		/// @returns The requested frame (containing the image)
 		/// @param requested_frame The frame number that is requested.
@@ -55,6 +55,8 @@ QtImageReader::QtImageReader(std::string path, bool inspect_reader) : path{QStri
 
 QtImageReader::~QtImageReader()
 {
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
 }
 
 // Open image file
@@ -142,6 +144,10 @@ void QtImageReader::Open()
 // Close image file
 void QtImageReader::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open)
 	{
@@ -183,15 +189,17 @@ std::shared_ptr<Frame> QtImageReader::GetFrame(int64_t requested_frame)
 		}
 		if (parent->scale == SCALE_FIT || parent->scale == SCALE_STRETCH) {
 			// Best fit or Stretch scaling (based on max timeline size * scaling keyframes)
-			float max_scale_x = parent->scale_x.GetMaxPoint().co.Y;
-			float max_scale_y = parent->scale_y.GetMaxPoint().co.Y;
+			QSizeF max_scale = parent->GetMaxScale();
+			float max_scale_x = max_scale.width();
+			float max_scale_y = max_scale.height();
 			max_width = std::max(float(max_width), max_width * max_scale_x);
 			max_height = std::max(float(max_height), max_height * max_scale_y);
 
 		} else if (parent->scale == SCALE_CROP) {
 			// Cropping scale mode (based on max timeline size * cropped size * scaling keyframes)
-			float max_scale_x = parent->scale_x.GetMaxPoint().co.Y;
-			float max_scale_y = parent->scale_y.GetMaxPoint().co.Y;
+			QSizeF max_scale = parent->GetMaxScale();
+			float max_scale_x = max_scale.width();
+			float max_scale_y = max_scale.height();
 			QSize width_size(max_width * max_scale_x,
 							 round(max_width / (float(info.width) / float(info.height))));
 			QSize height_size(round(max_height / (float(info.height) / float(info.width))),
@@ -246,9 +254,11 @@ std::shared_ptr<Frame> QtImageReader::GetFrame(int64_t requested_frame)
 
 		if (!rendered) {
 			// We need to resize the original image to a smaller image (for performance reasons)
-			// Only do this once, to prevent tons of unneeded scaling operations
+			// Only do this once, to prevent tons of unneeded scaling operations (and format conversions,
+			// since Frame::AddImage would otherwise convert this shared image for every frame)
 			cached_image = std::make_shared<QImage>(image->scaled(
 				max_width, max_height, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+			Frame::ConvertImageInPlace(*cached_image);
 		}
 
 		// Set max size (to later determine if max_size is changed)
@@ -198,6 +198,11 @@ namespace openshot
     	return (int64_t)(VideoRenderer*)p->renderer;
     }
 
+    // Set the size of the display (frame images are scaled down before they are presented)
+    void QtPlayer::SetPresentationSize(int width, int height) {
+    	p->renderer->SetPresentationSize(width, height);
+    }
+
     // Get the Playback speed
     float QtPlayer::Speed() {
     	return speed;
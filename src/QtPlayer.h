@@ -95,6 +95,9 @@ namespace openshot
 	/// Get the Renderer pointer address (for Python to cast back into a QObject)
 	int64_t GetRendererQObject();
 
+	/// Set the size of the display in pixels, so frame images are scaled down before they are presented (0 = unknown)
+	void SetPresentationSize(int width, int height);
+
 	/// Get the Playback speed
 	float Speed();
 
@@ -60,20 +60,90 @@ void QtTextReader::SetTextBackgroundColor(std::string color) {
 	Close();
 }
 
+// Destructor
+QtTextReader::~QtTextReader()
+{
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+}
+
 // Open reader
 void QtTextReader::Open()
 {
 	// Open reader if not already open
 	if (!is_open)
 	{
-		// create image
-		image = std::make_shared<QImage>(width, height, QImage::Format_RGBA8888_Premultiplied);
-		image->fill(QColor(background_color.c_str()));
+		// Update image properties
+		info.has_audio = false;
+		info.has_video = true;
+		info.has_single_image = true;
+		info.file_size = 0;
+		info.vcodec = "QImage";
+		info.width = width;
+		info.height = height;
+		info.pixel_ratio.num = 1;
+		info.pixel_ratio.den = 1;
+		info.duration = 60 * 60 * 1;  // 1 hour duration
+		info.fps.num = 30;
+		info.fps.den = 1;
+		info.video_timebase.num = 1;
+		info.video_timebase.den = 30;
+		info.video_length = round(info.duration * info.fps.ToDouble());
 
-		QPainter painter;
-		if (!painter.begin(image.get())) {
-			return;
-		}
+		// Calculate the DAR (display aspect ratio)
+		Fraction font_size(info.width * info.pixel_ratio.num, info.height * info.pixel_ratio.den);
+
+		// Reduce size fraction
+		font_size.Reduce();
+
+		// Set the ratio based on the reduced fraction
+		info.display_ratio.num = font_size.num;
+		info.display_ratio.den = font_size.den;
+
+		// Mark as "open"
+		is_open = true;
+	}
+}
+
+// Close reader
+void QtTextReader::Close()
+{
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
+	// Close all objects, if reader is 'open'
+	if (is_open)
+	{
+		// Mark as "closed" (while no frame is being rendered)
+		const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+		is_open = false;
+
+		// Delete the rendered images
+		rendered_images.clear();
+
+		info.vcodec = "";
+		info.acodec = "";
+	}
+}
+
+// Get the text rendered at a specific size (rendering it only once per size)
+std::shared_ptr<QImage> QtTextReader::get_image(QSize size)
+{
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	auto rendered = rendered_images.find(std::make_pair(size.width(), size.height()));
+	if (rendered != rendered_images.end())
+		return rendered->second;
+
+	// create image
+	auto image = std::make_shared<QImage>(size, QImage::Format_RGBA8888_Premultiplied);
+	image->fill(QColor(background_color.c_str()));
+
+	QPainter painter;
+	if (painter.begin(image.get())) {
+		// Draw at the size of the reader (scaled to the size of the image)
+		painter.scale(double(size.width()) / width, double(size.height()) / height);
 
 		// set background
 		if (!text_background_color.empty()) {
@@ -124,60 +194,24 @@ void QtTextReader::Open()
 		painter.drawText(x_offset, y_offset, width, height, align_flag, text.c_str());
 
 		painter.end();
-
-		// Update image properties
-		info.has_audio = false;
-		info.has_video = true;
-		info.file_size = 0;
-		info.vcodec = "QImage";
-		info.width = width;
-		info.height = height;
-		info.pixel_ratio.num = 1;
-		info.pixel_ratio.den = 1;
-		info.duration = 60 * 60 * 1;  // 1 hour duration
-		info.fps.num = 30;
-		info.fps.den = 1;
-		info.video_timebase.num = 1;
-		info.video_timebase.den = 30;
-		info.video_length = round(info.duration * info.fps.ToDouble());
-
-		// Calculate the DAR (display aspect ratio)
-		Fraction font_size(info.width * info.pixel_ratio.num, info.height * info.pixel_ratio.den);
-
-		// Reduce size fraction
-		font_size.Reduce();
-
-		// Set the ratio based on the reduced fraction
-		info.display_ratio.num = font_size.num;
-		info.display_ratio.den = font_size.den;
-
-		// Mark as "open"
-		is_open = true;
 	}
-}
-
-// Close reader
-void QtTextReader::Close()
-{
-	// Close all objects, if reader is 'open'
-	if (is_open)
-	{
-		// Mark as "closed"
-		is_open = false;
 
-		// Delete the image
-		image.reset();
+	// Only keep a few sizes (i.e. the preview and export sizes)
+	if (rendered_images.size() >= 4)
+		rendered_images.clear();
+	rendered_images[std::make_pair(size.width(), size.height())] = image;
 
-		info.vcodec = "";
-		info.acodec = "";
-	}
+	return image;
 }
 
 // Get an openshot::Frame object for a specific frame number of this reader.
 std::shared_ptr<Frame> QtTextReader::GetFrame(int64_t requested_frame)
 {
-	if (image)
+	if (is_open)
 	{
+		// Get the text rendered at the size needed (all frames share the same image data)
+		std::shared_ptr<QImage> image = get_image(render_size(width, height));
+
 		// Create or get frame object
 		auto image_frame = std::make_shared<Frame>(
 			requested_frame, image->size().width(), image->size().height(),
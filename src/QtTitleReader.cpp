@@ -0,0 +1,362 @@
+/**
+ * @file
+ * @brief Source file for QtTitleReader class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QtTitleReader.h"
+#include <algorithm>
+#include <QImage>
+#include <QPainter>
+#include <QTextLayout>
+
+using namespace openshot;
+
+/// Default constructor (blank text)
+QtTitleReader::QtTitleReader() : QtTitleReader::QtTitleReader(1024, 768, GRAVITY_CENTER, "", QFont("Arial", 10), "#ffffff", "#000000") {};
+
+QtTitleReader::QtTitleReader(int width, int height, GravityType gravity, std::string text, QFont font, std::string text_color, std::string background_color)
+: width(width), height(height), text(text), font(font), background_color(background_color), is_open(false), gravity(gravity),
+  is_layout_dirty(true), glyph_count(0), last_revealed(0),
+  location_x(0.0), location_y(0.0), scale(1.0), rotation(0.0), reveal(1.0), color(text_color)
+{
+	// Open and Close the reader, to populate it's attributes (such as height, width, etc...)
+	Open();
+	Close();
+}
+
+// Destructor
+QtTitleReader::~QtTitleReader()
+{
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+}
+
+// Open reader
+void QtTitleReader::Open()
+{
+	// Open reader if not already open
+	if (!is_open)
+	{
+		// Update image properties
+		info.has_audio = false;
+		info.has_video = true;
+		info.file_size = 0;
+		info.vcodec = "QImage";
+		info.width = width;
+		info.height = height;
+		info.pixel_ratio.num = 1;
+		info.pixel_ratio.den = 1;
+		info.duration = 60 * 60 * 1;  // 1 hour duration
+		info.fps.num = 30;
+		info.fps.den = 1;
+		info.video_timebase.num = 1;
+		info.video_timebase.den = 30;
+		info.video_length = round(info.duration * info.fps.ToDouble());
+
+		// Calculate the DAR (display aspect ratio)
+		Fraction size(info.width * info.pixel_ratio.num, info.height * info.pixel_ratio.den);
+
+		// Reduce size fraction
+		size.Reduce();
+
+		// Set the ratio based on the reduced fraction
+		info.display_ratio.num = size.num;
+		info.display_ratio.den = size.den;
+
+		// Mark as "open"
+		is_open = true;
+	}
+}
+
+// Close reader
+void QtTitleReader::Close()
+{
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
+	// Close all objects, if reader is 'open'
+	if (is_open)
+	{
+		// Mark as "closed"
+		is_open = false;
+
+		// Delete the layout and the last rendered image
+		const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+		glyph_runs.clear();
+		is_layout_dirty = true;
+		last_image.reset();
+
+		info.vcodec = "";
+		info.acodec = "";
+	}
+}
+
+// Lay out the text into glyph runs
+void QtTitleReader::update_layout()
+{
+	// Horizontal alignment (map between OpenShot and Qt)
+	QTextOption option;
+	option.setWrapMode(QTextOption::WordWrap);
+	if (gravity == GRAVITY_TOP_LEFT || gravity == GRAVITY_LEFT || gravity == GRAVITY_BOTTOM_LEFT)
+		option.setAlignment(Qt::AlignLeft);
+	else if (gravity == GRAVITY_TOP || gravity == GRAVITY_CENTER || gravity == GRAVITY_BOTTOM)
+		option.setAlignment(Qt::AlignHCenter);
+	else
+		option.setAlignment(Qt::AlignRight);
+
+	// Lay out the lines (wrapped at the width of the reader)
+	QTextLayout layout(QString::fromStdString(text).replace('\n', QChar::LineSeparator), font);
+	layout.setTextOption(option);
+	layout.beginLayout();
+	qreal text_height = 0.0;
+	while (true) {
+		QTextLine line = layout.createLine();
+		if (!line.isValid())
+			break;
+		line.setLineWidth(width);
+		line.setPosition(QPointF(0.0, text_height));
+		text_height += line.height();
+	}
+	layout.endLayout();
+
+	// Vertical alignment
+	if (gravity == GRAVITY_TOP_LEFT || gravity == GRAVITY_TOP || gravity == GRAVITY_TOP_RIGHT)
+		text_origin = QPointF(0.0, 0.0);
+	else if (gravity == GRAVITY_LEFT || gravity == GRAVITY_CENTER || gravity == GRAVITY_RIGHT)
+		text_origin = QPointF(0.0, (height - text_height) / 2.0);
+	else
+		text_origin = QPointF(0.0, height - text_height);
+
+	// Keep the glyph runs (and their bounds)
+	glyph_runs.clear();
+	glyph_count = 0;
+	text_bounds = QRectF();
+	for (const QGlyphRun &run : layout.glyphRuns()) {
+		glyph_runs.push_back(run);
+		glyph_count += run.glyphIndexes().size();
+		text_bounds = text_bounds.united(run.boundingRect().translated(text_origin));
+	}
+
+	is_layout_dirty = false;
+}
+
+// Draw the first few glyphs of the text (in layout order)
+void QtTitleReader::draw_glyphs(QPainter &painter, int revealed)
+{
+	int remaining = revealed;
+	for (const QGlyphRun &run : glyph_runs) {
+		if (remaining <= 0)
+			break;
+
+		int run_size = run.glyphIndexes().size();
+		if (remaining >= run_size)
+			painter.drawGlyphRun(text_origin, run);
+		else {
+			// Only part of this run is revealed
+			QGlyphRun partial_run(run);
+			partial_run.setGlyphIndexes(run.glyphIndexes().mid(0, remaining));
+			partial_run.setPositions(run.positions().mid(0, remaining));
+			painter.drawGlyphRun(text_origin, partial_run);
+		}
+		remaining -= run_size;
+	}
+}
+
+// Get an openshot::Frame object for a specific frame number of this reader.
+std::shared_ptr<Frame> QtTitleReader::GetFrame(int64_t requested_frame)
+{
+	if (!is_open) {
+		// return empty frame
+		auto image_frame = std::make_shared<Frame>(1, 640, 480, background_color, 0, 2);
+
+		// return frame object
+		return image_frame;
+	}
+
+	// Create a scoped lock, allowing only a single thread to run the following code at one time
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	if (is_layout_dirty)
+		update_layout();
+
+	// Get the keyframe values of this frame
+	QPointF center = text_bounds.center();
+	QTransform transform;
+	transform.translate(location_x.GetValue(requested_frame) + center.x(), location_y.GetValue(requested_frame) + center.y());
+	transform.rotate(rotation.GetValue(requested_frame));
+	transform.scale(scale.GetValue(requested_frame), scale.GetValue(requested_frame));
+	transform.translate(-center.x(), -center.y());
+
+	QColor text_color(QString::fromStdString(color.GetColorHex(requested_frame)));
+	text_color.setAlpha(std::min(255, std::max(0, int(color.alpha.GetValue(requested_frame)))));
+
+	double reveal_value = std::min(1.0, std::max(0.0, reveal.GetValue(requested_frame)));
+	int revealed = round(glyph_count * reveal_value);
+
+	// Region of the text (with a margin for antialiasing)
+	QRect bounds = transform.mapRect(text_bounds).toAlignedRect().adjusted(-2, -2, 2, 2).intersected(QRect(0, 0, width, height));
+
+	if (!last_image || transform != last_transform || text_color != last_color || revealed != last_revealed) {
+		// Start from the last rendered image, and only draw the regions which changed
+		std::shared_ptr<QImage> image;
+		QRect dirty;
+		if (last_image) {
+			image = std::make_shared<QImage>(last_image->copy());
+			dirty = bounds.united(last_bounds);
+		} else {
+			image = std::make_shared<QImage>(width, height, QImage::Format_RGBA8888_Premultiplied);
+			dirty = image->rect();
+		}
+
+		QPainter painter;
+		if (painter.begin(image.get())) {
+			painter.setClipRect(dirty);
+
+			// Clear the dirty region to the background color
+			painter.setCompositionMode(QPainter::CompositionMode_Source);
+			painter.fillRect(dirty, QColor(background_color.c_str()));
+			painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+			// Draw the cached glyph runs
+			painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing, true);
+			painter.setTransform(transform);
+			painter.setPen(text_color);
+			draw_glyphs(painter, revealed);
+
+			painter.end();
+		}
+
+		last_image = image;
+		last_transform = transform;
+		last_color = text_color;
+		last_revealed = revealed;
+		last_bounds = bounds;
+	}
+
+	// Create frame object (sharing the image data of frames without changes)
+	auto image_frame = std::make_shared<Frame>(requested_frame, width, height, background_color, 0, 2);
+	image_frame->AddImage(last_image);
+
+	// return frame object
+	return image_frame;
+}
+
+// Generate JSON string of this object
+std::string QtTitleReader::Json() const {
+
+	// Return formatted string
+	return JsonValue().toStyledString();
+}
+
+// Generate Json::Value for this object
+Json::Value QtTitleReader::JsonValue() const {
+
+	// Create root json object
+	Json::Value root = ReaderBase::JsonValue(); // get parent properties
+	root["type"] = "QtTitleReader";
+	root["width"] = width;
+	root["height"] = height;
+	root["text"] = text;
+	root["font"] = font.toString().toStdString();
+	root["background_color"] = background_color;
+	root["gravity"] = gravity;
+	root["location_x"] = location_x.JsonValue();
+	root["location_y"] = location_y.JsonValue();
+	root["scale"] = scale.JsonValue();
+	root["rotation"] = rotation.JsonValue();
+	root["reveal"] = reveal.JsonValue();
+	root["color"] = color.JsonValue();
+
+	// return JsonValue
+	return root;
+}
+
+// Load JSON string into this object
+void QtTitleReader::SetJson(const std::string value) {
+
+	// Parse JSON string into JSON objects
+	try
+	{
+		const Json::Value root = openshot::stringToJson(value);
+		// Set all values that match
+		SetJsonValue(root);
+	}
+	catch (const std::exception& e)
+	{
+		// Error parsing JSON (or missing keys)
+		throw InvalidJSON("JSON is invalid (missing keys or invalid data types)");
+	}
+}
+
+// Load Json::Value into this object
+void QtTitleReader::SetJsonValue(const Json::Value root) {
+
+	// Set parent data
+	ReaderBase::SetJsonValue(root);
+
+	// Set data from Json (if key is found)
+	if (!root["width"].isNull())
+		width = root["width"].asInt();
+	if (!root["height"].isNull())
+		height = root["height"].asInt();
+	if (!root["text"].isNull())
+		text = root["text"].asString();
+	if (!root["font"].isNull())
+		font.fromString(QString::fromStdString(root["font"].asString()));
+	if (!root["background_color"].isNull())
+		background_color = root["background_color"].asString();
+	if (!root["gravity"].isNull())
+		gravity = (GravityType) root["gravity"].asInt();
+	if (!root["location_x"].isNull())
+		location_x.SetJsonValue(root["location_x"]);
+	if (!root["location_y"].isNull())
+		location_y.SetJsonValue(root["location_y"]);
+	if (!root["scale"].isNull())
+		scale.SetJsonValue(root["scale"]);
+	if (!root["rotation"].isNull())
+		rotation.SetJsonValue(root["rotation"]);
+	if (!root["reveal"].isNull())
+		reveal.SetJsonValue(root["reveal"]);
+	if (!root["color"].isNull())
+		color.SetJsonValue(root["color"]);
+
+	// Lay out the text again, and render the next frame from scratch
+	{
+		const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+		is_layout_dirty = true;
+		last_image.reset();
+	}
+
+	// Re-Open path, and re-init everything (if needed)
+	if (is_open)
+	{
+		Close();
+		Open();
+	}
+}
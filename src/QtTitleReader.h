@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief Header file for QtTitleReader class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPENSHOT_QT_TITLE_READER_H
+#define OPENSHOT_QT_TITLE_READER_H
+
+#include "ReaderBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <QFont>
+#include <QColor>
+#include <QGlyphRun>
+#include <QRect>
+#include <QTransform>
+#include "CacheMemory.h"
+#include "Color.h"
+#include "Enums.h"
+#include "Exceptions.h"
+#include "KeyFrame.h"
+
+class QImage;
+class QPainter;
+
+namespace openshot
+{
+	// Forward decls
+	class CacheBase;
+
+	/**
+	 * @brief This class uses Qt libraries, to create frames with animated titles, and return
+	 * openshot::Frame objects.
+	 *
+	 * The text is laid out only once (into glyph runs), and the keyframes of the reader (position,
+	 * scale, rotation, color and reveal) are applied to those glyph runs for each frame. Only the
+	 * region which changed since the previously rendered frame is drawn again, and frames without
+	 * changes share the same image. This makes animated titles (i.e. lower thirds) much cheaper than
+	 * laying out the text again for each frame.
+	 *
+	 * @code
+	 * // Any application using this class must instantiate either QGuiApplication or QApplication
+	 * QApplication a(argc, argv);
+	 *
+	 * // Create a reader with a title which slides in from the left, while revealing its letters
+	 * QtTitleReader r(1280, 720, GRAVITY_BOTTOM_LEFT, "Lower Third", QFont("Arial", 40), "#ffffff", "transparent");
+	 * r.location_x.AddPoint(1, -400);
+	 * r.location_x.AddPoint(30, 40);
+	 * r.reveal.AddPoint(1, 0.0);
+	 * r.reveal.AddPoint(30, 1.0);
+	 * r.Open();
+	 *
+	 * std::shared_ptr<Frame> f = r.GetFrame(15);
+	 * r.Close();
+	 * @endcode
+	 */
+	class QtTitleReader : public ReaderBase
+	{
+	private:
+		int width;
+		int height;
+		std::string text;
+		QFont font;
+		std::string background_color;
+		bool is_open;
+		openshot::GravityType gravity;
+
+		// Layout of the text (only updated when the text, font, size or gravity changes)
+		bool is_layout_dirty; ///< Does the text need to be laid out again
+		std::vector<QGlyphRun> glyph_runs; ///< The laid out glyph runs of the text
+		int glyph_count; ///< The total number of glyphs (used by reveal)
+		QPointF text_origin; ///< The position of the laid out text (based on the gravity)
+		QRectF text_bounds; ///< The bounding rectangle of the glyphs (at the text origin)
+
+		// The previously rendered frame (the next frame only draws the regions which changed)
+		std::shared_ptr<QImage> last_image; ///< The last rendered image
+		QTransform last_transform; ///< The transform of the last rendered image
+		QColor last_color; ///< The color of the last rendered image
+		int last_revealed; ///< The number of revealed glyphs of the last rendered image
+		QRect last_bounds; ///< The region of the text in the last rendered image
+
+		/// Lay out the text into glyph runs
+		void update_layout();
+
+		/// Draw the first few glyphs of the text (in layout order)
+		void draw_glyphs(QPainter &painter, int revealed);
+
+	public:
+		openshot::Keyframe location_x; ///< Curve representing the X offset of the text in pixels
+		openshot::Keyframe location_y; ///< Curve representing the Y offset of the text in pixels
+		openshot::Keyframe scale; ///< Curve representing the scale of the text (around its center, 1.0 = 100%)
+		openshot::Keyframe rotation; ///< Curve representing the rotation of the text in degrees (around its center)
+		openshot::Keyframe reveal; ///< Curve representing the revealed portion of the glyphs (0.0 = none, 1.0 = all)
+		openshot::Color color; ///< Curves representing the color (and alpha) of the text
+
+		/// Default constructor (blank text)
+		QtTitleReader();
+
+		/// @brief Constructor for QtTitleReader with all parameters.
+		/// @param width The width of the requested openshot::Frame (and the width used to wrap the text)
+		/// @param height The height of the requested openshot::Frame
+		/// @param gravity The alignment / gravity of the text
+		/// @param text The text you want to generate / display
+		/// @param font The font of the text
+		/// @param text_color The color of the text (valid values are a color string in \#RRGGBB notation)
+		/// @param background_color The background color of the frame image (valid values are a color string in \#RRGGBB or \#AARRGGBB notation, a CSS color name, or 'transparent')
+		QtTitleReader(int width, int height, GravityType gravity, std::string text, QFont font, std::string text_color, std::string background_color);
+
+		/// Destructor
+		virtual ~QtTitleReader();
+
+		/// Close Reader
+		void Close() override;
+
+		/// Get the cache object used by this reader (always returns NULL for this object)
+		CacheBase* GetCache() override { return NULL; };
+
+		/// Get an openshot::Frame object for a specific frame number of this reader. Frames without
+		/// changes share the same image data.
+		///
+		/// @returns The requested frame (containing the image)
+		/// @param requested_frame The frame number that is requested.
+		std::shared_ptr<openshot::Frame> GetFrame(int64_t requested_frame) override;
+
+		/// Determine if reader is open or closed
+		bool IsOpen() override { return is_open; };
+
+		/// Return the type name of the class
+		std::string Name() override { return "QtTitleReader"; };
+
+		/// Get and Set JSON methods
+		std::string Json() const override; ///< Generate JSON string of this object
+		void SetJson(const std::string value) override; ///< Load JSON string into this object
+		Json::Value JsonValue() const override; ///< Generate Json::Value for this object
+		void SetJsonValue(const Json::Value root) override; ///< Load Json::Value into this object
+
+		/// Open Reader - which is called by the constructor automatically
+		void Open() override;
+	};
+
+}
+
+#endif
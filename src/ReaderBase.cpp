@@ -29,6 +29,8 @@
  */
 
 #include "ReaderBase.h"
+#include "Clip.h"
+#include "FrameRequestQueue.h"
 
 using namespace openshot;
 
@@ -64,6 +66,15 @@ ReaderBase::ReaderBase()
 
 	// Init parent clip
 	clip = NULL;
+
+	// Init executor (NULL uses the default executor)
+	executor = NULL;
+
+	// Init settings (NULL uses the global settings)
+	settings = NULL;
+
+	// Init streaming (frames can be requested in any order)
+	streaming = false;
 }
 
 // Display file information
@@ -259,3 +270,127 @@ openshot::ClipBase* ReaderBase::ParentClip() {
 void ReaderBase::ParentClip(openshot::ClipBase* new_clip) {
 	clip = new_clip;
 }
+
+// Get the size to render a generated image at (the size the parent clip needs, no larger than the reader itself)
+QSize ReaderBase::render_size(int reader_width, int reader_height)
+{
+	QSize size(reader_width, reader_height);
+
+	Clip* parent = dynamic_cast<Clip*>(ParentClip());
+	if (parent && parent->ParentTimeline() && parent->scale != SCALE_NONE) {
+		// Timeline preview size * the largest scaling keyframes
+		QSizeF max_scale = parent->GetMaxScale();
+		QSize needed(round(parent->ParentTimeline()->preview_width * std::max(1.0, max_scale.width())),
+					 round(parent->ParentTimeline()->preview_height * std::max(1.0, max_scale.height())));
+
+		if (parent->scale == SCALE_STRETCH)
+			size = needed;
+		else
+			size.scale(needed, parent->scale == SCALE_CROP ? Qt::KeepAspectRatioByExpanding : Qt::KeepAspectRatio);
+
+		// Never render larger than the reader
+		if (size.width() > reader_width || size.height() > reader_height)
+			size = QSize(reader_width, reader_height);
+	}
+
+	return size;
+}
+
+// Get the executor used by the parallel sections of this reader
+openshot::Executor* ReaderBase::GetExecutor() {
+	if (executor)
+		return executor;
+	else
+		return Executor::Default();
+}
+
+// Set the executor used by the parallel sections of this reader
+void ReaderBase::SetExecutor(openshot::Executor* new_executor) {
+	executor = new_executor;
+}
+
+// Get the settings used by this reader
+openshot::Settings* ReaderBase::GetSettings() {
+	if (settings)
+		return settings;
+	else
+		return Settings::Instance();
+}
+
+// Set the settings used by this reader
+void ReaderBase::SetSettings(openshot::Settings* new_settings) {
+	settings = new_settings;
+}
+
+// Set whether the frames of this reader are requested once, in order
+void ReaderBase::SetStreaming(bool new_streaming) {
+	streaming = new_streaming;
+}
+
+// Remove the frames before a requested frame from a cache (only when streaming)
+void ReaderBase::release_streamed_frames(openshot::CacheBase* cache, int64_t requested_frame) {
+	if (!streaming || !cache)
+		return;
+
+	// Keep enough frames for each thread of a parallel section (which request nearby frames)
+	int64_t last_released_frame = requested_frame - 2 * GetExecutor()->ThreadCount() - 1;
+	if (last_released_frame >= 1)
+		cache->Remove(1, last_released_frame);
+}
+
+// Get a range of sequential frames (one frame at a time, unless overridden by a derived reader)
+std::vector<std::shared_ptr<Frame>> ReaderBase::GetFrames(int64_t start, int64_t count) {
+	std::vector<std::shared_ptr<Frame>> frames;
+	if (count <= 0)
+		return frames;
+
+	frames.reserve(count);
+	for (int64_t number = start; number < start + count; number++)
+		frames.push_back(GetFrame(number));
+	return frames;
+}
+
+// Request a frame without blocking (returning a future)
+std::future<std::shared_ptr<Frame>> ReaderBase::RequestFrame(int64_t number) {
+	auto request = std::make_shared<std::packaged_task<std::shared_ptr<Frame>()>>(
+		[this, number]() { return GetFrame(number); });
+	std::future<std::shared_ptr<Frame>> frame = request->get_future();
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("ReaderBase::RequestFrame", "number", number);
+
+	FrameRequestQueue::Instance()->Add([request]() { (*request)(); }, this);
+	return frame;
+}
+
+// Request a frame without blocking (calling a function when ready)
+void ReaderBase::RequestFrame(int64_t number, std::function<void(std::shared_ptr<Frame>)> callback) {
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("ReaderBase::RequestFrame (with callback)", "number", number);
+
+	FrameRequestQueue::Instance()->Add([this, number, callback]() {
+		std::shared_ptr<Frame> frame;
+		try {
+			frame = GetFrame(number);
+		} catch (const std::exception& e) {
+			// Debug output
+			ZmqLogger::Instance()->AppendDebugMethod("ReaderBase::RequestFrame (failed)", "number", number);
+		}
+		callback(frame);
+	}, this);
+}
+
+// Drop the frame requests of this reader which have not started yet
+void ReaderBase::CancelRequests() {
+	FrameRequestQueue::Instance()->Cancel(this);
+}
+
+// Drop the waiting frame requests, and wait for the running requests of this reader
+void ReaderBase::wait_for_requests() {
+	FrameRequestQueue::Instance()->Cancel(this, true);
+}
+
+// Destructor
+ReaderBase::~ReaderBase() {
+	wait_for_requests();
+}
@@ -36,13 +36,19 @@
 #include <memory>
 #include <cstdlib>
 #include <sstream>
+#include <vector>
+#include <future>
+#include <functional>
 #include "CacheMemory.h"
 #include "ChannelLayouts.h"
 #include "ClipBase.h"
+#include "Executor.h"
 #include "Fraction.h"
 #include "Frame.h"
 #include "Json.h"
+#include "Settings.h"
 #include "ZmqLogger.h"
+#include <QSize>
 #include <QString>
 #include <QGraphicsItem>
 #include <QGraphicsScene>
@@ -101,6 +107,21 @@ namespace openshot
 		juce::CriticalSection getFrameCriticalSection;
 		juce::CriticalSection processingCriticalSection;
 		openshot::ClipBase* clip; ///< Pointer to the parent clip instance (if any)
+		openshot::Executor* executor; ///< Pointer to the executor of this reader (or NULL for the default executor)
+		openshot::Settings* settings; ///< Pointer to the settings of this reader (or NULL for the global settings)
+		bool streaming; ///< Are the frames of this reader requested once, in order (i.e. during an export)
+
+		/// Remove the frames before a requested frame from a cache (only when streaming). A short window of
+		/// frames is kept behind the requested frame, for parallel requests and for readers which look back.
+		void release_streamed_frames(openshot::CacheBase* cache, int64_t requested_frame);
+
+		/// Drop the waiting frame requests, and wait for the running requests of this reader. Derived readers
+		/// call this at the start of their destructor (before their members are destroyed).
+		void wait_for_requests();
+
+		/// Get the size to render a generated image at (the size the parent clip needs on its timeline,
+		/// no larger than the size of the reader itself)
+		QSize render_size(int reader_width, int reader_height);
 
 	public:
 
@@ -116,6 +137,30 @@ namespace openshot
 		/// Set parent clip object of this reader
 		void ParentClip(openshot::ClipBase* new_clip);
 
+		/// Get the executor used by the parallel sections of this reader
+		openshot::Executor* GetExecutor();
+
+		/// Set the executor used by the parallel sections of this reader (and any readers it contains).
+		/// You must manage the lifecycle of the executor (this reader will not delete it for you).
+		virtual void SetExecutor(openshot::Executor* new_executor);
+
+		/// Get the settings used by this reader (its own settings, or the global settings)
+		openshot::Settings* GetSettings();
+
+		/// Set the settings used by this reader (and any readers it contains), overriding the global
+		/// settings (see Settings::Create). You must manage the lifecycle of the settings object.
+		virtual void SetSettings(openshot::Settings* new_settings);
+
+		/// Get whether the frames of this reader are requested once, in order (see SetStreaming)
+		bool GetStreaming() { return streaming; };
+
+		/// @brief Set whether the frames of this reader are requested once, in order (and any readers it contains)
+		///
+		/// When streaming (i.e. FFmpegWriter::WriteFrame with a reader), frames are never requested again after
+		/// a later frame is requested. The caches of the reader only keep a short window of frames behind the
+		/// requested frame, so the memory used by a long export stays flat.
+		virtual void SetStreaming(bool new_streaming);
+
 		/// Close the reader (and any resources it was consuming)
 		virtual void Close() = 0;
 
@@ -133,6 +178,38 @@ namespace openshot
 		/// @param[in] number The frame number that is requested.
 		virtual std::shared_ptr<openshot::Frame> GetFrame(int64_t number) = 0;
 
+		/// Get a range of sequential openshot::Frame objects. Readers which can decode or render
+		/// a range more efficiently in a single pass (instead of one frame at a time) override
+		/// this method. By default, this simply calls GetFrame() for each frame number.
+		///
+		/// @returns The requested frames of video (in order)
+		/// @param[in] start The first frame number that is requested.
+		/// @param[in] count The number of frames requested.
+		virtual std::vector<std::shared_ptr<openshot::Frame>> GetFrames(int64_t start, int64_t count);
+
+#ifndef SWIG
+		/// Request a frame without blocking. The frame is generated (by calling GetFrame) on a
+		/// worker thread of the FrameRequestQueue, so many requests can be in flight at once,
+		/// and they can complete in any order. The reader must remain open (and allocated)
+		/// until all of its requests have completed.
+		///
+		/// @returns A future, which receives the requested frame (or the exception thrown by GetFrame)
+		/// @param[in] number The frame number that is requested.
+		std::future<std::shared_ptr<openshot::Frame>> RequestFrame(int64_t number);
+
+		/// Request a frame without blocking, and call a function (on a worker thread) when it is ready.
+		/// If GetFrame throws an exception, the callback receives an empty pointer.
+		///
+		/// @param[in] number The frame number that is requested.
+		/// @param[in] callback The function which receives the requested frame
+		void RequestFrame(int64_t number, std::function<void(std::shared_ptr<openshot::Frame>)> callback);
+#endif
+
+		/// Drop the frame requests of this reader which have not started yet (Close also waits for the running
+		/// requests). The futures of dropped requests receive a std::future_error (broken promise), and their
+		/// callbacks are not called.
+		void CancelRequests();
+
 		/// Determine if reader is open or closed
 		virtual bool IsOpen() = 0;
 
@@ -148,7 +225,8 @@ namespace openshot
 		/// Open the reader (and start consuming resources, such as images or video files)
 		virtual void Open() = 0;
 
-		virtual ~ReaderBase() = default;
+		/// Destructor (drops the waiting frame requests, and waits for the running requests of this reader)
+		virtual ~ReaderBase();
 	};
 
 }
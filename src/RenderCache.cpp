@@ -0,0 +1,401 @@
+/**
+ * @file
+ * @brief Source file for RenderCache class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RenderCache.h"
+#include "Clip.h"
+#include "Timeline.h"
+#include "ZmqLogger.h"
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <set>
+#include <QFile>
+#include <QTextStream>
+
+using namespace openshot;
+
+// Constructor
+RenderCache::RenderCache(Timeline* timeline, std::string cache_path) :
+	Thread("render-cache"), timeline(timeline), version(0)
+{
+	QString qpath;
+	if (!cache_path.empty()) {
+		// Init QDir with cache directory
+		qpath = QString(cache_path.c_str());
+
+	} else {
+		// Init QDir with user's temp directory
+		qpath = QDir::tempPath() + QString("/render-cache/");
+	}
+
+	// Create cache directory (if needed)
+	path = QDir(qpath);
+	if (!path.exists())
+		path.mkpath(qpath);
+
+	// Find ranges rendered by a previous session
+	load_ranges();
+}
+
+// Destructor
+RenderCache::~RenderCache()
+{
+	// Stop the background thread (after the current frame)
+	Stop();
+
+	// Delete cache objects (the rendered files remain on disk)
+	for (auto& range : ranges)
+		delete range.frames;
+	ranges.clear();
+}
+
+// Find the rendered ranges saved in the folder
+void RenderCache::load_ranges()
+{
+	const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+
+	for (const QFileInfo& range_folder : path.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+		// Read the description of the range (only saved once the range is completely rendered)
+		QFile manifest_file(range_folder.absoluteFilePath() + "/range.json");
+		if (!manifest_file.open(QIODevice::ReadOnly))
+			continue;
+
+		try
+		{
+			const Json::Value manifest = openshot::stringToJson(manifest_file.readAll().toStdString());
+
+			RenderedRange range;
+			range.start = manifest["start"].asInt64();
+			range.end = manifest["end"].asInt64();
+			range.fingerprint = manifest["fingerprint"].asString();
+			range.folder = range_folder.absoluteFilePath();
+			range.frames = new CacheDisk(range_folder.absoluteFilePath().toStdString(), "png", 1.0, 1.0);
+			range.frames->Scan();
+			range.valid = false;
+			ranges.push_back(range);
+		}
+		catch (const std::exception& e)
+		{
+			// Skip invalid range descriptions
+			ZmqLogger::Instance()->AppendDebugMethod("RenderCache::load_ranges (invalid range.json)");
+		}
+	}
+}
+
+// Compare the fingerprints of the rendered ranges which overlap a range of frames
+void RenderCache::verify_ranges(int64_t start_frame, int64_t end_frame)
+{
+	// Find the ranges which overlap. These are compared every time (the timeline keeps the fingerprint
+	// of each range until it changes, so this is only expensive after a change).
+	std::set<std::pair<int64_t, int64_t>> spans;
+	{
+		const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+		for (const auto& range : ranges)
+			if (range.start <= end_frame && range.end >= start_frame)
+				spans.insert(std::make_pair(range.start, range.end));
+	}
+	if (spans.empty())
+		return;
+
+	// Generate the current fingerprints (without holding the lock, since this locks the timeline)
+	std::map<std::pair<int64_t, int64_t>, std::string> fingerprints;
+	for (const auto& span : spans)
+		fingerprints[span] = timeline->Fingerprint(span.first, span.second);
+
+	// Update the ranges
+	const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+	for (auto& range : ranges) {
+		auto fingerprint = fingerprints.find(std::make_pair(range.start, range.end));
+		if (fingerprint != fingerprints.end())
+			range.valid = (range.fingerprint == fingerprint->second);
+	}
+}
+
+// Get a pre-rendered frame
+std::shared_ptr<Frame> RenderCache::GetFrame(int64_t frame_number)
+{
+	verify_ranges(frame_number, frame_number);
+
+	const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+	for (const auto& range : ranges) {
+		if (range.valid && range.start <= frame_number && range.end >= frame_number) {
+			std::shared_ptr<Frame> frame = range.frames->GetFrame(frame_number);
+			if (frame)
+				return frame;
+		}
+	}
+
+	// No valid frame found
+	return std::shared_ptr<Frame>();
+}
+
+// Is a range of frames rendered (and still valid)
+bool RenderCache::IsRendered(int64_t start_frame, int64_t end_frame)
+{
+	verify_ranges(start_frame, end_frame);
+
+	const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+	for (const auto& range : ranges)
+		if (range.valid && range.start <= start_frame && range.end >= end_frame)
+			return true;
+
+	return false;
+}
+
+// Queue a range of frames to be rendered in the background
+void RenderCache::AddRange(int64_t start_frame, int64_t end_frame)
+{
+	if (start_frame < 1)
+		start_frame = 1;
+	if (end_frame < start_frame)
+		return;
+
+	{
+		const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+		pending.push_back(std::make_pair(start_frame, end_frame));
+	}
+
+	// Start (or wake up) the background thread
+	if (!isThreadRunning())
+		startThread(1);
+	notify();
+}
+
+// Queue all heavy ranges of the timeline to be rendered in the background
+int RenderCache::AddHeavyRanges(int min_cost)
+{
+	std::list<Clip*> clips = timeline->Clips();
+	std::list<EffectBase*> effects = timeline->Effects();
+	double fps = timeline->info.fps.ToDouble();
+
+	// The cost can only change where a clip or effect starts or ends
+	std::set<int64_t> boundaries;
+	for (auto clip : clips) {
+		boundaries.insert((int64_t) round(clip->Position() * fps) + 1);
+		boundaries.insert((int64_t) round((clip->Position() + clip->Duration()) * fps) + 2);
+	}
+	for (auto effect : effects) {
+		boundaries.insert((int64_t) round(effect->Position() * fps) + 1);
+		boundaries.insert((int64_t) round((effect->Position() + effect->Duration()) * fps) + 2);
+	}
+
+	// Calculate the cost of each segment between boundaries, and queue the heavy ones
+	int number_of_ranges = 0;
+	int64_t heavy_start = -1;
+	int64_t heavy_end = -1;
+	for (auto boundary = boundaries.begin(); boundary != boundaries.end(); ++boundary) {
+		auto next_boundary = std::next(boundary);
+		if (next_boundary == boundaries.end())
+			break;
+		int64_t segment_start = *boundary;
+		int64_t segment_end = *next_boundary - 1;
+
+		int cost = 0;
+		for (auto clip : clips) {
+			long clip_start_position = round(clip->Position() * fps) + 1;
+			long clip_end_position = round((clip->Position() + clip->Duration()) * fps) + 1;
+			if (clip_start_position <= segment_start && clip_end_position >= segment_start &&
+				clip->Reader() && clip->Reader()->info.has_video)
+				cost += 1 + clip->Effects().size();
+		}
+		for (auto effect : effects) {
+			long effect_start_position = round(effect->Position() * fps) + 1;
+			long effect_end_position = round((effect->Position() + effect->Duration()) * fps) + 1;
+			if (effect_start_position <= segment_start && effect_end_position >= segment_start)
+				cost += 1;
+		}
+
+		if (cost >= min_cost) {
+			// Heavy segment (join with the previous heavy segment, if any)
+			if (heavy_start == -1)
+				heavy_start = segment_start;
+			heavy_end = segment_end;
+
+		} else if (heavy_start != -1) {
+			AddRange(heavy_start, heavy_end);
+			number_of_ranges++;
+			heavy_start = -1;
+		}
+	}
+
+	// Queue the last heavy range (which lasts until the end of the timeline)
+	if (heavy_start != -1) {
+		AddRange(heavy_start, heavy_end);
+		number_of_ranges++;
+	}
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("RenderCache::AddHeavyRanges", "min_cost", min_cost, "number_of_ranges", number_of_ranges);
+
+	return number_of_ranges;
+}
+
+// Stop the background thread
+void RenderCache::Stop()
+{
+	signalThreadShouldExit();
+	notify();
+	stopThread(-1);
+}
+
+// Remove all rendered ranges (and their files)
+void RenderCache::Clear()
+{
+	{
+		const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+		pending.clear();
+	}
+
+	// Cancel the range being rendered (if any), and wait for it to stop
+	Invalidate();
+	const GenericScopedLock<CriticalSection> rendering_lock(renderingCriticalSection);
+
+	const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+	for (auto& range : ranges) {
+		range.frames->Clear();
+		QDir(range.folder).removeRecursively();
+		delete range.frames;
+	}
+	ranges.clear();
+}
+
+// Render a range of frames now (on the calling thread)
+bool RenderCache::Render(int64_t start_frame, int64_t end_frame)
+{
+	// Only render one range at a time (Clear waits for this)
+	const GenericScopedLock<CriticalSection> rendering_lock(renderingCriticalSection);
+
+	int64_t render_version = version;
+	std::string fingerprint = timeline->Fingerprint(start_frame, end_frame);
+
+	{
+		// Skip ranges which are already rendered
+		const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+		for (const auto& range : ranges)
+			if (range.start == start_frame && range.end == end_frame && range.fingerprint == fingerprint)
+				return true;
+	}
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("RenderCache::Render", "start_frame", start_frame, "end_frame", end_frame);
+
+	// Render the frames into a new folder
+	QString range_path = path.absoluteFilePath(QString("%1-%2-%3").arg(start_frame).arg(end_frame).arg(fingerprint.c_str()));
+	CacheDisk* frames = new CacheDisk(range_path.toStdString(), "png", 1.0, 1.0);
+	frames->Clear();
+	try
+	{
+		for (int64_t frame_number = start_frame; frame_number <= end_frame; frame_number++) {
+			// Cancel if the timeline changes (or the thread is stopping)
+			if (threadShouldExit() || version != render_version) {
+				ZmqLogger::Instance()->AppendDebugMethod("RenderCache::Render (cancelled)", "start_frame", start_frame, "end_frame", end_frame, "frame_number", frame_number);
+				QDir(range_path).removeRecursively();
+				delete frames;
+				return false;
+			}
+			frames->Add(timeline->GetFrame(frame_number));
+		}
+	}
+	catch (...)
+	{
+		QDir(range_path).removeRecursively();
+		delete frames;
+		throw;
+	}
+
+	// Save the description of the range (marks the range as complete)
+	Json::Value manifest;
+	manifest["start"] = (Json::Int64) start_frame;
+	manifest["end"] = (Json::Int64) end_frame;
+	manifest["fingerprint"] = fingerprint;
+	QFile manifest_file(range_path + "/range.json");
+	if (manifest_file.open(QIODevice::WriteOnly)) {
+		QTextStream manifest_stream(&manifest_file);
+		manifest_stream << manifest.toStyledString().c_str();
+	}
+
+	const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+
+	// Replace any previous render of this range
+	for (auto range = ranges.begin(); range != ranges.end();) {
+		if (range->start == start_frame && range->end == end_frame) {
+			range->frames->Clear();
+			QDir(range->folder).removeRecursively();
+			delete range->frames;
+			range = ranges.erase(range);
+		} else
+			++range;
+	}
+
+	RenderedRange range;
+	range.start = start_frame;
+	range.end = end_frame;
+	range.fingerprint = fingerprint;
+	range.folder = range_path;
+	range.frames = frames;
+	range.valid = true;
+	ranges.push_back(range);
+
+	return true;
+}
+
+// Render the queued ranges (background thread)
+void RenderCache::run()
+{
+	while (!threadShouldExit()) {
+		// Get the next range
+		std::pair<int64_t, int64_t> next_range;
+		bool has_range = false;
+		{
+			const GenericScopedLock<CriticalSection> lock(renderCriticalSection);
+			if (!pending.empty()) {
+				next_range = pending.front();
+				pending.pop_front();
+				has_range = true;
+			}
+		}
+
+		if (!has_range) {
+			// Wait for more ranges
+			wait(-1);
+			continue;
+		}
+
+		try
+		{
+			Render(next_range.first, next_range.second);
+		}
+		catch (const ExceptionBase& e)
+		{
+			// Skip ranges which can't be rendered (i.e. timeline is closed)
+			ZmqLogger::Instance()->AppendDebugMethod("RenderCache::run (failed to render range)", "start_frame", next_range.first, "end_frame", next_range.second);
+		}
+	}
+}
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Header file for RenderCache class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPENSHOT_RENDER_CACHE_H
+#define OPENSHOT_RENDER_CACHE_H
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include "CacheDisk.h"
+#include "Frame.h"
+
+namespace openshot {
+
+	class Timeline;
+
+	/**
+	 * @brief This class pre-renders ranges of a Timeline in the background, and saves them to disk.
+	 *
+	 * Heavy sections of a timeline (i.e. many layers, effects and transitions) can be too slow to
+	 * play in real time. Ranges can be queued manually (AddRange), or detected automatically
+	 * (AddHeavyRanges), and are rendered by a background thread into a folder on disk. Each
+	 * rendered range is saved with a fingerprint of everything which affects its frames (see
+	 * Timeline::Fingerprint), and the rendered frames are only used while the fingerprint is
+	 * unchanged (it is compared each time frames of the range are requested, and the timeline
+	 * only generates it again after a change). Rendered ranges persist on disk, and are found
+	 * again by a new RenderCache using the same folder (i.e. when the project is opened again).
+	 *
+	 * @code
+	 * openshot::RenderCache render_cache(&t, "/home/user/.openshot/render-cache/");
+	 * t.SetRenderCache(&render_cache);
+	 * render_cache.AddRange(100, 250);
+	 * render_cache.AddHeavyRanges(4);
+	 * @endcode
+	 *
+	 * Timeline::GetFrame and Timeline::GetFrames use the pre-rendered frames (if any), so both
+	 * playback and export use them. Frames are rendered at the current preview size of the timeline.
+	 */
+	class RenderCache : juce::Thread {
+	private:
+		/// A range of pre-rendered frames (saved on disk)
+		struct RenderedRange {
+			int64_t start; ///< The first frame number of the range
+			int64_t end; ///< The last frame number of the range
+			std::string fingerprint; ///< The fingerprint of the timeline when the range was rendered
+			QString folder; ///< The folder of the rendered frames
+			openshot::CacheDisk* frames; ///< The rendered frames
+			bool valid; ///< Does the fingerprint match the timeline
+		};
+
+		openshot::Timeline* timeline; ///< The timeline to render
+		QDir path; ///< The folder of the rendered ranges
+		std::list<RenderedRange> ranges; ///< The rendered ranges
+		std::deque<std::pair<int64_t, int64_t>> pending; ///< Ranges waiting to be rendered
+		std::atomic<int64_t> version; ///< Incremented each time the timeline changes
+		juce::CriticalSection renderCriticalSection; ///< Section lock for the ranges
+		juce::CriticalSection renderingCriticalSection; ///< Section lock held while a range is rendered
+
+		/// Find the rendered ranges saved in the folder
+		void load_ranges();
+
+		/// Compare the fingerprints of the rendered ranges which overlap a range of frames
+		void verify_ranges(int64_t start_frame, int64_t end_frame);
+
+	public:
+		/// @brief Constructor
+		/// @param timeline The timeline to render
+		/// @param cache_path The folder to save rendered ranges in (empty string = /tmp/render-cache/)
+		RenderCache(openshot::Timeline* timeline, std::string cache_path);
+
+		/// Destructor (stops the background thread, but keeps the rendered ranges on disk)
+		~RenderCache();
+
+		/// @brief Queue a range of frames to be rendered in the background
+		/// @param start_frame The first frame number of the range
+		/// @param end_frame The last frame number of the range
+		void AddRange(int64_t start_frame, int64_t end_frame);
+
+		/// @brief Queue all heavy ranges of the timeline to be rendered in the background
+		///
+		/// The cost of a frame is the number of clips with video, clip effects, and timeline effects
+		/// (i.e. transitions) at that frame.
+		/// @returns The number of ranges queued
+		/// @param min_cost The minimum cost of a heavy frame
+		int AddHeavyRanges(int min_cost);
+
+		/// Remove all rendered ranges (and their files), and any ranges waiting to be rendered. The range being
+		/// rendered (if any) is cancelled, and this waits for it to stop.
+		void Clear();
+
+		/// Stop the background thread (after the current frame), and wait for it. Queued ranges are kept, and
+		/// the thread is started again by the next AddRange.
+		void Stop();
+
+		/// @brief Get a pre-rendered frame (or NULL shared_ptr if not rendered, or no longer valid)
+		/// @param frame_number The frame number of the timeline
+		std::shared_ptr<openshot::Frame> GetFrame(int64_t frame_number);
+
+		/// The timeline has changed (cancels the range being rendered). This is called by the timeline whenever it
+		/// changes, including Timeline::ClearAllCache, which is needed after changing keyframes or properties directly.
+		/// Rendered ranges are compared with the fingerprint of the timeline before their frames are used.
+		void Invalidate() { version++; };
+
+		/// Is a range of frames rendered (and still valid)
+		bool IsRendered(int64_t start_frame, int64_t end_frame);
+
+		/// @brief Render a range of frames now (on the calling thread), replacing any previous render of this range
+		/// @returns true if the range was rendered, false if it was cancelled (timeline changed during the render)
+		/// @param start_frame The first frame number of the range
+		/// @param end_frame The last frame number of the range
+		bool Render(int64_t start_frame, int64_t end_frame);
+
+		/// Render the queued ranges (background thread)
+		void run() override;
+	};
+
+}
+
+#endif
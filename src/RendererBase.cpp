@@ -31,7 +31,7 @@
 #include "RendererBase.h"
 using namespace openshot;
 
-RendererBase::RendererBase()
+RendererBase::RendererBase() : presentation_width(0), presentation_height(0)
 {
 }
 
@@ -41,6 +41,27 @@ RendererBase::~RendererBase()
 
 void RendererBase::paint(const std::shared_ptr<Frame> & frame)
 {
-	if (frame)
-		this->render(frame->GetImage());
+	if (!frame)
+		return;
+
+	std::shared_ptr<QImage> image = frame->GetImage();
+	int width = presentation_width;
+	int height = presentation_height;
+
+	// Scale larger images down to the display size (on this thread, instead of the GUI thread)
+	if (image && width > 0 && height > 0 && (image->width() > width || image->height() > height)) {
+		if (image != last_image || last_scaled_image->size() != QSize(width, height)) {
+			last_scaled_image = std::make_shared<QImage>(image->scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+			last_image = image;
+		}
+		image = last_scaled_image;
+	}
+
+	this->render(image);
+}
+
+void RendererBase::SetPresentationSize(int width, int height)
+{
+	presentation_width = width;
+	presentation_height = height;
 }
@@ -32,6 +32,7 @@
 #define OPENSHOT_RENDERER_BASE_H
 
 #include "Frame.h"
+#include <atomic>
 #include <cstdlib> // for realloc
 #include <memory>
 
@@ -43,10 +44,18 @@ namespace openshot
      * @brief This is the base class of all Renderers in libopenshot.
      *
      * Renderers are responsible for rendering images of a video onto a
-     * display device.
+     * display device. When the size of the display is known (SetPresentationSize),
+     * larger frame images are scaled down by paint (on the playback thread), so
+     * the display only receives images of its own size.
      */
     class RendererBase
     {
+    private:
+	std::atomic<int> presentation_width; ///< The width of the display (0 = unknown)
+	std::atomic<int> presentation_height; ///< The height of the display (0 = unknown)
+	std::shared_ptr<QImage> last_image; ///< The last frame image which was scaled
+	std::shared_ptr<QImage> last_scaled_image; ///< The scaled copy of the last frame image
+
     public:
 
 	/// Paint(render) a video Frame.
@@ -55,6 +64,10 @@ namespace openshot
 	/// Allow manual override of the QWidget that is used to display
 	virtual void OverrideWidget(int64_t qwidget_address) = 0;
 
+	/// Set the size of the display in pixels (0 = unknown, which renders the full frame images).
+	/// This can be called from any thread (i.e. when the display is resized).
+	void SetPresentationSize(int width, int height);
+
     protected:
 	RendererBase();
 	virtual ~RendererBase();
@@ -29,6 +29,7 @@
  */
 
 #include "Settings.h"
+#include <mutex>
 
 using namespace std;
 using namespace openshot;
@@ -40,21 +41,36 @@ Settings *Settings::m_pInstance = NULL;
 // Create or Get an instance of the settings singleton
 Settings *Settings::Instance()
 {
-	if (!m_pInstance) {
+	// Create the instance only once (even when called from many threads at the same time)
+	static std::once_flag instance_created;
+	std::call_once(instance_created, []() {
 		// Create the actual instance of Settings only once
 		m_pInstance = new Settings;
 		m_pInstance->HARDWARE_DECODER = 0;
 		m_pInstance->HIGH_QUALITY_SCALING = false;
+		m_pInstance->DECODE_MODE = DECODE_FULL;
 		m_pInstance->WAIT_FOR_VIDEO_PROCESSING_TASK = false;
 		m_pInstance->OMP_THREADS = 12;
 		m_pInstance->FF_THREADS = 8;
+		m_pInstance->FRAME_REQUEST_THREADS = 4;
+		m_pInstance->LAZY_LOAD_CLIPS = false;
 		m_pInstance->DE_LIMIT_HEIGHT_MAX = 1100;
 		m_pInstance->DE_LIMIT_WIDTH_MAX = 1950;
 		m_pInstance->HW_DE_DEVICE_SET = 0;
 		m_pInstance->HW_EN_DEVICE_SET = 0;
 		m_pInstance->PLAYBACK_AUDIO_DEVICE_NAME = "";
 		m_pInstance->DEBUG_TO_STDERR = false;
-	}
+	});
 
 	return m_pInstance;
 }
+
+// Create a new copy of the global settings, or other settings (for a specific Timeline, reader or writer)
+Settings *Settings::Create(const Settings* original)
+{
+	// Copy every setting (so new settings are never missed)
+	if (original)
+		return new Settings(*original);
+	else
+		return new Settings(*Instance());
+}
@@ -43,6 +43,7 @@
 #include <zmq.hpp>
 #include <unistd.h>
 #include "JuceHeader.h"
+#include "Enums.h"
 
 
 namespace openshot {
@@ -59,16 +60,13 @@ namespace openshot {
 		/// Default constructor
 		Settings(){}; 						 // Don't allow user to create an instance of this singleton
 
-#if __GNUC__ >=7
-		/// Default copy method
-		Settings(Settings const&) = delete; // Don't allow the user to assign this instance
+		/// Default copy method (only used by Create, to copy the global settings)
+		Settings(Settings const&) = default;
 
+#if __GNUC__ >=7
 		/// Default assignment operator
 		Settings & operator=(Settings const&) = delete;  // Don't allow the user to assign this instance
 #else
-		/// Default copy method
-		Settings(Settings const&) {}; // Don't allow the user to assign this instance
-
 		/// Default assignment operator
 		Settings & operator=(Settings const&);  // Don't allow the user to assign this instance
 #endif
@@ -94,7 +92,13 @@ namespace openshot {
 		/// Scale mode used in FFmpeg decoding and encoding (used as an optimization for faster previews)
 		bool HIGH_QUALITY_SCALING = false;
 
-		/// Maximum width for image data (useful for optimzing for a smaller preview or render)
+		/// How much work FFmpegReader spends decoding video (see DecodeMode). The player lowers this
+		/// automatically when it falls behind (in the reader's own settings, or a copy of the global
+		/// settings), and restores the mode used when playback started once it catches up.
+		openshot::DecodeMode DECODE_MODE = openshot::DECODE_FULL;
+
+		/// Maximum width for image data (useful for optimzing for a smaller preview or render). A reader which
+		/// is not on a timeline only uses this from its own settings (see ReaderBase::SetSettings).
 		int MAX_WIDTH = 0;
 
 		/// Maximum height for image data (useful for optimzing for a smaller preview or render)
@@ -109,6 +113,12 @@ namespace openshot {
 		/// Number of threads that ffmpeg uses
 		int FF_THREADS = 8;
 
+		/// Number of worker threads used for asynchronous frame requests (i.e. ReaderBase::RequestFrame)
+		int FRAME_REQUEST_THREADS = 4;
+
+		/// Load clip keyframes and effects only when a clip is first used (i.e. Timeline(path) for very large projects)
+		bool LAZY_LOAD_CLIPS = false;
+
 		/// Maximum rows that hardware decode can handle
 		int DE_LIMIT_HEIGHT_MAX = 1100;
 
@@ -133,6 +143,11 @@ namespace openshot {
 
 		/// Create or get an instance of this logger singleton (invoke the class with this method)
 		static Settings * Instance();
+
+		/// Create a new copy of the global settings (or of other settings, i.e. reader->GetSettings()), which
+		/// can be changed (and assigned to a specific Timeline, reader or writer with SetSettings), without
+		/// affecting any other instance. You must manage the lifecycle of the copy (delete it when no longer used).
+		static Settings * Create(const Settings* original = NULL);
 	};
 
 }
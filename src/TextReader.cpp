@@ -59,6 +59,13 @@ void TextReader::SetTextBackgroundColor(std::string color) {
 	Close();
 }
 
+// Destructor
+TextReader::~TextReader()
+{
+	// Wait for any running frame requests of this reader
+	wait_for_requests();
+}
+
 // Open reader
 void TextReader::Open()
 {
@@ -153,6 +160,10 @@ void TextReader::Open()
 // Close reader
 void TextReader::Close()
 {
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all objects, if reader is 'open'
 	if (is_open)
 	{
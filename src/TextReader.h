@@ -118,6 +118,9 @@ namespace openshot
 		/// @param background_color The background color of the text frame image (also supports Transparent)
 		TextReader(int width, int height, int x_offset, int y_offset, GravityType gravity, std::string text, std::string font, double size, std::string text_color, std::string background_color);
 
+		/// Destructor
+		virtual ~TextReader();
+
 		/// Draw a box under rendered text using the specified color.
 		/// @param color The background color behind the text
 		void SetTextBackgroundColor(std::string color);
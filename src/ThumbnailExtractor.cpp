@@ -0,0 +1,264 @@
+/**
+ * @file
+ * @brief Source file for ThumbnailExtractor class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ThumbnailExtractor.h"
+#include "Exceptions.h"
+#include "FFmpegReader.h"
+#include "OpenMPUtilities.h"
+#include "Settings.h"
+#include "ZmqLogger.h"
+#include <algorithm>
+#include <atomic>
+#include <QPainter>
+
+using namespace openshot;
+
+// Constructor
+ThumbnailExtractor::ThumbnailExtractor(ReaderBase* reader, int width, int height) :
+	reader(reader), width(width), height(height), background_color("#000000"), ignore_aspect(false),
+	quality(-1), executor(NULL)
+{
+}
+
+// Set the mask image (which is only loaded once)
+void ThumbnailExtractor::SetMask(std::string new_mask_path) {
+	mask_path = new_mask_path;
+	mask = load_asset(mask_path);
+
+	// Negate mask
+	if (mask)
+		mask->invertPixels();
+}
+
+// Set the overlay image (which is only loaded once)
+void ThumbnailExtractor::SetOverlay(std::string new_overlay_path) {
+	overlay_path = new_overlay_path;
+	overlay = load_asset(overlay_path);
+}
+
+// Get the executor used to composite and encode thumbnails (or the default executor)
+Executor* ThumbnailExtractor::GetExecutor() {
+	if (executor)
+		return executor;
+	else
+		return Executor::Default();
+}
+
+// Load an image for a mask or overlay, scaled to the thumbnail size
+std::shared_ptr<QImage> ThumbnailExtractor::load_asset(std::string path) {
+	if (path.empty())
+		return std::shared_ptr<QImage>();
+
+	QImage asset;
+	if (!asset.load(QString::fromStdString(path)))
+		throw InvalidFile("The thumbnail mask or overlay image could not be loaded.", path);
+
+	// Set pixel format, and resize to fit
+	return std::make_shared<QImage>(asset.convertToFormat(QImage::Format_RGBA8888_Premultiplied).scaled(
+		width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+}
+
+// Composite the image of a frame into a thumbnail
+std::shared_ptr<QImage> ThumbnailExtractor::compose(std::shared_ptr<Frame> frame) {
+	// Create blank thumbnail image & fill background color
+	auto thumbnail = std::make_shared<QImage>(width, height, QImage::Format_RGBA8888_Premultiplied);
+	thumbnail->fill(QColor(QString::fromStdString(background_color)));
+
+	// Create painter
+	QPainter painter(thumbnail.get());
+	painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform | QPainter::TextAntialiasing, true);
+
+	// Determine the size of the frame image (correcting non-square pixels), and fit it in the thumbnail
+	std::shared_ptr<QImage> frame_image = frame->GetImage();
+	QSize image_size = frame_image->size();
+	Fraction pixel_ratio = frame->GetPixelRatio();
+	if (pixel_ratio.num != 1 || pixel_ratio.den != 1)
+		image_size.setHeight(image_size.height() * pixel_ratio.Reciprocal().ToDouble());
+	image_size.scale(width, height, ignore_aspect ? Qt::IgnoreAspectRatio : Qt::KeepAspectRatio);
+
+	// Composite frame image onto background (centered, and scaled while drawing)
+	QRect target((width - image_size.width()) / 2, (height - image_size.height()) / 2,
+				 image_size.width(), image_size.height());
+	painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+	painter.drawImage(target, *frame_image);
+
+	// Overlay Image (if any)
+	if (overlay)
+		painter.drawImage(0, 0, *overlay);
+	painter.end();
+
+	// Mask Image (if any)
+	if (mask) {
+		// Get pixels
+		unsigned char *pixels = (unsigned char *) thumbnail->bits();
+		const unsigned char *mask_pixels = (const unsigned char *) mask->constBits();
+
+		// Subtract the gray value of the (negated) mask from the alpha of each pixel
+		for (int pixel = 0, byte_index = 0; pixel < width * height; pixel++, byte_index += 4) {
+			int gray_value = qGray(mask_pixels[byte_index], mask_pixels[byte_index + 1], mask_pixels[byte_index + 2]);
+			pixels[byte_index + 3] = std::max(0, pixels[byte_index + 3] - gray_value);
+		}
+	}
+
+	return thumbnail;
+}
+
+// Get the frames of a list of positions (in order)
+std::vector<std::shared_ptr<Frame>> ThumbnailExtractor::get_frames(std::vector<int64_t> positions, bool keyframes_only) {
+	std::vector<std::shared_ptr<Frame>> frames;
+
+	if (reader->Name() == "FFmpegReader") {
+		// Decode with a separate reader (using a copy of the original reader's settings), so the settings and
+		// cache of the original reader are untouched. The reduced resolution (lowres) is only applied when the
+		// codec is opened, and the images are no larger than the thumbnails.
+		std::unique_ptr<Settings> settings(Settings::Create(reader->GetSettings()));
+		settings->DECODE_MODE = DECODE_LOWRES;
+		settings->MAX_WIDTH = width;
+		settings->MAX_HEIGHT = height;
+
+		FFmpegReader decoder(reader->JsonValue()["path"].asString(), false);
+		decoder.SetSettings(settings.get());
+		decoder.Open();
+
+		// Only decode what is needed
+		settings->DECODE_MODE = keyframes_only ? DECODE_KEYFRAMES_ONLY : DECODE_FAST;
+		for (int64_t position : positions)
+			frames.push_back(decoder.GetFrame(position));
+		decoder.Close();
+
+	} else {
+		// Other readers (i.e. a Timeline or image) are asked for their frames in order
+		for (int64_t position : positions)
+			frames.push_back(reader->GetFrame(position));
+	}
+
+	return frames;
+}
+
+// Get the frame numbers of evenly spaced positions across the reader
+std::vector<int64_t> ThumbnailExtractor::Positions(int count, bool keyframe_aligned) {
+	std::vector<int64_t> positions;
+	int64_t length = reader->info.video_length;
+	if (count <= 0 || length <= 0)
+		return positions;
+
+	// Get the keyframes (if any)
+	std::vector<int64_t> keyframes;
+	if (keyframe_aligned && reader->Name() == "FFmpegReader")
+		keyframes = ((FFmpegReader *) reader)->GetKeyframes();
+
+	for (int index = 0; index < count; index++) {
+		// Use the middle of each evenly sized section
+		int64_t position = std::min(length, int64_t(1 + (index + 0.5) * length / count));
+
+		// Move to the nearest preceding keyframe
+		if (!keyframes.empty()) {
+			auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), position);
+			position = (keyframe == keyframes.begin()) ? keyframes.front() : *(keyframe - 1);
+		}
+
+		// Skip duplicates (i.e. many positions in a long GOP)
+		if (positions.empty() || positions.back() != position)
+			positions.push_back(position);
+	}
+
+	return positions;
+}
+
+// Get the thumbnails of a list of frame numbers
+std::vector<std::shared_ptr<QImage>> ThumbnailExtractor::GetThumbnails(std::vector<int64_t> positions, bool keyframes_only) {
+	std::vector<std::shared_ptr<Frame>> frames = get_frames(positions, keyframes_only);
+	std::vector<std::shared_ptr<QImage>> thumbnails(frames.size());
+
+	// Composite each thumbnail on the threads of the executor
+	Executor* thumbnail_executor = GetExecutor();
+	#pragma omp parallel num_threads(thumbnail_executor->ThreadCount())
+	{
+		thumbnail_executor->ApplyToCurrentThread();
+
+		#pragma omp for schedule(dynamic)
+		for (int index = 0; index < (int) frames.size(); index++)
+			thumbnails[index] = compose(frames[index]);
+
+		// Restore the previous cores and priority of this thread
+		thumbnail_executor->RestoreCurrentThread();
+	}
+
+	return thumbnails;
+}
+
+// Save the thumbnails of evenly spaced positions
+std::vector<std::string> ThumbnailExtractor::Extract(int count, std::string path, bool keyframe_aligned) {
+	std::vector<int64_t> positions = Positions(count, keyframe_aligned);
+	std::vector<std::shared_ptr<Frame>> frames = get_frames(positions, keyframe_aligned);
+	std::vector<std::string> paths(frames.size());
+	std::atomic<int> failed_index(-1);
+
+	ZmqLogger::Instance()->AppendDebugMethod("ThumbnailExtractor::Extract", "count", count, "positions.size()", positions.size(), "keyframe_aligned", keyframe_aligned, "width", width, "height", height);
+
+	// Composite and encode each thumbnail on the threads of the executor
+	Executor* thumbnail_executor = GetExecutor();
+	#pragma omp parallel num_threads(thumbnail_executor->ThreadCount())
+	{
+		thumbnail_executor->ApplyToCurrentThread();
+
+		#pragma omp for schedule(dynamic)
+		for (int index = 0; index < (int) frames.size(); index++) {
+			QString thumbnail_path = QString::fromStdString(path).arg(positions[index]);
+			paths[index] = thumbnail_path.toStdString();
+			if (!compose(frames[index])->save(thumbnail_path, NULL, quality))
+				failed_index = index;
+		}
+
+		// Restore the previous cores and priority of this thread
+		thumbnail_executor->RestoreCurrentThread();
+	}
+
+	if (failed_index >= 0)
+		throw InvalidFile("The thumbnail could not be saved.", paths[failed_index]);
+
+	return paths;
+}
+
+// Get a filmstrip of evenly spaced thumbnails (side by side, in a single image)
+std::shared_ptr<QImage> ThumbnailExtractor::Filmstrip(int count, bool keyframe_aligned) {
+	std::vector<std::shared_ptr<QImage>> thumbnails = GetThumbnails(Positions(count, keyframe_aligned), keyframe_aligned);
+
+	auto filmstrip = std::make_shared<QImage>(std::max(1, int(thumbnails.size()) * width), height, QImage::Format_RGBA8888_Premultiplied);
+	filmstrip->fill(Qt::transparent);
+
+	QPainter painter(filmstrip.get());
+	for (int index = 0; index < (int) thumbnails.size(); index++)
+		painter.drawImage(index * width, 0, *thumbnails[index]);
+	painter.end();
+
+	return filmstrip;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Header file for ThumbnailExtractor class
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPENSHOT_THUMBNAIL_EXTRACTOR_H
+#define OPENSHOT_THUMBNAIL_EXTRACTOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <QImage>
+#include "Executor.h"
+#include "Frame.h"
+#include "ReaderBase.h"
+
+namespace openshot {
+
+	/**
+	 * @brief This class extracts a batch of thumbnails (i.e. a filmstrip) from a reader.
+	 *
+	 * Positions are sampled evenly across the reader, and can be moved to the nearest preceding
+	 * keyframe (which is much faster to decode). Media files (FFmpegReader) are decoded by a
+	 * separate reader, which decodes at a reduced resolution (lowres, if supported by the codec),
+	 * and only decodes keyframes for keyframe-aligned positions. Other readers are asked for their
+	 * frames in order. The mask and overlay images are only loaded and scaled once, and the
+	 * thumbnails are composited and encoded on the threads of an Executor.
+	 *
+	 * @code
+	 * openshot::ThumbnailExtractor extractor(&reader, 160, 90);
+	 * extractor.SetOverlay("overlay.png");
+	 * std::vector<std::string> paths = extractor.Extract(10, "/tmp/thumbnails/%1.png", true);
+	 * std::shared_ptr<QImage> filmstrip = extractor.Filmstrip(20, true);
+	 * @endcode
+	 *
+	 * Each thumbnail matches Frame::Thumbnail (without rotation).
+	 */
+	class ThumbnailExtractor {
+	private:
+		openshot::ReaderBase* reader; ///< The reader to extract thumbnails from
+		int width; ///< The width of each thumbnail
+		int height; ///< The height of each thumbnail
+		std::string mask_path; ///< The path of the mask image (if any)
+		std::string overlay_path; ///< The path of the overlay image (if any)
+		std::string background_color; ///< The background color of each thumbnail
+		bool ignore_aspect; ///< Stretch the frame image to the thumbnail size
+		int quality; ///< The quality of the encoded thumbnails (0 to 100, or -1 for the default)
+		std::shared_ptr<QImage> mask; ///< The loaded mask (inverted and scaled to the thumbnail size)
+		std::shared_ptr<QImage> overlay; ///< The loaded overlay (scaled to the thumbnail size)
+		openshot::Executor* executor; ///< Pointer to the executor (or NULL for the default executor)
+
+		/// Load an image for a mask or overlay, scaled to the thumbnail size (or NULL if there is no path)
+		std::shared_ptr<QImage> load_asset(std::string path);
+
+		/// Composite the image of a frame into a thumbnail
+		std::shared_ptr<QImage> compose(std::shared_ptr<openshot::Frame> frame);
+
+		/// Get the frames of a list of positions (in order)
+		std::vector<std::shared_ptr<openshot::Frame>> get_frames(std::vector<int64_t> positions, bool keyframes_only);
+
+	public:
+		/// Constructor with a reader, and the size of each thumbnail
+		ThumbnailExtractor(openshot::ReaderBase* reader, int width, int height);
+
+		/// Set the mask image (which is only loaded once). Dark areas of the mask are transparent.
+		void SetMask(std::string new_mask_path);
+
+		/// Set the overlay image (which is only loaded once)
+		void SetOverlay(std::string new_overlay_path);
+
+		/// Set the background color of each thumbnail (i.e. "#000000")
+		void SetBackgroundColor(std::string new_background_color) { background_color = new_background_color; };
+
+		/// Stretch the frame image to the thumbnail size (instead of maintaining the aspect ratio)
+		void SetIgnoreAspect(bool new_ignore_aspect) { ignore_aspect = new_ignore_aspect; };
+
+		/// Set the quality of the encoded thumbnails (0 to 100, or -1 for the default of the format)
+		void SetQuality(int new_quality) { quality = new_quality; };
+
+		/// Get the executor used to composite and encode thumbnails (or the default executor)
+		openshot::Executor* GetExecutor();
+
+		/// Set the executor used to composite and encode thumbnails (NULL = the default executor)
+		void SetExecutor(openshot::Executor* new_executor) { executor = new_executor; };
+
+		/// Get the frame numbers of evenly spaced positions across the reader
+		///
+		/// @returns The frame numbers (in order, without duplicates)
+		/// @param count The number of positions
+		/// @param keyframe_aligned Move each position to the nearest preceding keyframe (media files only)
+		std::vector<int64_t> Positions(int count, bool keyframe_aligned = false);
+
+		/// Get the thumbnails of a list of frame numbers
+		///
+		/// @param positions The frame numbers
+		/// @param keyframes_only The positions are keyframes (only decode keyframes)
+		std::vector<std::shared_ptr<QImage>> GetThumbnails(std::vector<int64_t> positions, bool keyframes_only = false);
+
+		/// Save the thumbnails of evenly spaced positions. The image format is determined from the extension.
+		///
+		/// @returns The paths of the saved thumbnails
+		/// @param count The number of thumbnails
+		/// @param path The path of each thumbnail, with %1 replaced by the frame number (i.e. "/tmp/thumb-%1.png")
+		/// @param keyframe_aligned Move each position to the nearest preceding keyframe (media files only)
+		std::vector<std::string> Extract(int count, std::string path, bool keyframe_aligned = false);
+
+		/// Get a filmstrip of evenly spaced thumbnails (side by side, in a single image)
+		///
+		/// @param count The number of thumbnails
+		/// @param keyframe_aligned Move each position to the nearest preceding keyframe (media files only)
+		std::shared_ptr<QImage> Filmstrip(int count, bool keyframe_aligned = false);
+	};
+
+}
+
+#endif
@@ -34,7 +34,7 @@ using namespace openshot;
 
 // Default Constructor for the timeline (which sets the canvas width and height)
 Timeline::Timeline(int width, int height, Fraction fps, int sample_rate, int channels, ChannelLayout channel_layout) :
-		is_open(false), auto_map_clips(true), managed_cache(true), path("")
+		is_open(false), auto_map_clips(true), managed_cache(true), render_cache(NULL), path("")
 {
 	// Create CrashHandler and Attach (incase of errors)
 	CrashHandler::Instance();
@@ -69,23 +69,17 @@ Timeline::Timeline(int width, int height, Fraction fps, int sample_rate, int cha
 	info.acodec = "openshot::timeline";
 	info.vcodec = "openshot::timeline";
 
-	// Configure OpenMP parallelism
-	// Default number of threads per block
-	omp_set_num_threads(OPEN_MP_NUM_PROCESSORS);
-	// Allow nested parallel sections as deeply as supported
-	omp_set_max_active_levels(OPEN_MP_MAX_ACTIVE);
-
 	// Init max image size
 	SetMaxSize(info.width, info.height);
 
 	// Init cache
 	final_cache = new CacheMemory();
-	final_cache->SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
+	final_cache->SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
 }
 
 // Constructor for the timeline (which loads a JSON structure from a file path, and initializes a timeline)
 Timeline::Timeline(const std::string& projectPath, bool convert_absolute_paths) :
-		is_open(false), auto_map_clips(true), managed_cache(true), path(projectPath) {
+		is_open(false), auto_map_clips(true), managed_cache(true), render_cache(NULL), path(projectPath) {
 
 	// Create CrashHandler and Attach (incase of errors)
 	CrashHandler::Instance();
@@ -202,21 +196,18 @@ Timeline::Timeline(const std::string& projectPath, bool convert_absolute_paths)
 	info.has_video = true;
 	info.has_audio = true;
 
-	// Configure OpenMP parallelism
-	// Default number of threads per section
-	omp_set_num_threads(OPEN_MP_NUM_PROCESSORS);
-	// Allow nested parallel sections as deeply as supported
-	omp_set_max_active_levels(OPEN_MP_MAX_ACTIVE);
-
 	// Init max image size
 	SetMaxSize(info.width, info.height);
 
 	// Init cache
 	final_cache = new CacheMemory();
-	final_cache->SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS * 2, info.width, info.height, info.sample_rate, info.channels);
+	final_cache->SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, info.width, info.height, info.sample_rate, info.channels);
 }
 
 Timeline::~Timeline() {
+	// Wait for any running frame requests of this timeline
+	wait_for_requests();
+
 	if (is_open)
 		// Auto Close if not already
 		Close();
@@ -256,11 +247,25 @@ void Timeline::AddClip(Clip* clip)
 		// Apply framemapper (or update existing framemapper)
 		apply_mapper_to_clip(clip);
 
+	// Use the executor and settings of this timeline for the clip's reader (if this timeline has its own,
+	// otherwise the reader keeps its own executor and settings)
+	if (clip->Reader()) {
+		if (executor)
+			clip->Reader()->SetExecutor(executor);
+		if (settings)
+			clip->Reader()->SetSettings(settings);
+		// Time mapped clips (i.e. reversed, frozen or looped) request the frames of their reader out of order
+		clip->Reader()->SetStreaming(streaming && clip->time.GetLength() <= 1);
+	}
+
 	// Add clip to list
 	clips.push_back(clip);
 
 	// Sort clips
 	sort_clips();
+
+	// Pre-rendered ranges need to be compared again
+	invalidate_fingerprints();
 }
 
 // Add an effect to the timeline
@@ -269,23 +274,35 @@ void Timeline::AddEffect(EffectBase* effect)
 	// Assign timeline to effect
 	effect->ParentTimeline(this);
 
+	// Use the executor of this timeline for the effect
+	effect->SetExecutor(executor);
+
 	// Add effect to list
 	effects.push_back(effect);
 
 	// Sort effects
 	sort_effects();
+
+	// Pre-rendered ranges need to be compared again
+	invalidate_fingerprints();
 }
 
 // Remove an effect from the timeline
 void Timeline::RemoveEffect(EffectBase* effect)
 {
 	effects.remove(effect);
+
+	// Pre-rendered ranges need to be compared again
+	invalidate_fingerprints();
 }
 
 // Remove an openshot::Clip to the timeline
 void Timeline::RemoveClip(Clip* clip)
 {
 	clips.remove(clip);
+
+	// Pre-rendered ranges need to be compared again
+	invalidate_fingerprints();
 }
 
 // Look up a clip
@@ -392,6 +409,18 @@ void Timeline::ApplyMapperToClips()
 	}
 }
 
+// Calculate the preview size for a maximum width and height
+QSize Timeline::calculate_preview_size(int width, int height)
+{
+	// Maintain aspect ratio regardless of what size is passed in
+	QSize display_ratio_size = QSize(info.display_ratio.num * info.pixel_ratio.ToFloat(), info.display_ratio.den * info.pixel_ratio.ToFloat());
+	QSize proposed_size = QSize(std::min(width, info.width), std::min(height, info.height));
+
+	// Scale QSize up to proposed size
+	display_ratio_size.scale(proposed_size, Qt::KeepAspectRatio);
+	return display_ratio_size;
+}
+
 // Calculate time of a frame number, based on a framerate
 double Timeline::calculate_time(int64_t number, Fraction rate)
 {
@@ -453,7 +482,7 @@ std::shared_ptr<Frame> Timeline::GetOrCreateFrame(Clip* clip, int64_t number)
 		ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetOrCreateFrame (from reader)", "number", number, "samples_in_frame", samples_in_frame);
 
 		// Attempt to get a frame (but this could fail if a reader has just been closed)
-		#pragma omp critical (T_GetOtCreateFrame)
+		const GenericScopedLock<CriticalSection> lock(addLayerCriticalSection);
 		new_frame = std::shared_ptr<Frame>(clip->GetFrame(number));
 
 		// Return real frame
@@ -472,11 +501,8 @@ std::shared_ptr<Frame> Timeline::GetOrCreateFrame(Clip* clip, int64_t number)
 
 	// Create blank frame
 	new_frame = std::make_shared<Frame>(number, preview_width, preview_height, "#000000", samples_in_frame, info.channels);
-	#pragma omp critical (T_GetOtCreateFrame)
-	{
-		new_frame->SampleRate(info.sample_rate);
-		new_frame->ChannelsLayout(info.channel_layout);
-	}
+	new_frame->SampleRate(info.sample_rate);
+	new_frame->ChannelsLayout(info.channel_layout);
 	return new_frame;
 }
 
@@ -484,9 +510,7 @@ std::shared_ptr<Frame> Timeline::GetOrCreateFrame(Clip* clip, int64_t number)
 void Timeline::add_layer(std::shared_ptr<Frame> new_frame, Clip* source_clip, int64_t clip_frame_number, int64_t timeline_frame_number, bool is_top_clip, float max_volume)
 {
 	// Get the clip's frame & image
-	std::shared_ptr<Frame> source_frame;
-	#pragma omp critical (T_addLayer)
-	source_frame = GetOrCreateFrame(source_clip, clip_frame_number);
+	std::shared_ptr<Frame> source_frame = GetOrCreateFrame(source_clip, clip_frame_number);
 
 	// No frame found... so bail
 	if (!source_frame)
@@ -498,7 +522,7 @@ void Timeline::add_layer(std::shared_ptr<Frame> new_frame, Clip* source_clip, in
 	/* Apply effects to the source frame (if any). If multiple clips are overlapping, only process the
 	 * effects on the top clip. */
 	if (is_top_clip) {
-		#pragma omp critical (T_addLayer)
+		const GenericScopedLock<CriticalSection> lock(addLayerCriticalSection);
 		source_frame = apply_effects(source_frame, timeline_frame_number, source_clip->Layer());
 	}
 
@@ -510,14 +534,18 @@ void Timeline::add_layer(std::shared_ptr<Frame> new_frame, Clip* source_clip, in
 		// Debug output
 		ZmqLogger::Instance()->AppendDebugMethod("Timeline::add_layer (Copy Audio)", "source_clip->Reader()->info.has_audio", source_clip->Reader()->info.has_audio, "source_frame->GetAudioChannelsCount()", source_frame->GetAudioChannelsCount(), "info.channels", info.channels, "clip_frame_number", clip_frame_number, "timeline_frame_number", timeline_frame_number);
 
-		if (source_frame->GetAudioChannelsCount() == info.channels && source_clip->has_audio.GetInt(clip_frame_number) != 0)
+		// Get keyframe values of this frame and the previous frame (precomputed, if baked)
+		ClipFrameValues clip_values = source_clip->GetFrameValues(clip_frame_number);
+		float clip_previous_volume = source_clip->GetFrameValues(clip_frame_number - 1).volume;
+
+		if (source_frame->GetAudioChannelsCount() == info.channels && clip_values.has_audio != 0)
 			for (int channel = 0; channel < source_frame->GetAudioChannelsCount(); channel++)
 			{
 				// Get volume from previous frame and this frame
-				float previous_volume = source_clip->volume.GetValue(clip_frame_number - 1);
-				float volume = source_clip->volume.GetValue(clip_frame_number);
-				int channel_filter = source_clip->channel_filter.GetInt(clip_frame_number); // optional channel to filter (if not -1)
-				int channel_mapping = source_clip->channel_mapping.GetInt(clip_frame_number); // optional channel to map this channel to (if not -1)
+				float previous_volume = clip_previous_volume;
+				float volume = clip_values.volume;
+				int channel_filter = clip_values.channel_filter; // optional channel to filter (if not -1)
+				int channel_mapping = clip_values.channel_mapping; // optional channel to map this channel to (if not -1)
 
 				// Apply volume mixing strategy
 				if (source_clip->mixing == VOLUME_MIX_AVERAGE && max_volume > 1.0) {
@@ -553,13 +581,10 @@ void Timeline::add_layer(std::shared_ptr<Frame> new_frame, Clip* source_clip, in
 				// This is a crude solution at best. =)
 				if (new_frame->GetAudioSamplesCount() != source_frame->GetAudioSamplesCount()){
 					// Force timeline frame to match the source frame
-					#pragma omp critical (T_addLayer)
-
 					new_frame->ResizeAudio(info.channels, source_frame->GetAudioSamplesCount(), info.sample_rate, info.channel_layout);
 				}
 				// Copy audio samples (and set initial volume).  Mix samples with existing audio samples.  The gains are added together, to
 				// be sure to set the gain's correctly, so the sum does not exceed 1.0 (of audio distortion will happen).
-				#pragma omp critical (T_addLayer)
 				new_frame->AddAudio(false, channel_mapping, 0, source_frame->GetAudioSamples(channel), source_frame->GetAudioSamplesCount(), 1.0);
 
 			}
@@ -577,6 +602,19 @@ void Timeline::add_layer(std::shared_ptr<Frame> new_frame, Clip* source_clip, in
 	// Debug output
 	ZmqLogger::Instance()->AppendDebugMethod("Timeline::add_layer (Get Source Image)", "source_frame->number", source_frame->number, "source_clip->Waveform()", source_clip->Waveform(), "clip_frame_number", clip_frame_number);
 
+	// Composite solid color layers without drawing their pixels (if possible)
+	if (source_frame->IsSolidColor() && source_frame->has_image_data) {
+		QColor source_color(QString::fromStdString(source_frame->SolidColor()));
+		if (source_color.alpha() == 0)
+			// Fully transparent layer (nothing to composite)
+			return;
+		if (source_color.alpha() == 255 && source_frame->GetWidth() == new_frame->GetWidth() && source_frame->GetHeight() == new_frame->GetHeight()) {
+			// Opaque layer covering the whole frame (replaces all layers below it)
+			new_frame->AddColor(new_frame->GetWidth(), new_frame->GetHeight(), source_frame->SolidColor());
+			return;
+		}
+	}
+
 	// Get actual frame image data
 	source_image = source_frame->GetImage();
 
@@ -658,6 +696,10 @@ void Timeline::Close()
 {
 	ZmqLogger::Instance()->AppendDebugMethod("Timeline::Close");
 
+	// Drop any frame requests which have not started yet, and wait for the running requests
+	// (which use the state that is closed below)
+	wait_for_requests();
+
 	// Close all open clips
 	for (auto clip : clips)
 	{
@@ -696,7 +738,7 @@ std::shared_ptr<Frame> Timeline::GetFrame(int64_t requested_frame)
 	// Check cache
 	std::shared_ptr<Frame> frame;
 	std::lock_guard<std::mutex> guard(get_frame_mutex);
-	#pragma omp critical (T_GetFrame)
+	update_nested_size();
 	frame = final_cache->GetFrame(requested_frame);
 	if (frame) {
 		// Debug output
@@ -714,8 +756,10 @@ std::shared_ptr<Frame> Timeline::GetFrame(int64_t requested_frame)
 		if (!is_open)
 			throw ReaderClosed("The Timeline is closed.  Call Open() before calling this method.");
 
+		// Drop the frames which will not be requested again (if streaming)
+		release_streamed_clip_frames(requested_frame);
+
 		// Check cache again (due to locking)
-		#pragma omp critical (T_GetFrame)
 		frame = final_cache->GetFrame(requested_frame);
 		if (frame) {
 			// Debug output
@@ -725,164 +769,233 @@ std::shared_ptr<Frame> Timeline::GetFrame(int64_t requested_frame)
 			return frame;
 		}
 
-		// Check if previous frame was cached? (if not, assume we are seeking somewhere else on the Timeline, and need
-		// to clear all cache (for continuity sake). For example, jumping back to a previous spot can cause issues with audio
-		// data where the new jump location doesn't match up with the previously cached audio data.
-		std::shared_ptr<Frame> previous_frame = final_cache->GetFrame(requested_frame - 1);
-		if (!previous_frame) {
-			// Seeking to new place on timeline (destroy cache)
-			ClearAllCache();
+		// Check for a pre-rendered frame
+		if (render_cache) {
+			frame = render_cache->GetFrame(requested_frame);
+			if (frame) {
+				// Debug output
+				ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Pre-rendered frame found)", "requested_frame", requested_frame);
+
+				final_cache->Add(frame);
+				return frame;
+			}
 		}
 
-		// Minimum number of frames to process (for performance reasons)
-		int minimum_frames = OPEN_MP_NUM_PROCESSORS;
+		// Seeking does not clear any cache. Cached frames stay valid, and the audio resamplers of
+		// the clips (FrameMapper and time mapping) restart by themselves when the frame they are
+		// asked for does not continue their previous frame.
 
-		// Get a list of clips that intersect with the requested section of timeline
-		// This also opens the readers for intersecting clips, and marks non-intersecting clips as 'needs closing'
-		std::vector<Clip*> nearby_clips;
-		#pragma omp critical (T_GetFrame)
-		nearby_clips = find_intersecting_clips(requested_frame, minimum_frames, true);
+		// Render the requested frame (and a few more frames, for performance reasons)
+		render_frames(requested_frame, GetExecutor()->ThreadCount(), NULL);
 
 		// Debug output
-		ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame", "requested_frame", requested_frame, "minimum_frames", minimum_frames, "OPEN_MP_NUM_PROCESSORS", OPEN_MP_NUM_PROCESSORS);
+		ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (end parallel region)", "requested_frame", requested_frame, "omp_get_thread_num()", omp_get_thread_num());
 
-		// GENERATE CACHE FOR CLIPS (IN FRAME # SEQUENCE)
-		// Determine all clip frames, and request them in order (to keep resampled audio in sequence)
-		for (int64_t frame_number = requested_frame; frame_number < requested_frame + minimum_frames; frame_number++)
-		{
-			// Loop through clips
-			for (auto clip : nearby_clips)
-			{
-                long clip_start_position = round(clip->Position() * info.fps.ToDouble()) + 1;
-                long clip_end_position = round((clip->Position() + clip->Duration()) * info.fps.ToDouble()) + 1;
+		// Return frame (or blank frame)
+		return final_cache->GetFrame(requested_frame);
+	}
+}
 
-				bool does_clip_intersect = (clip_start_position <= frame_number && clip_end_position >= frame_number);
-				if (does_clip_intersect)
-				{
-					// Get clip frame #
-                    long clip_start_frame = (clip->Start() * info.fps.ToDouble()) + 1;
-					long clip_frame_number = frame_number - clip_start_position + clip_start_frame;
 
-					// Cache clip object
-					clip->GetFrame(clip_frame_number);
-				}
-			}
+// Render a range of sequential frames (in parallel), and add them to the final cache
+void Timeline::render_frames(int64_t requested_frame, int number_of_frames, std::vector<std::shared_ptr<Frame>>* rendered_frames)
+{
+	// Get a list of clips that intersect with the requested section of timeline
+	// This also opens the readers for intersecting clips, and marks non-intersecting clips as 'needs closing'
+	std::vector<Clip*> nearby_clips = find_intersecting_clips(requested_frame, number_of_frames, true);
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame", "requested_frame", requested_frame, "number_of_frames", number_of_frames, "OPEN_MP_NUM_PROCESSORS", OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()));
+
+	// GENERATE CACHE FOR CLIPS (IN FRAME # SEQUENCE)
+	// Request the frames of each clip as a single range, in order (to keep resampled audio in sequence)
+	for (auto clip : nearby_clips)
+	{
+		long clip_start_position = round(clip->Position() * info.fps.ToDouble()) + 1;
+		long clip_end_position = round((clip->Position() + clip->Duration()) * info.fps.ToDouble()) + 1;
+
+		// Frames of the requested range which intersect this clip
+		int64_t first_frame = std::max(requested_frame, (int64_t) clip_start_position);
+		int64_t last_frame = std::min(requested_frame + number_of_frames - 1, (int64_t) clip_end_position);
+		if (first_frame <= last_frame)
+		{
+			// Get clip frame #
+			long clip_start_frame = (clip->Start() * info.fps.ToDouble()) + 1;
+			long clip_frame_number = first_frame - clip_start_position + clip_start_frame;
+
+			// Cache clip objects
+			clip->GetFrames(clip_frame_number, last_frame - first_frame + 1);
 		}
+	}
 
-		#pragma omp parallel
+	// Use the threads of this timeline's executor
+	Executor* timeline_executor = GetExecutor();
+
+	#pragma omp parallel num_threads(timeline_executor->ThreadCount())
+	{
+		timeline_executor->ApplyToCurrentThread();
+
+		// Loop through all requested frames
+		#pragma omp for ordered firstprivate(nearby_clips, requested_frame, number_of_frames) schedule(static,1)
+		for (int64_t frame_number = requested_frame; frame_number < requested_frame + number_of_frames; frame_number++)
 		{
-			// Loop through all requested frames
-			#pragma omp for ordered firstprivate(nearby_clips, requested_frame, minimum_frames) schedule(static,1)
-			for (int64_t frame_number = requested_frame; frame_number < requested_frame + minimum_frames; frame_number++)
-			{
-				// Debug output
-				ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (processing frame)", "frame_number", frame_number, "omp_get_thread_num()", omp_get_thread_num());
+			// Debug output
+			ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (processing frame)", "frame_number", frame_number, "omp_get_thread_num()", omp_get_thread_num());
 
-				// Init some basic properties about this frame
-				int samples_in_frame = Frame::GetSamplesPerFrame(frame_number, info.fps, info.sample_rate, info.channels);
+			// Init some basic properties about this frame
+			int samples_in_frame = Frame::GetSamplesPerFrame(frame_number, info.fps, info.sample_rate, info.channels);
 
-				// Create blank frame (which will become the requested frame)
-				std::shared_ptr<Frame> new_frame(std::make_shared<Frame>(frame_number, preview_width, preview_height, "#000000", samples_in_frame, info.channels));
-				#pragma omp critical (T_GetFrame)
-				{
-					new_frame->AddAudioSilence(samples_in_frame);
-					new_frame->SampleRate(info.sample_rate);
-					new_frame->ChannelsLayout(info.channel_layout);
-				}
+			// Create blank frame (which will become the requested frame)
+			std::shared_ptr<Frame> new_frame(std::make_shared<Frame>(frame_number, preview_width, preview_height, "#000000", samples_in_frame, info.channels));
+			new_frame->AddAudioSilence(samples_in_frame);
+			new_frame->SampleRate(info.sample_rate);
+			new_frame->ChannelsLayout(info.channel_layout);
 
-				// Debug output
-				ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Adding solid color)", "frame_number", frame_number, "info.width", info.width, "info.height", info.height);
+			// Debug output
+			ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Adding solid color)", "frame_number", frame_number, "info.width", info.width, "info.height", info.height);
 
-				// Add Background Color to 1st layer (if animated or not black)
-				if ((color.red.GetCount() > 1 || color.green.GetCount() > 1 || color.blue.GetCount() > 1) ||
-					(color.red.GetValue(frame_number) != 0.0 || color.green.GetValue(frame_number) != 0.0 || color.blue.GetValue(frame_number) != 0.0))
-				new_frame->AddColor(preview_width, preview_height, color.GetColorHex(frame_number));
+			// Add Background Color to 1st layer (if animated or not black)
+			if ((color.red.GetCount() > 1 || color.green.GetCount() > 1 || color.blue.GetCount() > 1) ||
+				(color.red.GetValue(frame_number) != 0.0 || color.green.GetValue(frame_number) != 0.0 || color.blue.GetValue(frame_number) != 0.0))
+			new_frame->AddColor(preview_width, preview_height, color.GetColorHex(frame_number));
+
+			// Debug output
+			ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Loop through clips)", "frame_number", frame_number, "clips.size()", clips.size(), "nearby_clips.size()", nearby_clips.size());
+
+			// Find Clips near this time
+			for (auto clip : nearby_clips)
+			{
+				long clip_start_position = round(clip->Position() * info.fps.ToDouble()) + 1;
+				long clip_end_position = round((clip->Position() + clip->Duration()) * info.fps.ToDouble()) + 1;
+
+				bool does_clip_intersect = (clip_start_position <= frame_number && clip_end_position >= frame_number);
 
 				// Debug output
-				ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Loop through clips)", "frame_number", frame_number, "clips.size()", clips.size(), "nearby_clips.size()", nearby_clips.size());
+				ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Does clip intersect)", "frame_number", frame_number, "clip->Position()", clip->Position(), "clip->Duration()", clip->Duration(), "does_clip_intersect", does_clip_intersect);
 
-				// Find Clips near this time
-				for (auto clip : nearby_clips)
+				// Clip is visible
+				if (does_clip_intersect)
 				{
-                    long clip_start_position = round(clip->Position() * info.fps.ToDouble()) + 1;
-                    long clip_end_position = round((clip->Position() + clip->Duration()) * info.fps.ToDouble()) + 1;
+					// Determine if clip is "top" clip on this layer (only happens when multiple clips are overlapping)
+					bool is_top_clip = true;
+					float max_volume = 0.0;
+					for (auto nearby_clip : nearby_clips)
+					{
+						long nearby_clip_start_position = round(nearby_clip->Position() * info.fps.ToDouble()) + 1;
+						long nearby_clip_end_position = round((nearby_clip->Position() + nearby_clip->Duration()) * info.fps.ToDouble()) + 1;
+						long nearby_clip_start_frame = (nearby_clip->Start() * info.fps.ToDouble()) + 1;
+						long nearby_clip_frame_number = frame_number - nearby_clip_start_position + nearby_clip_start_frame;
+
+						// Determine if top clip
+						if (clip->Id() != nearby_clip->Id() && clip->Layer() == nearby_clip->Layer() &&
+								nearby_clip_start_position <= frame_number && nearby_clip_end_position >= frame_number &&
+								nearby_clip_start_position > clip_start_position && is_top_clip == true) {
+							is_top_clip = false;
+						}
 
-                    bool does_clip_intersect = (clip_start_position <= frame_number && clip_end_position >= frame_number);
+						// Determine max volume of overlapping clips
+						if (nearby_clip->Reader() && nearby_clip->Reader()->info.has_audio &&
+								nearby_clip->has_audio.GetInt(nearby_clip_frame_number) != 0 &&
+								nearby_clip_start_position <= frame_number && nearby_clip_end_position >= frame_number) {
+								max_volume += nearby_clip->volume.GetValue(nearby_clip_frame_number);
+						}
+					}
+
+					// Determine the frame needed for this clip (based on the position on the timeline)
+					long clip_start_frame = (clip->Start() * info.fps.ToDouble()) + 1;
+					long clip_frame_number = frame_number - clip_start_position + clip_start_frame;
 
 					// Debug output
-					ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Does clip intersect)", "frame_number", frame_number, "clip->Position()", clip->Position(), "clip->Duration()", clip->Duration(), "does_clip_intersect", does_clip_intersect);
+					ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Calculate clip's frame #)", "clip->Position()", clip->Position(), "clip->Start()", clip->Start(), "info.fps.ToFloat()", info.fps.ToFloat(), "clip_frame_number", clip_frame_number);
 
-					// Clip is visible
-					if (does_clip_intersect)
-					{
-						// Determine if clip is "top" clip on this layer (only happens when multiple clips are overlapping)
-						bool is_top_clip = true;
-						float max_volume = 0.0;
-						for (auto nearby_clip : nearby_clips)
-						{
-                            long nearby_clip_start_position = round(nearby_clip->Position() * info.fps.ToDouble()) + 1;
-                            long nearby_clip_end_position = round((nearby_clip->Position() + nearby_clip->Duration()) * info.fps.ToDouble()) + 1;
-							long nearby_clip_start_frame = (nearby_clip->Start() * info.fps.ToDouble()) + 1;
-							long nearby_clip_frame_number = frame_number - nearby_clip_start_position + nearby_clip_start_frame;
-
-							// Determine if top clip
-							if (clip->Id() != nearby_clip->Id() && clip->Layer() == nearby_clip->Layer() &&
-                                    nearby_clip_start_position <= frame_number && nearby_clip_end_position >= frame_number &&
-                                    nearby_clip_start_position > clip_start_position && is_top_clip == true) {
-								is_top_clip = false;
-							}
-
-							// Determine max volume of overlapping clips
-							if (nearby_clip->Reader() && nearby_clip->Reader()->info.has_audio &&
-									nearby_clip->has_audio.GetInt(nearby_clip_frame_number) != 0 &&
-									nearby_clip_start_position <= frame_number && nearby_clip_end_position >= frame_number) {
-									max_volume += nearby_clip->volume.GetValue(nearby_clip_frame_number);
-							}
-						}
+					// Add clip's frame as layer
+					add_layer(new_frame, clip, clip_frame_number, frame_number, is_top_clip, max_volume);
+
+				} else
+					// Debug output
+					ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (clip does not intersect)", "frame_number", frame_number, "does_clip_intersect", does_clip_intersect);
 
-						// Determine the frame needed for this clip (based on the position on the timeline)
-                        long clip_start_frame = (clip->Start() * info.fps.ToDouble()) + 1;
-						long clip_frame_number = frame_number - clip_start_position + clip_start_frame;
+			} // end clip loop
 
-						// Debug output
-						ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Calculate clip's frame #)", "clip->Position()", clip->Position(), "clip->Start()", clip->Start(), "info.fps.ToFloat()", info.fps.ToFloat(), "clip_frame_number", clip_frame_number);
+			// Debug output
+			ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Add frame to cache)", "frame_number", frame_number, "info.width", info.width, "info.height", info.height);
 
-						// Add clip's frame as layer
-						add_layer(new_frame, clip, clip_frame_number, frame_number, is_top_clip, max_volume);
+			// Set frame # on mapped frame
+			#pragma omp ordered
+			{
+				new_frame->SetFrameNumber(frame_number);
 
-					} else
-						// Debug output
-						ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (clip does not intersect)", "frame_number", frame_number, "does_clip_intersect", does_clip_intersect);
+				// Add final frame to cache
+				final_cache->Add(new_frame);
+				if (rendered_frames)
+					rendered_frames->push_back(new_frame);
+			}
 
-				} // end clip loop
+		} // end frame loop
 
-				// Debug output
-				ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (Add frame to cache)", "frame_number", frame_number, "info.width", info.width, "info.height", info.height);
+		// Restore the previous cores and priority of this thread
+		timeline_executor->RestoreCurrentThread();
+	} // end parallel
+}
 
-				// Set frame # on mapped frame
-				#pragma omp ordered
-				{
-					new_frame->SetFrameNumber(frame_number);
+// Get a range of sequential frames of this timeline
+std::vector<std::shared_ptr<Frame>> Timeline::GetFrames(int64_t start, int64_t count)
+{
+	std::vector<std::shared_ptr<Frame>> frames;
+	if (count <= 0)
+		return frames;
+	frames.reserve(count);
 
-					// Add final frame to cache
-					final_cache->Add(new_frame);
-				}
+	// Adjust out of bounds frame number
+	if (start < 1)
+		start = 1;
 
-			} // end frame loop
-		} // end parallel
+	// Lock the timeline once for the entire range
+	std::lock_guard<std::mutex> guard(get_frame_mutex);
+	update_nested_size();
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
 
-		// Debug output
-		ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrame (end parallel region)", "requested_frame", requested_frame, "omp_get_thread_num()", omp_get_thread_num());
+	// Check for open reader (or throw exception)
+	if (!is_open)
+		throw ReaderClosed("The Timeline is closed.  Call Open() before calling this method.");
 
-		// Return frame (or blank frame)
-		return final_cache->GetFrame(requested_frame);
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("Timeline::GetFrames", "start", start, "count", count);
+
+	// Drop the frames which will not be requested again (if streaming)
+	release_streamed_clip_frames(start);
+
+	int64_t frame_number = start;
+	while (frame_number < start + count) {
+		// Use cached frame (if any)
+		std::shared_ptr<Frame> frame = final_cache->GetFrame(frame_number);
+		if (!frame && render_cache) {
+			// Use pre-rendered frame (if any)
+			frame = render_cache->GetFrame(frame_number);
+			if (frame)
+				final_cache->Add(frame);
+		}
+		if (frame) {
+			frames.push_back(frame);
+			frame_number++;
+			continue;
+		}
+
+		// Render the next block of frames in a single parallel pass
+		int number_of_frames = std::min((int64_t) GetExecutor()->ThreadCount(), start + count - frame_number);
+		render_frames(frame_number, number_of_frames, &frames);
+		frame_number += number_of_frames;
 	}
-}
 
+	return frames;
+}
 
 // Find intersecting clips (or non intersecting clips)
 std::vector<Clip*> Timeline::find_intersecting_clips(int64_t requested_frame, int number_of_frames, bool include)
 {
+	// Create a scoped lock (for this timeline), since this opens and closes clips
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
 	// Find matching clips
 	std::vector<Clip*> matching_clips;
 
@@ -908,7 +1021,6 @@ std::vector<Clip*> Timeline::find_intersecting_clips(int64_t requested_frame, in
 		ZmqLogger::Instance()->AppendDebugMethod("Timeline::find_intersecting_clips (Is clip near or intersecting)", "requested_frame", requested_frame, "min_requested_frame", min_requested_frame, "max_requested_frame", max_requested_frame, "clip->Position()", clip->Position(), "does_clip_intersect", does_clip_intersect);
 
 		// Open (or schedule for closing) this clip, based on if it's intersecting or not
-		#pragma omp critical (reader_lock)
 		update_open_clips(clip, does_clip_intersect);
 
 		// Clip is visible
@@ -939,6 +1051,69 @@ void Timeline::SetCache(CacheBase* new_cache) {
 	final_cache = new_cache;
 }
 
+// Set the executor used by the parallel sections of this timeline
+void Timeline::SetExecutor(Executor* new_executor) {
+	executor = new_executor;
+
+	// Use the same executor for the readers of all clips (and the effects of this timeline)
+	for (auto clip : clips)
+		if (clip->Reader())
+			clip->Reader()->SetExecutor(new_executor);
+	for (auto effect : effects)
+		effect->SetExecutor(new_executor);
+}
+
+// Set the settings used by this timeline
+void Timeline::SetSettings(Settings* new_settings) {
+	settings = new_settings;
+
+	// Use the same settings for the readers of all clips
+	for (auto clip : clips)
+		if (clip->Reader())
+			clip->Reader()->SetSettings(new_settings);
+}
+
+// Set whether the frames of this timeline are requested once, in order
+void Timeline::SetStreaming(bool new_streaming) {
+	streaming = new_streaming;
+
+	// The readers of all clips are streamed too (except time mapped clips, i.e. reversed, frozen or
+	// looped, which request the frames of their reader out of order)
+	for (auto clip : clips)
+		if (clip->Reader())
+			clip->Reader()->SetStreaming(new_streaming && clip->time.GetLength() <= 1);
+}
+
+// Drop the frames before a requested frame from the final cache and the caches of all clips
+void Timeline::release_streamed_clip_frames(int64_t requested_frame) {
+	if (!streaming)
+		return;
+
+	// Lock the clips while releasing their frames
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	// Final cache of this timeline
+	release_streamed_frames(final_cache, requested_frame);
+
+	// Caches of each clip (which use the frame numbers of the clip)
+	int64_t window = 2 * GetExecutor()->ThreadCount();
+	for (auto clip : clips) {
+		// Time mapped clips can request their earlier frames again (and the time curve
+		// of a clip can be edited at any time, so check it on each call)
+		bool clip_streaming = clip->time.GetLength() <= 1;
+		if (clip->Reader() && clip->Reader()->GetStreaming() != clip_streaming)
+			clip->Reader()->SetStreaming(clip_streaming);
+		if (!clip_streaming)
+			continue;
+
+		long clip_start_position = round(clip->Position() * info.fps.ToDouble()) + 1;
+		long clip_start_frame = (clip->Start() * info.fps.ToDouble()) + 1;
+		int64_t last_released_frame = requested_frame - clip_start_position + clip_start_frame - window - 1;
+		if (last_released_frame >= 1)
+			clip->GetCache()->Remove(1, last_released_frame);
+	}
+}
+
 // Generate JSON string of this object
 std::string Timeline::Json() const {
 
@@ -980,6 +1155,33 @@ Json::Value Timeline::JsonValue() const {
 	return root;
 }
 
+// Generate compact binary string of this object
+std::string Timeline::Binary() const {
+
+	// Return encoded string
+	return openshot::jsonToBinary(JsonValue());
+}
+
+// Load compact binary string into this object
+void Timeline::SetBinary(const std::string binary) {
+
+	// Get lock (prevent getting frames while this happens)
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	// Decode binary string into JSON objects
+	try
+	{
+		const Json::Value root = openshot::binaryToJson(binary);
+		// Set all values that match
+		SetJsonValue(root);
+	}
+	catch (const std::exception& e)
+	{
+		// Error decoding binary JSON (or missing keys)
+		throw InvalidJSON("Binary JSON is invalid (missing keys or invalid data types)");
+	}
+}
+
 // Load JSON string into this object
 void Timeline::SetJson(const std::string value) {
 
@@ -989,6 +1191,12 @@ void Timeline::SetJson(const std::string value) {
 	// Parse JSON string into JSON objects
 	try
 	{
+		if (GetSettings()->LAZY_LOAD_CLIPS) {
+			// Index the JSON, and only parse what is needed now
+			set_json_lazy(value);
+			return;
+		}
+
 		const Json::Value root = openshot::stringToJson(value);
 		// Set all values that match
 		SetJsonValue(root);
@@ -1000,6 +1208,59 @@ void Timeline::SetJson(const std::string value) {
 	}
 }
 
+// Load JSON string into this object, deferring the keyframes and effects of each clip
+void Timeline::set_json_lazy(const std::string& value) {
+
+	// Find the top-level members (without parsing the clips into Json::Value objects)
+	JsonRange clips_range(NULL, NULL);
+	Json::Value root(Json::objectValue);
+	for (const auto& member : openshot::scanJsonObject(JsonRange(value.data(), value.data() + value.size()))) {
+		if (member.first == "clips")
+			clips_range = member.second;
+		else
+			root[member.first] = openshot::rangeToJson(member.second);
+	}
+
+	// Set timeline properties and effects (and remove existing clips)
+	if (clips_range.first)
+		root["clips"] = Json::Value(Json::arrayValue);
+	SetJsonValue(root);
+
+	if (!clips_range.first)
+		return;
+
+	// Loop through clips (one at a time, to keep the parsed JSON small)
+	for (const JsonRange& clip_range : openshot::scanJsonArray(clips_range)) {
+		Json::Value clip_root(Json::objectValue);
+		std::string deferred;
+
+		for (const auto& member : openshot::scanJsonObject(clip_range)) {
+			// The reader and time curve are needed to find the duration of the clip, so they are
+			// parsed now. Other objects and arrays (keyframes and effects) are deferred.
+			bool is_compound = *member.second.first == '{' || *member.second.first == '[';
+			if (is_compound && member.first != "reader" && member.first != "time") {
+				deferred += deferred.empty() ? "{" : ",";
+				deferred += Json::valueToQuotedString(member.first.c_str());
+				deferred += ":";
+				deferred.append(member.second.first, member.second.second);
+			}
+			else
+				clip_root[member.first] = openshot::rangeToJson(member.second);
+		}
+
+		// Create Clip
+		Clip *c = new Clip();
+
+		// Load Json into Clip (and defer the rest until the clip is used)
+		c->SetJsonValue(clip_root);
+		if (!deferred.empty())
+			c->DeferJson(deferred + "}");
+
+		// Add Clip to Timeline
+		AddClip(c);
+	}
+}
+
 // Load Json::Value into this object
 void Timeline::SetJsonValue(const Json::Value root) {
 
@@ -1064,6 +1325,9 @@ void Timeline::SetJsonValue(const Json::Value root) {
 	preview_width = info.width;
 	preview_height = info.height;
 
+	// Pre-rendered ranges need to be compared again
+	invalidate_fingerprints();
+
 	// Re-open if needed
 	if (was_open)
 		Open();
@@ -1079,34 +1343,64 @@ void Timeline::ApplyJsonDiff(std::string value) {
 	try
 	{
 		const Json::Value root = openshot::stringToJson(value);
-		// Process the JSON change array, loop through each item
-		for (const Json::Value change : root) {
-			std::string change_key = change["key"][(uint)0].asString();
-
-			// Process each type of change
-			if (change_key == "clips")
-				// Apply to CLIPS
-				apply_json_to_clips(change);
+		// Process the JSON change array
+		apply_json_diff(root);
+	}
+	catch (const std::exception& e)
+	{
+		// Error parsing JSON (or missing keys)
+		throw InvalidJSON("JSON is invalid (missing keys or invalid data types)");
+	}
+}
 
-			else if (change_key == "effects")
-				// Apply to EFFECTS
-				apply_json_to_effects(change);
+// Apply a change to the timeline, encoded as a compact binary string
+void Timeline::ApplyBinaryDiff(const std::string binary) {
 
-			else
-				// Apply to TIMELINE
-				apply_json_to_timeline(change);
+	// Get lock (prevent getting frames while this happens)
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
 
-		}
+	// Decode binary string into JSON objects
+	try
+	{
+		const Json::Value root = openshot::binaryToJson(binary);
+		// Process the JSON change array
+		apply_json_diff(root);
 	}
 	catch (const std::exception& e)
 	{
-		// Error parsing JSON (or missing keys)
-		throw InvalidJSON("JSON is invalid (missing keys or invalid data types)");
+		// Error decoding binary JSON (or missing keys)
+		throw InvalidJSON("Binary JSON is invalid (missing keys or invalid data types)");
+	}
+}
+
+// Apply an array of JSON diffs
+void Timeline::apply_json_diff(const Json::Value& root) {
+
+	// Pre-rendered ranges need to be compared again
+	invalidate_fingerprints();
+
+	// Loop through each item
+	for (const Json::Value& change : root) {
+		std::string change_key = change["key"][(uint)0].asString();
+
+		// Process each type of change
+		if (change_key == "clips")
+			// Apply to CLIPS
+			apply_json_to_clips(change);
+
+		else if (change_key == "effects")
+			// Apply to EFFECTS
+			apply_json_to_effects(change);
+
+		else
+			// Apply to TIMELINE
+			apply_json_to_timeline(change);
+
 	}
 }
 
 // Apply JSON diff to clips
-void Timeline::apply_json_to_clips(Json::Value change) {
+void Timeline::apply_json_to_clips(const Json::Value& change) {
 
 	// Get key and type of change
 	std::string change_type = change["type"].asString();
@@ -1227,7 +1521,7 @@ void Timeline::apply_json_to_clips(Json::Value change) {
 }
 
 // Apply JSON diff to effects
-void Timeline::apply_json_to_effects(Json::Value change) {
+void Timeline::apply_json_to_effects(const Json::Value& change) {
 
 	// Get key and type of change
 	std::string change_type = change["type"].asString();
@@ -1263,7 +1557,7 @@ void Timeline::apply_json_to_effects(Json::Value change) {
 }
 
 // Apply JSON diff to effects (if you already know which effect needs to be updated)
-void Timeline::apply_json_to_effects(Json::Value change, EffectBase* existing_effect) {
+void Timeline::apply_json_to_effects(const Json::Value& change, EffectBase* existing_effect) {
 
 	// Get key and type of change
 	std::string change_type = change["type"].asString();
@@ -1344,7 +1638,7 @@ void Timeline::apply_json_to_effects(Json::Value change, EffectBase* existing_ef
 }
 
 // Apply JSON diff to timeline properties
-void Timeline::apply_json_to_timeline(Json::Value change) {
+void Timeline::apply_json_to_timeline(const Json::Value& change) {
 
 	// Get key and type of change
 	std::string change_type = change["type"].asString();
@@ -1475,34 +1769,229 @@ void Timeline::ClearAllCache() {
     // Clear primary cache
     final_cache->Clear();
 
+	// Pre-rendered ranges need to be compared again (keyframes or properties could have changed directly)
+	invalidate_fingerprints();
+
     // Loop through all clips
     for (auto clip : clips)
     {
         // Clear cache on clip
 		clip->GetCache()->Clear();
-        clip->Reader()->GetCache()->Clear();
+
+		// Nested timelines keep their rendered output, since edits to this timeline
+		// do not change it (they clear their own cache when they are edited or resized)
+		if (clip->Reader()->Name() != "Timeline")
+			clip->Reader()->GetCache()->Clear();
 
         // Clear nested Reader (if any)
         if (clip->Reader()->Name() == "FrameMapper") {
 			FrameMapper* nested_reader = (FrameMapper*) clip->Reader();
-			if (nested_reader->Reader() && nested_reader->Reader()->GetCache())
+			if (nested_reader->Reader() && nested_reader->Reader()->GetCache() &&
+				nested_reader->Reader()->Name() != "Timeline")
 				nested_reader->Reader()->GetCache()->Clear();
 		}
 
     }
 }
 
+// Match the preview size of a nested timeline to the size its parent clip needs
+void Timeline::update_nested_size() {
+
+	// Only nested timelines (used as the reader of a clip on another timeline)
+	Clip* parent = (Clip*) ParentClip();
+	if (!parent || !parent->ParentTimeline())
+		return;
+
+	// Start with the preview size of the parent timeline
+	int max_width = parent->ParentTimeline()->preview_width;
+	int max_height = parent->ParentTimeline()->preview_height;
+
+	if (parent->scale == SCALE_FIT || parent->scale == SCALE_STRETCH) {
+		// Best fit or Stretch scaling (based on max timeline size * scaling keyframes)
+		QSizeF max_scale = parent->GetMaxScale();
+		max_width = std::max(float(max_width), max_width * float(max_scale.width()));
+		max_height = std::max(float(max_height), max_height * float(max_scale.height()));
+
+	} else if (parent->scale == SCALE_CROP) {
+		// Cropping scale mode (based on max timeline size * cropped size * scaling keyframes)
+		QSizeF max_scale = parent->GetMaxScale();
+		QSize width_size(max_width * max_scale.width(),
+						 round(max_width / (float(info.width) / float(info.height))));
+		QSize height_size(round(max_height / (float(info.height) / float(info.width))),
+						  max_height * max_scale.height());
+		// respect aspect ratio
+		if (width_size.width() >= max_width && width_size.height() >= max_height) {
+			max_width = std::max(max_width, width_size.width());
+			max_height = std::max(max_height, width_size.height());
+		} else {
+			max_width = std::max(max_width, height_size.width());
+			max_height = std::max(max_height, height_size.height());
+		}
+
+	} else {
+		// No scaling, use full timeline size
+		max_width = info.width;
+		max_height = info.height;
+	}
+
+	// Nothing to do if the size has not changed (SetMaxSize also invalidates any pre-rendered ranges)
+	int previous_width = preview_width;
+	int previous_height = preview_height;
+	QSize new_size = calculate_preview_size(max_width, max_height);
+	if (new_size.width() == previous_width && new_size.height() == previous_height)
+		return;
+	SetMaxSize(max_width, max_height);
+
+	// Debug output
+	ZmqLogger::Instance()->AppendDebugMethod("Timeline::update_nested_size", "preview_width", preview_width, "preview_height", preview_height, "previous_width", previous_width, "previous_height", previous_height);
+
+	// Cached frames are the wrong size now
+	ClearAllCache();
+
+	// Size the cache from the frames it will actually hold, so a nested timeline
+	// rendered at a smaller size takes a smaller share of memory
+	if (managed_cache && final_cache)
+		final_cache->SetMaxBytesFromInfo(OPEN_MP_NUM_PROCESSORS_FOR(GetSettings()) * 2, preview_width, preview_height, info.sample_rate, info.channels);
+}
+
+// Add the size and modification time of each media file (any "path" attribute) to a fingerprint
+static void add_media_fingerprint(const Json::Value& value, Json::Value& media) {
+	if (value.isObject()) {
+		if (value["path"].isString() && !value["path"].asString().empty()) {
+			QFileInfo media_file(QString::fromStdString(value["path"].asString()));
+			media[value["path"].asString()] = QString("%1-%2").arg(media_file.size()).arg(media_file.lastModified().toMSecsSinceEpoch()).toStdString();
+		}
+		for (const auto& member : value)
+			add_media_fingerprint(member, media);
+
+	} else if (value.isArray()) {
+		for (const auto& item : value)
+			add_media_fingerprint(item, media);
+	}
+}
+
+// The timeline has changed (forget the fingerprints of all ranges)
+void Timeline::invalidate_fingerprints() {
+
+	// Get lock (the fingerprints are generated while holding it)
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+	fingerprints.clear();
+
+	// Cancel the range being pre-rendered (if any)
+	if (render_cache)
+		render_cache->Invalidate();
+}
+
+// Generate a fingerprint of everything which affects the frames of a range
+std::string Timeline::Fingerprint(int64_t start_frame, int64_t end_frame) {
+
+	// Get lock (prevent changes while this happens)
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	// Use the fingerprint of this range (if the timeline has not changed since it was generated)
+	auto cached_fingerprint = fingerprints.find(std::make_pair(start_frame, end_frame));
+	if (cached_fingerprint != fingerprints.end())
+		return cached_fingerprint->second;
+
+	// Timeline settings (the duration is not included, since it changes with every clip)
+	Json::Value root;
+	root["start"] = (Json::Int64) start_frame;
+	root["end"] = (Json::Int64) end_frame;
+	root["width"] = info.width;
+	root["height"] = info.height;
+	root["preview_width"] = preview_width;
+	root["preview_height"] = preview_height;
+	root["fps"]["num"] = info.fps.num;
+	root["fps"]["den"] = info.fps.den;
+	root["sample_rate"] = info.sample_rate;
+	root["channels"] = info.channels;
+	root["channel_layout"] = info.channel_layout;
+	root["viewport_scale"] = viewport_scale.JsonValue();
+	root["viewport_x"] = viewport_x.JsonValue();
+	root["viewport_y"] = viewport_y.JsonValue();
+	root["color"] = color.JsonValue();
+
+	// Clips and effects which overlap the range (including the frame before, which the audio is faded from)
+	root["clips"] = Json::Value(Json::arrayValue);
+	for (const auto clip : clips) {
+		long clip_start_position = round(clip->Position() * info.fps.ToDouble()) + 1;
+		long clip_end_position = round((clip->Position() + clip->Duration()) * info.fps.ToDouble()) + 1;
+		if (clip_start_position <= end_frame && clip_end_position >= start_frame - 1)
+			root["clips"].append(clip->JsonValue());
+	}
+	root["effects"] = Json::Value(Json::arrayValue);
+	for (const auto effect : effects) {
+		long effect_start_position = round(effect->Position() * info.fps.ToDouble()) + 1;
+		long effect_end_position = round((effect->Position() + effect->Duration()) * info.fps.ToDouble()) + 1;
+		if (effect_start_position <= end_frame && effect_end_position >= start_frame - 1)
+			root["effects"].append(effect->JsonValue());
+	}
+
+	// Media files used by these clips (i.e. a file replaced on disk)
+	Json::Value media(Json::objectValue);
+	add_media_fingerprint(root["clips"], media);
+	add_media_fingerprint(root["effects"], media);
+	root["media"] = media;
+
+	// Hash the compact JSON (64-bit FNV-1a)
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+	std::string data = Json::writeString(builder, root);
+	uint64_t hash = 14695981039346656037ULL;
+	for (const unsigned char c : data) {
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+
+	std::string fingerprint = QString("%1").arg((qulonglong) hash, 16, 16, QChar('0')).toStdString();
+	fingerprints[std::make_pair(start_frame, end_frame)] = fingerprint;
+	return fingerprint;
+}
+
+// Precompute the keyframe values of all clips for a range of timeline frames
+void Timeline::BakeClips(int64_t start_frame, int64_t end_frame) {
+
+	// Get lock (prevent getting frames while this happens)
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	for (auto clip : clips)
+	{
+		// Find the frames of this clip which are inside the range (if any)
+		long clip_start_position = round(clip->Position() * info.fps.ToDouble()) + 1;
+		long clip_end_position = round((clip->Position() + clip->Duration()) * info.fps.ToDouble()) + 1;
+		long clip_start_frame = (clip->Start() * info.fps.ToDouble()) + 1;
+		int64_t first_frame = std::max(start_frame, (int64_t) clip_start_position);
+		int64_t last_frame = std::min(end_frame, (int64_t) clip_end_position);
+
+		if (first_frame <= last_frame)
+			// Include the frame before the range (audio volume is faded from the previous frame)
+			clip->Bake(first_frame - clip_start_position + clip_start_frame - 1, last_frame - clip_start_position + clip_start_frame);
+		else
+			clip->ClearBake();
+	}
+}
+
+// Remove the precomputed keyframe values of all clips
+void Timeline::ClearBakedClips() {
+
+	// Get lock (prevent getting frames while this happens)
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
+
+	for (auto clip : clips)
+		clip->ClearBake();
+}
+
 // Set Max Image Size (used for performance optimization). Convenience function for setting
 // Settings::Instance()->MAX_WIDTH and Settings::Instance()->MAX_HEIGHT.
 void Timeline::SetMaxSize(int width, int height) {
-	// Maintain aspect ratio regardless of what size is passed in
-	QSize display_ratio_size = QSize(info.display_ratio.num * info.pixel_ratio.ToFloat(), info.display_ratio.den * info.pixel_ratio.ToFloat());
-	QSize proposed_size = QSize(std::min(width, info.width), std::min(height, info.height));
-
-	// Scale QSize up to proposed size
-	display_ratio_size.scale(proposed_size, Qt::KeepAspectRatio);
+	// Get lock (wait for any frames being rendered at the previous size, i.e. by the player's cache thread)
+	const GenericScopedLock<CriticalSection> lock(getFrameCriticalSection);
 
 	// Update preview settings
+	QSize display_ratio_size = calculate_preview_size(width, height);
 	preview_width = display_ratio_size.width();
 	preview_height = display_ratio_size.height();
+
+	// Pre-rendered ranges need to be compared again
+	invalidate_fingerprints();
 }
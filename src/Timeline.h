@@ -32,6 +32,7 @@
 #define OPENSHOT_TIMELINE_H
 
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -54,6 +55,7 @@
 #include "KeyFrame.h"
 #include "OpenMPUtilities.h"
 #include "ReaderBase.h"
+#include "RenderCache.h"
 #include "Settings.h"
 #include "TimelineBase.h"
 
@@ -175,8 +177,11 @@ namespace openshot {
 		openshot::CacheBase *final_cache; ///<Final cache of timeline frames
 		std::set<openshot::FrameMapper*> allocated_frame_mappers; ///< all the frame mappers we allocated and must free
 		bool managed_cache; ///< Does this timeline instance manage the cache object
+		openshot::RenderCache* render_cache; ///< Pre-rendered ranges of this timeline (if any)
+		std::map<std::pair<int64_t, int64_t>, std::string> fingerprints; ///< The fingerprint of each range (cleared by every change)
 		std::string path; ///< Optional path of loaded UTF-8 OpenShot JSON project file
 		std::mutex get_frame_mutex; ///< Mutex to protect GetFrame method from different threads calling it
+		juce::CriticalSection addLayerCriticalSection; ///< Section lock for getting clip frames and applying effects (for this timeline only)
 
 		/// Process a new layer of video or audio
 		void add_layer(std::shared_ptr<openshot::Frame> new_frame, openshot::Clip* source_clip, int64_t clip_frame_number, int64_t timeline_frame_number, bool is_top_clip, float max_volume);
@@ -184,15 +189,22 @@ namespace openshot {
 		/// Apply a FrameMapper to a clip which matches the settings of this timeline
 		void apply_mapper_to_clip(openshot::Clip* clip);
 
+		/// Load JSON string into this object, deferring the keyframes and effects of each clip (see Clip::DeferJson)
+		void set_json_lazy(const std::string& value);
+
 		/// Apply JSON Diffs to various objects contained in this timeline
-		void apply_json_to_clips(Json::Value change); ///<Apply JSON diff to clips
-		void apply_json_to_effects(Json::Value change); ///< Apply JSON diff to effects
-		void apply_json_to_effects(Json::Value change, openshot::EffectBase* existing_effect); ///<Apply JSON diff to a specific effect
-		void apply_json_to_timeline(Json::Value change); ///<Apply JSON diff to timeline properties
+		void apply_json_diff(const Json::Value& root); ///<Apply an array of JSON diffs
+		void apply_json_to_clips(const Json::Value& change); ///<Apply JSON diff to clips
+		void apply_json_to_effects(const Json::Value& change); ///< Apply JSON diff to effects
+		void apply_json_to_effects(const Json::Value& change, openshot::EffectBase* existing_effect); ///<Apply JSON diff to a specific effect
+		void apply_json_to_timeline(const Json::Value& change); ///<Apply JSON diff to timeline properties
 
 		/// Calculate time of a frame number, based on a framerate
 		double calculate_time(int64_t number, openshot::Fraction rate);
 
+		/// Calculate the preview size for a maximum width and height (maintaining the aspect ratio, see SetMaxSize)
+		QSize calculate_preview_size(int width, int height);
+
 		/// Find intersecting (or non-intersecting) openshot::Clip objects
 		///
 		/// @returns A list of openshot::Clip objects
@@ -204,6 +216,19 @@ namespace openshot {
 		/// Get or generate a blank frame
 		std::shared_ptr<openshot::Frame> GetOrCreateFrame(openshot::Clip* clip, int64_t number);
 
+		/// Drop the frames before a requested frame from the final cache and the caches of all clips (if streaming)
+		void release_streamed_clip_frames(int64_t requested_frame);
+
+		/// The timeline has changed (forget the fingerprints of all ranges, and cancel the range being pre-rendered)
+		void invalidate_fingerprints();
+
+		/// Render a range of sequential frames (in parallel), and add them to the final cache
+		///
+		/// @param requested_frame The first frame number to render.
+		/// @param number_of_frames The number of frames to render
+		/// @param rendered_frames Optional list, which receives the rendered frames (in order)
+		void render_frames(int64_t requested_frame, int number_of_frames, std::vector<std::shared_ptr<openshot::Frame>>* rendered_frames);
+
 		/// Apply effects to the source frame (if any)
 		std::shared_ptr<openshot::Frame> apply_effects(std::shared_ptr<openshot::Frame> frame, int64_t timeline_frame_number, int layer);
 
@@ -219,6 +244,9 @@ namespace openshot {
 		/// Update the list of 'opened' clips
 		void update_open_clips(openshot::Clip *clip, bool does_clip_intersect);
 
+		/// Match the preview size of a nested timeline to the size its parent clip needs
+		void update_nested_size();
+
 	public:
 
 		/// @brief Default Constructor for the timeline (which configures the default frame properties)
@@ -255,6 +283,14 @@ namespace openshot {
 		/// Determine if clips are automatically mapped to the timeline's framerate and samplerate
 		bool AutoMapClips() { return auto_map_clips; };
 
+		/// @brief Precompute the keyframe values of all clips for a range of timeline frames (see Clip::Bake)
+		/// @param start_frame The first frame number of the timeline (i.e. of an export)
+		/// @param end_frame The last frame number of the timeline
+		void BakeClips(int64_t start_frame, int64_t end_frame);
+
+		/// Remove the precomputed keyframe values of all clips
+		void ClearBakedClips();
+
 		/// @brief Automatically map all clips to the timeline's framerate and samplerate
 		void AutoMapClips(bool auto_map) { auto_map_clips = auto_map; };
 
@@ -291,12 +327,52 @@ namespace openshot {
 		/// of this cache object though (Timeline will not delete it for you).
 		void SetCache(openshot::CacheBase* new_cache);
 
+		/// Get the pre-rendered ranges used by this timeline (if any)
+		openshot::RenderCache* GetRenderCache() { return render_cache; };
+
+		/// Set the pre-rendered ranges used by this timeline (NULL = none). You must manage the lifecycle
+		/// of this object (Timeline will not delete it for you).
+		void SetRenderCache(openshot::RenderCache* new_render_cache) { render_cache = new_render_cache; };
+
+		/// @brief Generate a fingerprint of everything which affects the frames of a range (used by openshot::RenderCache)
+		///
+		/// This includes the timeline settings, the clips and effects which overlap the range, and the size
+		/// and modification time of their media files (including the files used by effects, i.e. a mask).
+		/// The fingerprint of each range is only generated once, until the timeline changes (clips or effects
+		/// are added or removed, JSON is applied, the preview size changes, or ClearAllCache is called, which
+		/// is needed after changing keyframes or properties directly).
+		/// @param start_frame The first frame number of the range
+		/// @param end_frame The last frame number of the range
+		std::string Fingerprint(int64_t start_frame, int64_t end_frame);
+
+		/// Set the executor used by the parallel sections of this timeline (and the readers of its clips).
+		/// You must manage the lifecycle of the executor (Timeline will not delete it for you).
+		void SetExecutor(openshot::Executor* new_executor) override;
+
+		/// Set the settings used by this timeline (and the readers of its clips), overriding the global settings.
+		/// You must manage the lifecycle of the settings object (Timeline will not delete it for you).
+		void SetSettings(openshot::Settings* new_settings) override;
+
+		/// Set whether the frames of this timeline are requested once, in order (i.e. during an export). When
+		/// streaming, the final cache, the caches of its clips, and the readers of its clips only keep a short
+		/// window of frames behind the requested frame. Time mapped clips (i.e. reversed, frozen or looped)
+		/// keep all of their frames.
+		void SetStreaming(bool new_streaming) override;
+
 		/// Get an openshot::Frame object for a specific frame number of this timeline.
 		///
 		/// @returns The requested frame (containing the image)
 		/// @param requested_frame The frame number that is requested.
 		std::shared_ptr<openshot::Frame> GetFrame(int64_t requested_frame) override;
 
+		/// Get a range of sequential frames of this timeline, rendering each missing block
+		/// of frames in a single parallel pass (and only locking the timeline once).
+		///
+		/// @returns The requested frames (in order)
+		/// @param start The first frame number that is requested.
+		/// @param count The number of frames requested.
+		std::vector<std::shared_ptr<openshot::Frame>> GetFrames(int64_t start, int64_t count) override;
+
 		// Curves for the viewport
 		openshot::Keyframe viewport_scale; ///<Curve representing the scale of the viewport (0 to 100)
 		openshot::Keyframe viewport_x; ///<Curve representing the x coordinate for the viewport
@@ -317,8 +393,13 @@ namespace openshot {
 		Json::Value JsonValue() const override; ///< Generate Json::Value for this object
 		void SetJsonValue(const Json::Value root) override; ///< Load Json::Value into this object
 
+		/// Get and Set compact binary methods (see openshot::jsonToBinary)
+		std::string Binary() const; ///< Generate compact binary string of this object
+		void SetBinary(const std::string binary); ///< Load compact binary string into this object
+
 		/// Set Max Image Size (used for performance optimization). Convenience function for setting
-		/// Settings::Instance()->MAX_WIDTH and Settings::Instance()->MAX_HEIGHT.
+		/// Settings::Instance()->MAX_WIDTH and Settings::Instance()->MAX_HEIGHT. This can be called while
+		/// other threads get frames (it waits for the frames being rendered).
 		void SetMaxSize(int width, int height);
 
 		/// @brief Apply a special formatted JSON object, which represents a change to the timeline (add, update, delete)
@@ -327,6 +408,12 @@ namespace openshot {
 		/// @param value A JSON string containing a key, value, and type of change.
 		void ApplyJsonDiff(std::string value);
 
+		/// @brief Apply a change to the timeline, encoded as a compact binary string (see openshot::jsonToBinary)
+		/// This is the same as ApplyJsonDiff(), but it is much faster to decode (i.e. for many small changes
+		/// while dragging keyframes).
+		/// @param binary A binary encoded JSON array, containing a key, value, and type of change.
+		void ApplyBinaryDiff(const std::string binary);
+
 		/// Open the reader (and start consuming resources)
 		void Open() override;
 
@@ -61,6 +61,21 @@ WriterBase::WriterBase()
 	info.channel_layout = LAYOUT_MONO;
 	info.audio_stream_index = -1;
 	info.audio_timebase = Fraction();
+
+	// Init executor (NULL uses the default executor)
+	executor = NULL;
+
+	// Init settings (NULL uses the global settings)
+	settings = NULL;
+}
+
+// Get the executor used by the parallel sections of this writer
+Executor* WriterBase::GetExecutor()
+{
+	if (executor)
+		return executor;
+	else
+		return Executor::Default();
 }
 
 // This method copy's the info struct of a reader, and sets the writer with the same info
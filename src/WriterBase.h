@@ -34,9 +34,11 @@
 #include <iostream>
 #include <iomanip>
 #include "ChannelLayouts.h"
+#include "Executor.h"
 #include "Fraction.h"
 #include "Frame.h"
 #include "ReaderBase.h"
+#include "Settings.h"
 #include "ZmqLogger.h"
 
 namespace openshot
@@ -86,6 +88,10 @@ namespace openshot
 	 */
 	class WriterBase
 	{
+	protected:
+		openshot::Executor* executor; ///< Pointer to the executor of this writer (or NULL for the default executor)
+		openshot::Settings* settings; ///< Pointer to the settings of this writer (or NULL for the global settings)
+
 	public:
 		/// Constructor for WriterBase class, many things are initialized here
 		WriterBase();
@@ -97,6 +103,20 @@ namespace openshot
 		/// @param reader The source reader to copy
 		void CopyReaderInfo(openshot::ReaderBase* reader);
 
+		/// Get the executor used by the parallel sections of this writer
+		openshot::Executor* GetExecutor();
+
+		/// Set the executor used by the parallel sections of this writer.
+		/// You must manage the lifecycle of the executor (this writer will not delete it for you).
+		void SetExecutor(openshot::Executor* new_executor) { executor = new_executor; };
+
+		/// Get the settings used by this writer (its own settings, or the global settings)
+		openshot::Settings* GetSettings() { return settings ? settings : openshot::Settings::Instance(); };
+
+		/// Set the settings used by this writer, overriding the global settings (see Settings::Create).
+		/// You must manage the lifecycle of the settings object.
+		void SetSettings(openshot::Settings* new_settings) { settings = new_settings; };
+
 		/// Determine if writer is open or closed
 		virtual bool IsOpen() = 0;
 
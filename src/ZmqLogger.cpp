@@ -42,6 +42,7 @@ using namespace openshot;
 #include <ctime>
 #include <thread>    // for std::this_thread::sleep_for
 #include <chrono>    // for std::duration::microseconds
+#include <mutex>     // for std::call_once
 
 
 // Global reference to logger
@@ -50,7 +51,9 @@ ZmqLogger *ZmqLogger::m_pInstance = NULL;
 // Create or Get an instance of the logger singleton
 ZmqLogger *ZmqLogger::Instance()
 {
-	if (!m_pInstance) {
+	// Create the instance only once (even when called from many threads at the same time)
+	static std::once_flag instance_created;
+	std::call_once(instance_created, []() {
 		// Create the actual instance of logger only once
 		m_pInstance = new ZmqLogger;
 
@@ -70,7 +73,7 @@ ZmqLogger *ZmqLogger::Instance()
 			// This can only happen 1 time or it will crash
 			ResvgRenderer::initLog();
 		#endif
-	}
+	});
 
 	return m_pInstance;
 }
@@ -198,35 +201,34 @@ void ZmqLogger::AppendDebugMethod(std::string method_name,
 		// Don't do anything
 		return;
 
-	{
-		// Create a scoped lock, allowing only a single thread to run the following code at one time
-		const juce::GenericScopedLock<juce::CriticalSection> lock(loggerCriticalSection);
-
-		std::stringstream message;
-		message << std::fixed << std::setprecision(4);
+	// Construct message (before locking, so other threads are not blocked while formatting)
+	std::stringstream message;
+	message << std::fixed << std::setprecision(4);
+	message << method_name << " (";
 
-		// Construct message
-		message << method_name << " (";
+	if (arg1_name.length() > 0)
+		message << arg1_name << "=" << arg1_value;
 
-		if (arg1_name.length() > 0)
-			message << arg1_name << "=" << arg1_value;
+	if (arg2_name.length() > 0)
+		message << ", " << arg2_name << "=" << arg2_value;
 
-		if (arg2_name.length() > 0)
-			message << ", " << arg2_name << "=" << arg2_value;
+	if (arg3_name.length() > 0)
+		message << ", " << arg3_name << "=" << arg3_value;
 
-		if (arg3_name.length() > 0)
-			message << ", " << arg3_name << "=" << arg3_value;
+	if (arg4_name.length() > 0)
+		message << ", " << arg4_name << "=" << arg4_value;
 
-		if (arg4_name.length() > 0)
-			message << ", " << arg4_name << "=" << arg4_value;
+	if (arg5_name.length() > 0)
+		message << ", " << arg5_name << "=" << arg5_value;
 
-		if (arg5_name.length() > 0)
-			message << ", " << arg5_name << "=" << arg5_value;
+	if (arg6_name.length() > 0)
+		message << ", " << arg6_name << "=" << arg6_value;
 
-		if (arg6_name.length() > 0)
-			message << ", " << arg6_name << "=" << arg6_value;
+	message << ")" << std::endl;
 
-		message << ")" << std::endl;
+	{
+		// Create a scoped lock, allowing only a single thread to run the following code at one time
+		const juce::GenericScopedLock<juce::CriticalSection> lock(loggerCriticalSection);
 
 		if (openshot::Settings::Instance()->DEBUG_TO_STDERR) {
 			// Print message to stderr
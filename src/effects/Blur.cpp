@@ -112,59 +112,77 @@ std::shared_ptr<Frame> Blur::GetFrame(std::shared_ptr<Frame> frame, int64_t fram
 void Blur::boxBlurH(unsigned char *scl, unsigned char *tcl, int w, int h, int r) {
 	float iarr = 1.0 / (r + r + 1);
 
-	#pragma omp parallel for shared (scl, tcl)
-	for (int i = 0; i < h; ++i) {
-		for (int ch = 0; ch < 4; ++ch) {
-			int ti = i * w, li = ti, ri = ti + r;
-			int fv = scl[ti * 4 + ch], lv = scl[(ti + w - 1) * 4 + ch], val = (r + 1) * fv;
-			for (int j = 0; j < r; ++j) {
-				val += scl[(ti + j) * 4 + ch];
-			}
-			for (int j = 0; j <= r; ++j) {
-				val += scl[ri++ * 4 + ch] - fv;
-				tcl[ti++ * 4 + ch] = round(val * iarr);
-			}
-			for (int j = r + 1; j < w - r; ++j) {
-				val += scl[ri++ * 4 + ch] - scl[li++ * 4 + ch];
-				tcl[ti++ * 4 + ch] = round(val * iarr);
-			}
-			for (int j = w - r; j < w; ++j) {
-				val += lv - scl[li++ * 4 + ch];
-				tcl[ti++ * 4 + ch] = round(val * iarr);
+	Executor* effect_executor = GetExecutor();
+	#pragma omp parallel num_threads(effect_executor->ThreadCount()) shared (scl, tcl)
+	{
+		effect_executor->ApplyToCurrentThread();
+
+		#pragma omp for
+		for (int i = 0; i < h; ++i) {
+			for (int ch = 0; ch < 4; ++ch) {
+				int ti = i * w, li = ti, ri = ti + r;
+				int fv = scl[ti * 4 + ch], lv = scl[(ti + w - 1) * 4 + ch], val = (r + 1) * fv;
+				for (int j = 0; j < r; ++j) {
+					val += scl[(ti + j) * 4 + ch];
+				}
+				for (int j = 0; j <= r; ++j) {
+					val += scl[ri++ * 4 + ch] - fv;
+					tcl[ti++ * 4 + ch] = round(val * iarr);
+				}
+				for (int j = r + 1; j < w - r; ++j) {
+					val += scl[ri++ * 4 + ch] - scl[li++ * 4 + ch];
+					tcl[ti++ * 4 + ch] = round(val * iarr);
+				}
+				for (int j = w - r; j < w; ++j) {
+					val += lv - scl[li++ * 4 + ch];
+					tcl[ti++ * 4 + ch] = round(val * iarr);
+				}
 			}
 		}
+
+		// Restore the previous cores and priority of this thread
+		effect_executor->RestoreCurrentThread();
 	}
 }
 
 void Blur::boxBlurT(unsigned char *scl, unsigned char *tcl, int w, int h, int r) {
 	float iarr = 1.0 / (r + r + 1);
 
-	#pragma omp parallel for shared (scl, tcl)
-	for (int i = 0; i < w; i++) {
-		for (int ch = 0; ch < 4; ++ch) {
-			int ti = i, li = ti, ri = ti + r * w;
-			int fv = scl[ti * 4 + ch], lv = scl[(ti + w * (h - 1)) * 4 + ch], val = (r + 1) * fv;
-			for (int j = 0; j < r; j++) val += scl[(ti + j * w) * 4 + ch];
-			for (int j = 0; j <= r; j++) {
-				val += scl[ri * 4 + ch] - fv;
-				tcl[ti * 4 + ch] = round(val * iarr);
-				ri += w;
-				ti += w;
-			}
-			for (int j = r + 1; j < h - r; j++) {
-				val += scl[ri * 4 + ch] - scl[li * 4 + ch];
-				tcl[ti * 4 + ch] = round(val * iarr);
-				li += w;
-				ri += w;
-				ti += w;
-			}
-			for (int j = h - r; j < h; j++) {
-				val += lv - scl[li * 4 + ch];
-				tcl[ti * 4 + ch] = round(val * iarr);
-				li += w;
-				ti += w;
+	Executor* effect_executor = GetExecutor();
+	#pragma omp parallel num_threads(effect_executor->ThreadCount()) shared (scl, tcl)
+	{
+		effect_executor->ApplyToCurrentThread();
+
+		#pragma omp for
+		for (int i = 0; i < w; i++) {
+			for (int ch = 0; ch < 4; ++ch) {
+				int ti = i, li = ti, ri = ti + r * w;
+				int fv = scl[ti * 4 + ch], lv = scl[(ti + w * (h - 1)) * 4 + ch], val = (r + 1) * fv;
+				for (int j = 0; j < r; j++) val += scl[(ti + j * w) * 4 + ch];
+				for (int j = 0; j <= r; j++) {
+					val += scl[ri * 4 + ch] - fv;
+					tcl[ti * 4 + ch] = round(val * iarr);
+					ri += w;
+					ti += w;
+				}
+				for (int j = r + 1; j < h - r; j++) {
+					val += scl[ri * 4 + ch] - scl[li * 4 + ch];
+					tcl[ti * 4 + ch] = round(val * iarr);
+					li += w;
+					ri += w;
+					ti += w;
+				}
+				for (int j = h - r; j < h; j++) {
+					val += lv - scl[li * 4 + ch];
+					tcl[ti * 4 + ch] = round(val * iarr);
+					li += w;
+					ti += w;
+				}
 			}
 		}
+
+		// Restore the previous cores and priority of this thread
+		effect_executor->RestoreCurrentThread();
 	}
 }
 
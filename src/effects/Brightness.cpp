@@ -74,22 +74,31 @@ std::shared_ptr<Frame> Brightness::GetFrame(std::shared_ptr<Frame> frame, int64_
 	unsigned char *pixels = (unsigned char *) frame_image->bits();
 	int pixel_count = frame_image->width() * frame_image->height();
 
-	#pragma omp parallel for
-	for (int pixel = 0; pixel < pixel_count; ++pixel)
+	Executor* effect_executor = GetExecutor();
+	#pragma omp parallel num_threads(effect_executor->ThreadCount())
 	{
-		// Compute contrast adjustment factor
-		float factor = (259 * (contrast_value + 255)) / (255 * (259 - contrast_value));
-
-		// Get RGB pixels from image and apply constrained contrast adjustment
-		int R = constrain((factor * (pixels[pixel * 4] - 128)) + 128);
-		int G = constrain((factor * (pixels[pixel * 4 + 1] - 128)) + 128);
-		int B = constrain((factor * (pixels[pixel * 4 + 2] - 128)) + 128);
-		// (Don't modify Alpha value)
-
-		// Adjust brightness and write constrained values back to image
-		pixels[pixel * 4] = constrain(R + (255 * brightness_value));
-		pixels[pixel * 4 + 1] = constrain(G + (255 * brightness_value));
-		pixels[pixel * 4 + 2] = constrain(B + (255 * brightness_value));
+		effect_executor->ApplyToCurrentThread();
+
+		#pragma omp for
+		for (int pixel = 0; pixel < pixel_count; ++pixel)
+		{
+			// Compute contrast adjustment factor
+			float factor = (259 * (contrast_value + 255)) / (255 * (259 - contrast_value));
+
+			// Get RGB pixels from image and apply constrained contrast adjustment
+			int R = constrain((factor * (pixels[pixel * 4] - 128)) + 128);
+			int G = constrain((factor * (pixels[pixel * 4 + 1] - 128)) + 128);
+			int B = constrain((factor * (pixels[pixel * 4 + 2] - 128)) + 128);
+			// (Don't modify Alpha value)
+
+			// Adjust brightness and write constrained values back to image
+			pixels[pixel * 4] = constrain(R + (255 * brightness_value));
+			pixels[pixel * 4 + 1] = constrain(G + (255 * brightness_value));
+			pixels[pixel * 4 + 2] = constrain(B + (255 * brightness_value));
+		}
+
+		// Restore the previous cores and priority of this thread
+		effect_executor->RestoreCurrentThread();
 	}
 
 	// return the modified frame
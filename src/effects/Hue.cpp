@@ -83,18 +83,27 @@ std::shared_ptr<Frame> Hue::GetFrame(std::shared_ptr<Frame> frame, int64_t frame
 	// Loop through pixels
 	unsigned char *pixels = (unsigned char *) frame_image->bits();
 
-	#pragma omp parallel for shared (pixels)
-	for (int pixel = 0; pixel < pixel_count; ++pixel)
+	Executor* effect_executor = GetExecutor();
+	#pragma omp parallel num_threads(effect_executor->ThreadCount()) shared (pixels)
 	{
-		// Get the RGB values from the pixel (ignore the alpha channel)
-		int R = pixels[pixel * 4];
-		int G = pixels[pixel * 4 + 1];
-		int B = pixels[pixel * 4 + 2];
-
-		// Multiply each color by the hue rotation matrix
-		pixels[pixel * 4] = constrain(R * matrix[0] + G * matrix[1] + B * matrix[2]);
-		pixels[pixel * 4 + 1] = constrain(R * matrix[2] + G * matrix[0] + B * matrix[1]);
-		pixels[pixel * 4 + 2] = constrain(R * matrix[1] + G * matrix[2] + B * matrix[0]);
+		effect_executor->ApplyToCurrentThread();
+
+		#pragma omp for
+		for (int pixel = 0; pixel < pixel_count; ++pixel)
+		{
+			// Get the RGB values from the pixel (ignore the alpha channel)
+			int R = pixels[pixel * 4];
+			int G = pixels[pixel * 4 + 1];
+			int B = pixels[pixel * 4 + 2];
+
+			// Multiply each color by the hue rotation matrix
+			pixels[pixel * 4] = constrain(R * matrix[0] + G * matrix[1] + B * matrix[2]);
+			pixels[pixel * 4 + 1] = constrain(R * matrix[2] + G * matrix[0] + B * matrix[1]);
+			pixels[pixel * 4 + 2] = constrain(R * matrix[1] + G * matrix[2] + B * matrix[0]);
+		}
+
+		// Restore the previous cores and priority of this thread
+		effect_executor->RestoreCurrentThread();
 	}
 
 	// return the modified frame
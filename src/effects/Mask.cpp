@@ -72,8 +72,8 @@ std::shared_ptr<Frame> Mask::GetFrame(std::shared_ptr<Frame> frame, int64_t fram
 	std::shared_ptr<QImage> frame_image = frame->GetImage();
 
 	// Check if mask reader is open
-	#pragma omp critical (open_mask_reader)
 	{
+		const GenericScopedLock<CriticalSection> lock(maskCriticalSection);
 		if (reader && !reader->IsOpen())
 			reader->Open();
 	}
@@ -83,8 +83,8 @@ std::shared_ptr<Frame> Mask::GetFrame(std::shared_ptr<Frame> frame, int64_t fram
 		return frame;
 
 	// Get mask image (if missing or different size than frame image)
-	#pragma omp critical (open_mask_reader)
 	{
+		const GenericScopedLock<CriticalSection> lock(maskCriticalSection);
 		if (!original_mask || !reader->info.has_single_image || needs_refresh ||
 			(original_mask && original_mask->size() != frame_image->size())) {
 
@@ -214,8 +214,8 @@ void Mask::SetJsonValue(const Json::Value root) {
 		contrast.SetJsonValue(root["contrast"]);
 	if (!root["reader"].isNull()) // does Json contain a reader?
 	{
-		#pragma omp critical (open_mask_reader)
 		{
+			const GenericScopedLock<CriticalSection> lock(maskCriticalSection);
 			// This reader has changed, so refresh cached assets
 			needs_refresh = true;
 
@@ -57,6 +57,7 @@ namespace openshot
 		ReaderBase *reader;
 		std::shared_ptr<QImage> original_mask;
 		bool needs_refresh;
+		juce::CriticalSection maskCriticalSection; ///< Section lock for opening (and replacing) the mask reader
 
 		/// Init effect settings
 		void init_effect_details();
@@ -86,74 +86,83 @@ std::shared_ptr<Frame> Saturation::GetFrame(std::shared_ptr<Frame> frame, int64_
 	// Loop through pixels
 	unsigned char *pixels = (unsigned char *) frame_image->bits();
 
-	#pragma omp parallel for shared (pixels)
-	for (int pixel = 0; pixel < pixel_count; ++pixel)
+	Executor* effect_executor = GetExecutor();
+	#pragma omp parallel num_threads(effect_executor->ThreadCount()) shared (pixels)
 	{
-		// Get the RGB values from the pixel
-		int R = pixels[pixel * 4];
-		int G = pixels[pixel * 4 + 1];
-		int B = pixels[pixel * 4 + 2];
-
-		/*
-		 * Common saturation adjustment
-		 */
-
-		// Calculate the saturation multiplier
-		double p = sqrt( (R * R * pR) +
-						 (G * G * pG) +
-						 (B * B * pB) );
-
-		// Adjust the saturation
-		R = p + (R - p) * saturation_value;
-		G = p + (G - p) * saturation_value;
-		B = p + (B - p) * saturation_value;
-
-		// Constrain the value from 0 to 255
-		R = constrain(R);
-		G = constrain(G);
-		B = constrain(B);
-
-		/*
-		 * Color-separated saturation adjustment
-		 *
-		 * Splitting each of the three subpixels (R, G and B) into three distincs sub-subpixels (R, G and B in turn)
-		 * which in their optical sum reproduce the original subpixel's color OR produce white light in the brightness
-		 * of the original subpixel (dependening on the color channel's slider value).
-		 */
-
-		// Compute the brightness ("saturation multiplier") of the replaced subpixels
-		// Actually mathematical no-ops mostly, verbosity is kept just for clarification
-		const double p_r = sqrt(R * R * pR);
-		const double p_g = sqrt(G * G * pG);
-		const double p_b = sqrt(B * B * pB);
-
-		// Adjust the saturation
-		const int Rr = p_r + (R - p_r) * saturation_value_R;
-		const int Gr = p_r + (0 - p_r) * saturation_value_R;
-		const int Br = p_r + (0 - p_r) * saturation_value_R;
-
-		const int Rg = p_g + (0 - p_g) * saturation_value_G;
-		const int Gg = p_g + (G - p_g) * saturation_value_G;
-		const int Bg = p_g + (0 - p_g) * saturation_value_G;
-
-		const int Rb = p_b + (0 - p_b) * saturation_value_B;
-		const int Gb = p_b + (0 - p_b) * saturation_value_B;
-		const int Bb = p_b + (B - p_b) * saturation_value_B;
-
-		// Recombine brightness of sub-subpixels (Rx, Gx and Bx) into sub-pixels (R, G and B) again
-		R = Rr + Rg + Rb;
-		G = Gr + Gg + Gb;
-		B = Br + Bg + Bb;
-
-		// Constrain the value from 0 to 255
-		R = constrain(R);
-		G = constrain(G);
-		B = constrain(B);
-
-		// Set all pixels to new value
-		pixels[pixel * 4]     = R;
-		pixels[pixel * 4 + 1] = G;
-		pixels[pixel * 4 + 2] = B;
+		effect_executor->ApplyToCurrentThread();
+
+		#pragma omp for
+		for (int pixel = 0; pixel < pixel_count; ++pixel)
+		{
+			// Get the RGB values from the pixel
+			int R = pixels[pixel * 4];
+			int G = pixels[pixel * 4 + 1];
+			int B = pixels[pixel * 4 + 2];
+
+			/*
+			 * Common saturation adjustment
+			 */
+
+			// Calculate the saturation multiplier
+			double p = sqrt( (R * R * pR) +
+							 (G * G * pG) +
+							 (B * B * pB) );
+
+			// Adjust the saturation
+			R = p + (R - p) * saturation_value;
+			G = p + (G - p) * saturation_value;
+			B = p + (B - p) * saturation_value;
+
+			// Constrain the value from 0 to 255
+			R = constrain(R);
+			G = constrain(G);
+			B = constrain(B);
+
+			/*
+			 * Color-separated saturation adjustment
+			 *
+			 * Splitting each of the three subpixels (R, G and B) into three distincs sub-subpixels (R, G and B in turn)
+			 * which in their optical sum reproduce the original subpixel's color OR produce white light in the brightness
+			 * of the original subpixel (dependening on the color channel's slider value).
+			 */
+
+			// Compute the brightness ("saturation multiplier") of the replaced subpixels
+			// Actually mathematical no-ops mostly, verbosity is kept just for clarification
+			const double p_r = sqrt(R * R * pR);
+			const double p_g = sqrt(G * G * pG);
+			const double p_b = sqrt(B * B * pB);
+
+			// Adjust the saturation
+			const int Rr = p_r + (R - p_r) * saturation_value_R;
+			const int Gr = p_r + (0 - p_r) * saturation_value_R;
+			const int Br = p_r + (0 - p_r) * saturation_value_R;
+
+			const int Rg = p_g + (0 - p_g) * saturation_value_G;
+			const int Gg = p_g + (G - p_g) * saturation_value_G;
+			const int Bg = p_g + (0 - p_g) * saturation_value_G;
+
+			const int Rb = p_b + (0 - p_b) * saturation_value_B;
+			const int Gb = p_b + (0 - p_b) * saturation_value_B;
+			const int Bb = p_b + (B - p_b) * saturation_value_B;
+
+			// Recombine brightness of sub-subpixels (Rx, Gx and Bx) into sub-pixels (R, G and B) again
+			R = Rr + Rg + Rb;
+			G = Gr + Gg + Gb;
+			B = Br + Bg + Bb;
+
+			// Constrain the value from 0 to 255
+			R = constrain(R);
+			G = constrain(G);
+			B = constrain(B);
+
+			// Set all pixels to new value
+			pixels[pixel * 4]     = R;
+			pixels[pixel * 4 + 1] = G;
+			pixels[pixel * 4 + 2] = B;
+		}
+
+		// Restore the previous cores and priority of this thread
+		effect_executor->RestoreCurrentThread();
 	}
 
 	// return the modified frame
@@ -82,26 +82,35 @@ std::shared_ptr<Frame> Wave::GetFrame(std::shared_ptr<Frame> frame, int64_t fram
 	double speed_y_value = speed_y.GetValue(frame_number);
 
 	// Loop through pixels
-	#pragma omp parallel for
-	for (int pixel = 0; pixel < pixel_count; ++pixel)
+	Executor* effect_executor = GetExecutor();
+	#pragma omp parallel num_threads(effect_executor->ThreadCount())
 	{
-		// Calculate pixel Y value
-		int Y = pixel / frame_image->width();
-
-		// Calculate wave pixel offsets
-		float noiseVal = (100 + Y * 0.001) * multiplier_value;  // Time and time multiplier (to make the wave move)
-		float noiseAmp = noiseVal * amplitude_value;  // Apply amplitude / height of the wave
-		float waveformVal = sin((Y * wavelength_value) + (time * speed_y_value));  // Waveform algorithm on y-axis
-		float waveVal = (waveformVal + shift_x_value) * noiseAmp;  // Shifts pixels on the x-axis
-
-		long unsigned int source_px = round(pixel + waveVal);
-		if (source_px < 0)
-			source_px = 0;
-		if (source_px >= pixel_count)
-			source_px = pixel_count - 1;
-
-		// Calculate source array location, and target array location, and copy the 4 color values
-		memcpy(&pixels[pixel * 4], &original_pixels[source_px * 4], sizeof(char) * 4);
+		effect_executor->ApplyToCurrentThread();
+
+		#pragma omp for
+		for (int pixel = 0; pixel < pixel_count; ++pixel)
+		{
+			// Calculate pixel Y value
+			int Y = pixel / frame_image->width();
+
+			// Calculate wave pixel offsets
+			float noiseVal = (100 + Y * 0.001) * multiplier_value;  // Time and time multiplier (to make the wave move)
+			float noiseAmp = noiseVal * amplitude_value;  // Apply amplitude / height of the wave
+			float waveformVal = sin((Y * wavelength_value) + (time * speed_y_value));  // Waveform algorithm on y-axis
+			float waveVal = (waveformVal + shift_x_value) * noiseAmp;  // Shifts pixels on the x-axis
+
+			long unsigned int source_px = round(pixel + waveVal);
+			if (source_px < 0)
+				source_px = 0;
+			if (source_px >= pixel_count)
+				source_px = pixel_count - 1;
+
+			// Calculate source array location, and target array location, and copy the 4 color values
+			memcpy(&pixels[pixel * 4], &original_pixels[source_px * 4], sizeof(char) * 4);
+		}
+
+		// Restore the previous cores and priority of this thread
+		effect_executor->RestoreCurrentThread();
 	}
 
 	// return the modified frame
@@ -463,3 +463,72 @@ TEST(CacheMemory_JSON)
 	CHECK_EQUAL("5", c.JsonValue()["version"].asString());
 
 }
+
+TEST(RenderCache_Fingerprint)
+{
+	// Create a small timeline
+	Timeline t(64, 36, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	t.Open();
+
+	// Render a range of frames to disk
+	std::string path = QDir::tempPath().toStdString() + "/render-cache-test/";
+	RenderCache r(&t, path);
+	r.Clear();
+	t.SetRenderCache(&r);
+	CHECK_EQUAL(true, r.Render(1, 5));
+	CHECK_EQUAL(true, r.IsRendered(1, 5));
+	CHECK_EQUAL(false, r.IsRendered(1, 6));
+	CHECK(r.GetFrame(3) != nullptr);
+	CHECK_EQUAL(3, r.GetFrame(3)->number);
+
+	// Rendered ranges are found again by a new instance
+	RenderCache r2(&t, path);
+	CHECK_EQUAL(true, r2.IsRendered(1, 5));
+
+	// Changing the timeline directly (and then clearing its cache) invalidates the rendered range
+	t.color.red.AddPoint(1, 255);
+	t.ClearAllCache();
+	CHECK_EQUAL(false, r.IsRendered(1, 5));
+	CHECK(r.GetFrame(3) == nullptr);
+	CHECK_EQUAL(false, r2.IsRendered(1, 5));
+
+	t.SetRenderCache(NULL);
+	r.Clear();
+	t.Close();
+}
+
+TEST(RenderCache_AddHeavyRanges)
+{
+	// Create a timeline with 2 overlapping clips (frames 1 to 61), and a 3rd clip which lasts longer
+	Timeline t(64, 36, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	stringstream path;
+	path << TEST_MEDIA_PATH << "front3.png";
+	Clip c1(path.str());
+	c1.End(2.0);
+	Clip c2(path.str());
+	c2.End(2.0);
+	Clip c3(path.str());
+	c3.End(4.0);
+	t.AddClip(&c1);
+	t.AddClip(&c2);
+	t.AddClip(&c3);
+	t.Open();
+
+	std::string cache_path = QDir::tempPath().toStdString() + "/render-cache-heavy-test/";
+	RenderCache r(&t, cache_path);
+	r.Clear();
+
+	// The heavy section is followed by a lighter section
+	CHECK_EQUAL(1, r.AddHeavyRanges(3));
+
+	// The heavy section lasts until the end of the timeline
+	CHECK_EQUAL(1, r.AddHeavyRanges(1));
+
+	// Nothing is heavy enough
+	CHECK_EQUAL(0, r.AddHeavyRanges(4));
+
+	// Stop rendering the queued ranges (before closing the timeline)
+	r.Stop();
+	r.Clear();
+	t.Close();
+}
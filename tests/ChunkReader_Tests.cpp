@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @brief Unit tests for openshot::ChunkReader
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UnitTest++.h"
+// Prevent name clashes with juce::UnitTest
+#define DONT_SET_USING_JUCE_NAMESPACE 1
+#include "OpenShot.h"
+
+using namespace std;
+using namespace openshot;
+
+SUITE(ChunkReader_Tests)
+{
+
+TEST(Mezzanine_Round_Trip)
+{
+	// Create a reader with a different color and audio level on each frame
+	CacheMemory cache;
+	for (int64_t number = 1; number <= 100; number++) {
+		std::shared_ptr<Frame> f(new Frame(number, 128, 72, "#000000", 1470, 2));
+		f->AddColor(128, 72, QColor(number, 0, 0).name().toStdString());
+		std::vector<float> samples(1470, number / 200.0);
+		f->AddAudio(true, 0, 0, samples.data(), 1470, 1.0);
+		f->AddAudio(true, 1, 0, samples.data(), 1470, 1.0);
+		cache.Add(f);
+	}
+	DummyReader r(Fraction(30, 1), 128, 72, 44100, 2, 100 / 30.0, &cache);
+
+	// Write the chunks (with a MEZZANINE version)
+	std::string path = QDir::tempPath().toStdString() + "/chunk-mezzanine-test/";
+	QDir(QString::fromStdString(path)).removeRecursively();
+	ChunkWriter w(path, &r);
+	w.SetMezzanine(true);
+	w.Open();
+	w.WriteFrame(&r, 1, 100);
+	w.Close();
+
+	// Reopen the chunks, and seek forward and back (across chunks)
+	ChunkReader c(path, MEZZANINE);
+	c.Open();
+	for (int64_t number : {5, 6, 80, 72, 73, 2, 100}) {
+		std::shared_ptr<Frame> f = c.GetFrame(number);
+		CHECK_EQUAL(number, f->number);
+		CHECK_EQUAL(128, f->GetWidth());
+		CHECK_EQUAL(72, f->GetHeight());
+		CHECK_EQUAL(number, f->GetImage()->pixelColor(10, 10).red());
+		CHECK_EQUAL(1470, f->GetAudioSamplesCount());
+		CHECK_CLOSE(number / 200.0, f->GetAudioSample(1, 100, 1.0), 0.0001);
+	}
+	c.Close();
+
+	QDir(QString::fromStdString(path)).removeRecursively();
+}
+
+} // SUITE
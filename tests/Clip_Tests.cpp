@@ -183,6 +183,61 @@ TEST(Properties)
 	delete reader;
 }
 
+TEST(Properties_Snapshot)
+{
+	// Create a empty clip
+	Clip c1;
+	c1.Position(5.0);
+	c1.alpha.AddPoint(1, 1.0);
+	c1.alpha.AddPoint(500, 0.0);
+	c1.has_audio.AddPoint(250, 0.0, CONSTANT);
+
+	// The snapshot matches the full properties (at every frame)
+	for (int64_t frame = 1; frame < 500; frame += 99)
+		CHECK_EQUAL(true, openshot::stringToJson(c1.PropertiesJSON(frame)) == openshot::stringToJson(c1.PropertiesSnapshotJSON(frame)));
+
+	// Changing a property clears the cached properties
+	c1.Position(8.0);
+	CHECK_CLOSE(8.0, openshot::stringToJson(c1.PropertiesSnapshotJSON(1))["position"]["value"].asDouble(), 0.0001);
+
+	// Get a range of keyframe values
+	Json::Value values = openshot::stringToJson(c1.PropertiesValuesJSON(1, 500));
+	CHECK_EQUAL(500, (int)values["alpha"].size());
+	CHECK_CLOSE(1.0, values["alpha"][0].asDouble(), 0.0001);
+	CHECK_CLOSE(0.0, values["alpha"][499].asDouble(), 0.0001);
+	CHECK_EQUAL(false, values.isMember("position"));
+}
+
+TEST(Bake_Frame_Values)
+{
+	// Load an image clip (every frame has the same source image)
+	std::stringstream path;
+	path << TEST_MEDIA_PATH << "front.png";
+	Clip c1(path.str());
+	c1.alpha.AddPoint(1, 1.0);
+	c1.alpha.AddPoint(50, 0.0);
+
+	// Precompute frames 1 to 100
+	c1.Bake(1, 100);
+	for (int64_t frame = 1; frame <= 100; frame += 7) {
+		CHECK_CLOSE(c1.alpha.GetValue(frame), c1.GetFrameValues(frame).alpha, 0.0001);
+		CHECK_CLOSE(c1.scale_x.GetValue(frame), c1.GetFrameValues(frame).scale_x, 0.0001);
+	}
+
+	// Frames after the alpha animation are identical
+	CHECK_EQUAL(20, c1.GetIdenticalFrame(20));
+	CHECK_EQUAL(50, c1.GetIdenticalFrame(50));
+	CHECK_EQUAL(50, c1.GetIdenticalFrame(100));
+
+	// Outside of the baked range
+	CHECK_EQUAL(200, c1.GetIdenticalFrame(200));
+
+	// Changing the clip clears the precomputed values
+	Negate n;
+	c1.AddEffect(&n);
+	CHECK_EQUAL(100, c1.GetIdenticalFrame(100));
+}
+
 TEST(Effects)
 {
 	// Load clip with video
@@ -254,5 +309,37 @@ TEST(Verify_Parent_Timeline)
 	CHECK_EQUAL(c1.GetFrame(1)->GetImage()->height(), 480);
 }
 
+TEST(GetFrames)
+{
+	// Load clip with video
+	std::stringstream path;
+	path << TEST_MEDIA_PATH << "sintel_trailer-720p.mp4";
+	FFmpegReader r(path.str());
+	Clip c1(&r);
+	c1.Open();
+
+	// Get a range of frames (which are requested from the reader as a single range)
+	std::vector<std::shared_ptr<Frame>> frames = c1.GetFrames(20, 10);
+	CHECK_EQUAL(10, (int)frames.size());
+	CHECK_EQUAL(20, frames.front()->number);
+	CHECK_EQUAL(29, frames.back()->number);
+	CHECK(r.GetCache()->GetFrame(29) != nullptr);
+
+	// The frames match the frames of a second reader, decoded one at a time
+	FFmpegReader r2(path.str());
+	Clip c2(&r2);
+	c2.Open();
+	for (int index = 0; index < 10; index++) {
+		std::shared_ptr<Frame> expected = c2.GetFrame(20 + index);
+		CHECK_EQUAL(expected->number, frames[index]->number);
+		CHECK_EQUAL(expected->GetImage()->width(), frames[index]->GetImage()->width());
+		CHECK_EQUAL(expected->GetImage()->height(), frames[index]->GetImage()->height());
+		CHECK(*expected->GetImage() == *frames[index]->GetImage());
+	}
+
+	c2.Close();
+	c1.Close();
+}
+
 } // SUITE
 
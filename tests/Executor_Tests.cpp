@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @brief Unit tests for openshot::Executor
+ * @author Jonathan Thomas <jonathan@openshot.org>
+ *
+ * @ref License
+ */
+
+/* LICENSE
+ *
+ * Copyright (c) 2008-2019 OpenShot Studios, LLC
+ * <http://www.openshotstudios.com/>. This file is part of
+ * OpenShot Library (libopenshot), an open-source project dedicated to
+ * delivering high quality video editing and animation solutions to the
+ * world. For more information visit <http://www.openshot.org/>.
+ *
+ * OpenShot Library (libopenshot) is free software: you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * OpenShot Library (libopenshot) is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with OpenShot Library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UnitTest++.h"
+// Prevent name clashes with juce::UnitTest
+#define DONT_SET_USING_JUCE_NAMESPACE 1
+#include "OpenShot.h"
+
+#include <omp.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace openshot;
+
+SUITE(Executor_Tests)
+{
+
+TEST(Thread_Count)
+{
+	// Explicit thread count
+	Executor e1(3);
+	CHECK_EQUAL(3, e1.ThreadCount());
+
+	// Default thread count (from Settings)
+	Executor e2;
+	CHECK(e2.ThreadCount() >= 1);
+	CHECK(Executor::Default()->ThreadCount() >= 1);
+}
+
+TEST(Numa_Node_Assignment)
+{
+	// Contiguous groups of threads on each node
+	for (int thread = 0; thread < 4; thread++)
+		CHECK_EQUAL(0, Executor::NumaNodeOfThread(thread, 8, 2));
+	for (int thread = 4; thread < 8; thread++)
+		CHECK_EQUAL(1, Executor::NumaNodeOfThread(thread, 8, 2));
+
+	// Uneven teams, and more nodes than threads
+	CHECK_EQUAL(0, Executor::NumaNodeOfThread(0, 3, 2));
+	CHECK_EQUAL(1, Executor::NumaNodeOfThread(2, 3, 2));
+	CHECK_EQUAL(0, Executor::NumaNodeOfThread(0, 2, 4));
+	CHECK_EQUAL(2, Executor::NumaNodeOfThread(1, 2, 4));
+
+	// Single node (or invalid values)
+	CHECK_EQUAL(0, Executor::NumaNodeOfThread(5, 8, 1));
+	CHECK_EQUAL(0, Executor::NumaNodeOfThread(5, 8, 0));
+	CHECK_EQUAL(0, Executor::NumaNodeOfThread(-1, 0, 2));
+
+	// The topology is shared (and always has at least one node)
+	CHECK(Executor::NumaNodes().size() >= 1);
+	CHECK_EQUAL(&Executor::NumaNodes(), &Executor::NumaNodes());
+}
+
+#ifdef __linux__
+TEST(Caller_Thread_Unchanged)
+{
+	// Original cores and priority of this thread
+	cpu_set_t original_cores;
+	CHECK_EQUAL(0, sched_getaffinity(0, sizeof(cpu_set_t), &original_cores));
+	int original_priority = getpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid));
+
+	// Apply an executor outside (and inside) a parallel section
+	Executor e1(2, {0}, original_priority + 1);
+	e1.ApplyToCurrentThread();
+	e1.RestoreCurrentThread();
+	int worker_priority = original_priority;
+	int number_of_threads = 1;
+	bool worker_cores_restored = true;
+	#pragma omp parallel num_threads(2)
+	{
+		cpu_set_t worker_cores;
+		sched_getaffinity(0, sizeof(cpu_set_t), &worker_cores);
+
+		e1.ApplyToCurrentThread();
+		if (omp_get_thread_num() != 0) {
+			worker_priority = getpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid));
+			number_of_threads = omp_get_num_threads();
+		}
+		e1.RestoreCurrentThread();
+
+		// The worker thread gets its original cores back (at the end of the section)
+		cpu_set_t restored_cores;
+		sched_getaffinity(0, sizeof(cpu_set_t), &restored_cores);
+		if (!CPU_EQUAL(&worker_cores, &restored_cores))
+			worker_cores_restored = false;
+	}
+
+	// The calling thread is never changed
+	cpu_set_t cores;
+	CHECK_EQUAL(0, sched_getaffinity(0, sizeof(cpu_set_t), &cores));
+	CHECK(CPU_EQUAL(&original_cores, &cores));
+	CHECK_EQUAL(original_priority, getpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid)));
+
+	// The worker thread is changed (raising the nice value is always allowed)
+	if (number_of_threads == 2)
+		CHECK_EQUAL(original_priority + 1, worker_priority);
+	CHECK(worker_cores_restored);
+}
+#endif
+
+} // SUITE(Executor_Tests)
@@ -241,6 +241,133 @@ TEST(Multiple_Open_and_Close)
 	r.Close();
 }
 
+TEST(GetFrames_Range)
+{
+	// Create a reader
+	stringstream path;
+	path << TEST_MEDIA_PATH << "sintel_trailer-720p.mp4";
+	FFmpegReader r(path.str());
+	r.Open();
+
+	// Get a range of frames (which requires a seek)
+	std::vector<std::shared_ptr<Frame>> frames = r.GetFrames(300, 20);
+	CHECK_EQUAL(20, frames.size());
+	for (int index = 0; index < 20; index++)
+		CHECK_EQUAL(300 + index, frames[index]->number);
+
+	// Verify the frames match the single frame method
+	std::shared_ptr<Frame> f = r.GetFrame(310);
+	CHECK_EQUAL(f->GetPixels(360)[400], frames[10]->GetPixels(360)[400]);
+
+	// Empty range
+	CHECK_EQUAL(0, r.GetFrames(1, 0).size());
+
+	// Close reader
+	r.Close();
+}
+
+TEST(Max_Size_Settings)
+{
+	stringstream path;
+	path << TEST_MEDIA_PATH << "sintel_trailer-720p.mp4";
+
+	// A reader without its own settings decodes the full size
+	FFmpegReader r(path.str());
+	r.Open();
+	CHECK_EQUAL(1280, r.GetFrame(1)->GetImage()->width());
+	r.Close();
+
+	// The max size of the reader's own settings limits it
+	Settings *s = Settings::Create();
+	s->MAX_WIDTH = 320;
+	s->MAX_HEIGHT = 180;
+	FFmpegReader r2(path.str());
+	r2.SetSettings(s);
+	r2.Open();
+	CHECK_EQUAL(320, r2.GetFrame(1)->GetImage()->width());
+	CHECK_EQUAL(180, r2.GetFrame(1)->GetImage()->height());
+	r2.Close();
+	r2.SetSettings(NULL);
+	delete s;
+}
+
+TEST(Decode_Modes)
+{
+	// Create a reader (with its own settings)
+	stringstream path;
+	path << TEST_MEDIA_PATH << "sintel_trailer-720p.mp4";
+	FFmpegReader r(path.str());
+	Settings *s = Settings::Create();
+	r.SetSettings(s);
+	r.Open();
+
+	// Fast decoding
+	s->DECODE_MODE = DECODE_FAST;
+	std::shared_ptr<Frame> f = r.GetFrame(1);
+	CHECK_EQUAL(1, f->number);
+	CHECK_EQUAL(1280, f->GetImage()->width());
+	CHECK_EQUAL(720, f->GetImage()->height());
+
+	// Skipped frames still return an image (repeating the previous decoded frame)
+	s->DECODE_MODE = DECODE_REFERENCE_ONLY;
+	f = r.GetFrame(300);
+	CHECK_EQUAL(300, f->number);
+	CHECK_EQUAL(1280, f->GetImage()->width());
+
+	s->DECODE_MODE = DECODE_KEYFRAMES_ONLY;
+	f = r.GetFrame(600);
+	CHECK_EQUAL(600, f->number);
+	CHECK_EQUAL(1280, f->GetImage()->width());
+
+	// Back to full quality
+	s->DECODE_MODE = DECODE_FULL;
+	f = r.GetFrame(900);
+	CHECK_EQUAL(900, f->number);
+	CHECK_EQUAL(1280, f->GetImage()->width());
+
+	// Close reader
+	r.Close();
+	r.SetSettings(NULL);
+	delete s;
+}
+
+TEST(Thumbnail_Extractor)
+{
+	// Create a reader
+	stringstream path;
+	path << TEST_MEDIA_PATH << "sintel_trailer-720p.mp4";
+	FFmpegReader r(path.str());
+	r.Open();
+
+	// Keyframes are listed in the index of the container
+	std::vector<int64_t> keyframes = r.GetKeyframes();
+	CHECK(keyframes.size() > 1);
+	CHECK_EQUAL(1, keyframes.front());
+
+	// Evenly spaced positions
+	ThumbnailExtractor extractor(&r, 160, 90);
+	std::vector<int64_t> positions = extractor.Positions(4);
+	CHECK_EQUAL(4, positions.size());
+	for (size_t index = 1; index < positions.size(); index++)
+		CHECK(positions[index - 1] < positions[index]);
+
+	// Keyframe aligned positions
+	std::vector<int64_t> aligned = extractor.Positions(4, true);
+	for (int64_t position : aligned)
+		CHECK(std::find(keyframes.begin(), keyframes.end(), position) != keyframes.end());
+
+	// Filmstrip of thumbnails (side by side)
+	std::shared_ptr<QImage> filmstrip = extractor.Filmstrip(4, true);
+	CHECK_EQUAL(160 * aligned.size(), filmstrip->width());
+	CHECK_EQUAL(90, filmstrip->height());
+
+	// The original reader is unchanged
+	CHECK_EQUAL(1280, r.GetFrame(1)->GetImage()->width());
+
+	// Close reader
+	r.Close();
+}
+
 TEST(Verify_Parent_Timeline)
 {
 	// Create a reader
@@ -125,4 +125,55 @@ TEST(Options_Overloads)
 	CHECK_EQUAL(true, r1.info.top_field_first);
 }
 
+TEST(Streaming_Timeline)
+{
+	// Timeline with a clip (mapped to the timeline by a FrameMapper), and a reversed clip
+	stringstream path;
+	path << TEST_MEDIA_PATH << "sintel_trailer-720p.mp4";
+	FFmpegReader r(path.str());
+	Clip c1(&r);
+	c1.End(4.0);
+	Clip c2(path.str());
+	c2.Layer(1);
+	c2.time.AddPoint(1, 96);
+	c2.time.AddPoint(96, 1);
+
+	Timeline t(320, 180, Fraction(24, 1), 44100, 2, LAYOUT_STEREO);
+	Executor executor(1);
+	t.SetExecutor(&executor);
+	t.AddClip(&c1);
+	t.AddClip(&c2);
+	c1.GetCache()->SetMaxBytes(0);
+	c2.GetCache()->SetMaxBytes(0);
+	t.Open();
+	CHECK_EQUAL("FrameMapper", c1.Reader()->Name());
+	FrameMapper* mapper = (FrameMapper*) c1.Reader();
+
+	/* WRITER ---------------- */
+	FFmpegWriter w("output-streaming.webm");
+	w.SetAudioOptions(true, "libvorbis", 44100, 2, LAYOUT_STEREO, 188000);
+	w.SetVideoOptions(true, "libvpx", Fraction(24,1), 320, 180, Fraction(1,1), false, false, 3000000);
+	w.Open();
+
+	// Write the frames (which streams the timeline and the readers of its clips)
+	w.WriteFrame(&t, 1, 72);
+	w.Close();
+
+	// The previous mode is restored
+	CHECK_EQUAL(false, t.GetStreaming());
+	CHECK_EQUAL(false, mapper->GetStreaming());
+	CHECK_EQUAL(false, r.GetStreaming());
+
+	// Early frames are dropped from the caches of the clip, its FrameMapper and its FFmpegReader
+	CHECK(c1.GetCache()->GetFrame(1) == nullptr);
+	CHECK(mapper->GetCache()->GetFrame(1) == nullptr);
+	CHECK(r.GetCache()->GetFrame(1) == nullptr);
+	CHECK(c1.GetCache()->GetFrame(72) != nullptr);
+
+	// The reversed clip keeps all of its frames
+	CHECK(c2.GetCache()->GetFrame(1) != nullptr);
+
+	t.Close();
+}
+
 } // SUITE()
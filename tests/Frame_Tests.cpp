@@ -147,4 +147,105 @@ TEST(Copy_Constructor)
 	CHECK_EQUAL(f1.GetAudioSamplesCount(), f2.GetAudioSamplesCount());
 }
 
+TEST(AddImage_Shared_Parallel)
+{
+	// A shared image (i.e. a reader's cached image), in a format which needs converting
+	auto shared_image = std::make_shared<QImage>(64, 36, QImage::Format_ARGB32);
+	shared_image->fill(QColor(255, 0, 0, 128));
+
+	// Add the same image to many frames at once
+	std::vector<std::shared_ptr<Frame>> frames(16);
+	#pragma omp parallel for
+	for (int index = 0; index < 16; index++) {
+		frames[index] = std::make_shared<Frame>(index + 1, 64, 36, "#000000");
+		frames[index]->AddColor(64, 36, "#00ff00");
+		frames[index]->AddImage(shared_image);
+	}
+
+	// The shared image is not modified, and each frame has a converted image
+	CHECK_EQUAL(QImage::Format_ARGB32, shared_image->format());
+	for (auto frame : frames) {
+		CHECK_EQUAL(QImage::Format_RGBA8888_Premultiplied, frame->GetImage()->format());
+		CHECK_EQUAL(64, frame->GetWidth());
+		CHECK(frame->CheckPixel(0, 0, 128, 0, 0, 128, 1));
+	}
+}
+
+TEST(AddColor_Lazy)
+{
+	// Create a solid color frame
+	Frame f1(1, 1280, 720, "#ff0000", 0, 2);
+
+	// No pixels are allocated until they are needed
+	CHECK_EQUAL(true, f1.IsSolidColor());
+	CHECK_EQUAL("#ff0000", f1.SolidColor());
+	CHECK_EQUAL(1280, f1.GetWidth());
+	CHECK_EQUAL(720, f1.GetHeight());
+	CHECK(f1.GetBytes() < 1280 * 720 * 4);
+
+	// Getting the image draws the solid color
+	std::shared_ptr<QImage> image = f1.GetImage();
+	CHECK_EQUAL(false, f1.IsSolidColor());
+	CHECK_EQUAL(1280, image->width());
+	CHECK_EQUAL(720, image->height());
+	CHECK(f1.CheckPixel(0, 0, 255, 0, 0, 255, 0));
+	CHECK_EQUAL(QColor(255, 0, 0).rgba(), image->pixelColor(1279, 719).rgba());
+	CHECK(f1.GetBytes() >= 1280 * 720 * 4);
+}
+
+TEST(ConvertImage_Formats)
+{
+	// Create a large image with semi-transparent pixels (converted in parallel stripes)
+	QImage source(600, 400, QImage::Format_ARGB32);
+	for (int row = 0; row < source.height(); row++)
+		for (int col = 0; col < source.width(); col++)
+			source.setPixel(col, row, qRgba(col % 256, row % 256, (col + row) % 256, (col * 3 + row) % 256));
+
+	// Compare the pixels of two images (allowing rounding differences)
+	auto same_pixels = [](const QImage &a, const QImage &b) {
+		if (a.size() != b.size())
+			return false;
+		for (int row = 0; row < a.height(); row++) {
+			const unsigned char *a_row = a.constScanLine(row);
+			const unsigned char *b_row = b.constScanLine(row);
+			for (int byte = 0; byte < a.width() * 4; byte++)
+				if (abs(a_row[byte] - b_row[byte]) > 1)
+					return false;
+		}
+		return true;
+	};
+
+	// Each converted format matches the conversion of Qt
+	QImage::Format formats[] = {QImage::Format_ARGB32, QImage::Format_ARGB32_Premultiplied, QImage::Format_RGB32,
+	                            QImage::Format_RGBA8888, QImage::Format_RGB888, QImage::Format_Grayscale8};
+	for (QImage::Format format : formats) {
+		// (copied, since converting to the same format shares the pixels of the source)
+		QImage image = source.convertToFormat(format).copy();
+		QImage expected = image.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+
+		QImage converted = Frame::ConvertImage(image);
+		CHECK_EQUAL(QImage::Format_RGBA8888_Premultiplied, converted.format());
+		CHECK(same_pixels(converted, expected));
+
+		// The same result in place (and the pixels are not copied for 4 byte formats)
+		const unsigned char *pixels = image.constBits();
+		Frame::ConvertImageInPlace(image);
+		CHECK_EQUAL(QImage::Format_RGBA8888_Premultiplied, image.format());
+		CHECK(same_pixels(image, expected));
+		if (format != QImage::Format_RGB888 && format != QImage::Format_Grayscale8)
+			CHECK(pixels == image.constBits());
+	}
+
+	// Images converted inside a parallel section (i.e. by the threads of a Timeline)
+	QImage expected = source.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+	bool all_same = true;
+	#pragma omp parallel num_threads(2)
+	{
+		QImage converted = Frame::ConvertImage(source);
+		#pragma omp critical (ConvertImage_Formats)
+		all_same = all_same && same_pixels(converted, expected);
+	}
+	CHECK(all_same);
+}
+
 } // SUITE(Frame_Tests)
@@ -494,3 +494,23 @@ TEST(Keyframe_Handle_Large_Segment)
 	Fraction fr = kf.GetRepeatFraction(250000);
 	CHECK_CLOSE(0.5, (double)fr.num / fr.den, 0.01);
 }
+
+TEST(Keyframe_Binary)
+{
+	Keyframe kf;
+	kf.AddPoint(1, 0.5, CONSTANT);
+	kf.AddPoint(100, 0.1, BEZIER);
+	kf.AddPoint(300, -2000, LINEAR);
+
+	// The binary string is smaller than JSON, and loads the same keyframe
+	std::string binary = kf.Binary();
+	CHECK(binary.size() < kf.Json().size());
+
+	Keyframe kf2;
+	kf2.SetBinary(binary);
+	CHECK_EQUAL(kf.Json(), kf2.Json());
+	CHECK_CLOSE(kf.GetValue(50), kf2.GetValue(50), 0.0001);
+
+	// Invalid binary strings throw an exception
+	CHECK_THROW(kf2.SetBinary(binary.substr(0, binary.size() - 1)), InvalidJSON);
+}
@@ -31,6 +31,9 @@
 #include "UnitTest++.h"
 // Prevent name clashes with juce::UnitTest
 #define DONT_SET_USING_JUCE_NAMESPACE 1
+
+#include <algorithm>
+#include <future>
 #include "OpenShot.h"
 
 using namespace std;
@@ -86,3 +89,93 @@ TEST(ReaderBase_Derived_Class)
 	CHECK_EQUAL(1, t1.info.fps.num);
 	CHECK_EQUAL(1, t1.info.fps.den);
 }
+
+TEST(ReaderBase_RequestFrame)
+{
+	// Create a new derived class from type ReaderBase
+	class TestReader : public ReaderBase
+	{
+	public:
+		TestReader() { };
+		CacheBase* GetCache() { return NULL; };
+		std::shared_ptr<Frame> GetFrame(int64_t number) {
+			if (number < 1)
+				throw OutOfBoundsFrame("Invalid frame", number, 10);
+			return std::make_shared<Frame>(number, 10, 10, "#000000");
+		}
+		void Close() { };
+		void Open() { };
+		string Json() const { return ""; };
+		void SetJson(string value) { };
+		Json::Value JsonValue() const { return Json::Value("{}"); };
+		void SetJsonValue(Json::Value root) { };
+		bool IsOpen() { return true; };
+		string Name() { return "TestReader"; };
+	};
+	TestReader t1;
+
+	// Request many frames at once (which can complete in any order)
+	std::vector<std::future<std::shared_ptr<Frame>>> requests;
+	for (int64_t number = 1; number <= 10; number++)
+		requests.push_back(t1.RequestFrame(number));
+	for (int64_t number = 1; number <= 10; number++)
+		CHECK_EQUAL(number, requests[number - 1].get()->number);
+
+	// Exceptions are passed through the future
+	CHECK_THROW(t1.RequestFrame(0).get(), OutOfBoundsFrame);
+
+	// Request with a callback
+	std::promise<int64_t> callback_number;
+	t1.RequestFrame(5, [&callback_number](std::shared_ptr<Frame> f) { callback_number.set_value(f ? f->number : 0); });
+	CHECK_EQUAL(5, callback_number.get_future().get());
+}
+
+TEST(ReaderBase_CancelRequests)
+{
+	// Create a derived reader, which blocks in GetFrame until released
+	class BlockingReader : public ReaderBase
+	{
+	public:
+		std::shared_future<void> gate;
+		BlockingReader(std::shared_future<void> gate) : gate(gate) { };
+		~BlockingReader() { wait_for_requests(); };
+		CacheBase* GetCache() { return NULL; };
+		std::shared_ptr<Frame> GetFrame(int64_t number) {
+			gate.wait();
+			return std::make_shared<Frame>(number, 10, 10, "#000000");
+		}
+		void Close() { CancelRequests(); };
+		void Open() { };
+		string Json() const { return ""; };
+		void SetJson(string value) { };
+		Json::Value JsonValue() const { return Json::Value("{}"); };
+		void SetJsonValue(Json::Value root) { };
+		bool IsOpen() { return true; };
+		string Name() { return "BlockingReader"; };
+	};
+	std::promise<void> release;
+	BlockingReader r1(release.get_future().share());
+
+	// Request more frames than there are worker threads (so some are still waiting)
+	int number_of_requests = std::max(1, Settings::Instance()->FRAME_REQUEST_THREADS) + 5;
+	std::vector<std::future<std::shared_ptr<Frame>>> requests;
+	for (int64_t number = 1; number <= number_of_requests; number++)
+		requests.push_back(r1.RequestFrame(number));
+
+	// Closing the reader drops the waiting requests
+	r1.Close();
+	release.set_value();
+
+	int completed = 0;
+	int dropped = 0;
+	for (auto& request : requests) {
+		try {
+			if (request.get())
+				completed++;
+		} catch (const std::future_error& e) {
+			dropped++;
+		}
+	}
+	CHECK(dropped >= 5);
+	CHECK_EQUAL(number_of_requests, completed + dropped);
+}
@@ -62,3 +62,22 @@ TEST(Settings_Change_Settings)
 	CHECK_EQUAL(true, Settings::Instance()->HIGH_QUALITY_SCALING);
 	CHECK_EQUAL(true, Settings::Instance()->WAIT_FOR_VIDEO_PROCESSING_TASK);
 }
+
+TEST(Settings_Create_Copy)
+{
+	// Create a copy of the global settings
+	Settings *s = Settings::Create();
+	CHECK_EQUAL(Settings::Instance()->OMP_THREADS, s->OMP_THREADS);
+
+	// Changing the copy does not change the global settings
+	s->HIGH_QUALITY_SCALING = !Settings::Instance()->HIGH_QUALITY_SCALING;
+	CHECK(s->HIGH_QUALITY_SCALING != Settings::Instance()->HIGH_QUALITY_SCALING);
+
+	// Assign the copy to a reader
+	DummyReader r(Fraction(30, 1), 320, 240, 44100, 2, 30.0);
+	CHECK(r.GetSettings() == Settings::Instance());
+	r.SetSettings(s);
+	CHECK(r.GetSettings() == s);
+
+	delete s;
+}
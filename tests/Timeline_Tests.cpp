@@ -607,4 +607,203 @@ TEST(GetMaxFrame_GetMaxTime)
 	CHECK_CLOSE(125.0, t.GetMaxTime(), 0.001);
 }
 
+TEST(SetJson_Lazy_Clips)
+{
+	// Create a timeline with a keyframed clip and effect
+	Timeline t(640, 480, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+
+	stringstream path1;
+	path1 << TEST_MEDIA_PATH << "interlaced.png";
+	Clip clip1(path1.str());
+	clip1.Id("CLIP00001");
+	clip1.Layer(1);
+	clip1.Position(5);
+	clip1.alpha.AddPoint(100, 0.5);
+	Negate effect1;
+	effect1.Id("EFFECT00001");
+	clip1.AddEffect(&effect1);
+	t.AddClip(&clip1);
+	std::string project = t.Json();
+
+	// Load the project lazily into a new timeline (with its own settings, which outlive the timeline)
+	std::unique_ptr<Settings> s(Settings::Create());
+	s->LAZY_LOAD_CLIPS = true;
+	Timeline t2(640, 480, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	t2.SetSettings(s.get());
+	t2.SetJson(project);
+
+	// Clip metadata is loaded, but keyframes are not (yet)
+	Clip* matched = t2.GetClip("CLIP00001");
+	CHECK(matched != nullptr);
+	CHECK_EQUAL(1, matched->Layer());
+	CHECK_CLOSE(5.0, matched->Position(), 0.001);
+	CHECK_EQUAL(1, matched->alpha.GetCount());
+
+	// Keyframes and effects are loaded when needed
+	CHECK(matched->GetEffect("EFFECT00001") != nullptr);
+	CHECK_EQUAL(2, matched->alpha.GetCount());
+	CHECK_CLOSE(0.5, matched->alpha.GetValue(100), 0.0001);
+	CHECK_EQUAL(clip1.Json(), matched->Json());
+}
+
+TEST(Nested_Timeline_Preview_Size)
+{
+	// Create a timeline and a nested timeline (used as the reader of a clip)
+	Timeline t(1280, 720, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	Timeline nested(1280, 720, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	Clip clip1(&nested);
+	t.AddClip(&clip1);
+	t.SetMaxSize(640, 360);
+	t.Open();
+
+	// The nested timeline renders at the size of the parent preview
+	std::shared_ptr<Frame> f = t.GetFrame(1);
+	CHECK_EQUAL(640, nested.preview_width);
+	CHECK_EQUAL(360, nested.preview_height);
+	CHECK(nested.GetCache()->GetFrame(1) != nullptr);
+
+	// Edits to the parent timeline keep the nested output cached
+	t.ClearAllCache();
+	CHECK(nested.GetCache()->GetFrame(1) != nullptr);
+
+	// Scaling the clip up renders the nested timeline at a larger size
+	clip1.scale_x.AddPoint(1, 2.0);
+	clip1.scale_y.AddPoint(1, 2.0);
+	t.ClearAllCache();
+	f = t.GetFrame(1);
+	CHECK_EQUAL(1280, nested.preview_width);
+	CHECK_EQUAL(720, nested.preview_height);
+
+	t.Close();
+}
+
+TEST(Seek_Keeps_Cache)
+{
+	// Create a timeline with a clip
+	Timeline t(640, 480, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	stringstream path;
+	path << TEST_MEDIA_PATH << "front3.png";
+	Clip clip1(path.str());
+	t.AddClip(&clip1);
+	t.GetCache()->SetMaxBytes(0);
+	t.Open();
+
+	// Render a few frames, and then seek somewhere else
+	t.GetFrame(1);
+	t.GetFrame(2);
+	t.GetFrame(60);
+
+	// Frames before the seek are still cached
+	CHECK(t.GetCache()->GetFrame(1) != nullptr);
+	CHECK(t.GetCache()->GetFrame(2) != nullptr);
+	CHECK(t.GetCache()->GetFrame(60) != nullptr);
+
+	// Seeking back uses the cached frame
+	std::shared_ptr<Frame> f = t.GetCache()->GetFrame(1);
+	CHECK_EQUAL(f.get(), t.GetFrame(1).get());
+
+	t.Close();
+}
+
+TEST(Seek_Audio_Samples)
+{
+	// Create 2 timelines with the same clip (resampled from 48000 Hz by a FrameMapper, and slowed
+	// down by a time curve, which resamples the audio of the clip)
+	stringstream path;
+	path << TEST_MEDIA_PATH << "sintel_trailer-720p.mp4";
+	Clip clip1(path.str());
+	clip1.time.AddPoint(1, 1);
+	clip1.time.AddPoint(1200, 600);
+	Clip clip2(path.str());
+	clip2.time.AddPoint(1, 1);
+	clip2.time.AddPoint(1200, 600);
+	Timeline t1(640, 360, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	t1.AddClip(&clip1);
+	t1.Open();
+	Timeline t2(640, 360, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	t2.AddClip(&clip2);
+	t2.Open();
+
+	// Play the start of the first timeline, and then seek
+	for (int64_t frame_number = 1; frame_number <= 5; frame_number++)
+		CHECK_CLOSE(1470, t1.GetFrame(frame_number)->GetAudioSamplesCount(), 50);
+	std::shared_ptr<Frame> seeked_frame = t1.GetFrame(300);
+	std::shared_ptr<Frame> next_frame = t1.GetFrame(301);
+
+	// The audio after the seek matches the audio of a timeline which starts at the same frame
+	// (the resamplers restart, instead of continuing with the samples of the previous position)
+	std::shared_ptr<Frame> expected_frame = t2.GetFrame(300);
+	CHECK_CLOSE(1470, seeked_frame->GetAudioSamplesCount(), 50);
+	CHECK_EQUAL(expected_frame->GetAudioSamplesCount(), seeked_frame->GetAudioSamplesCount());
+	for (int sample_index = 0; sample_index < 1400; sample_index += 100)
+		CHECK_CLOSE(expected_frame->GetAudioSample(0, sample_index, 1.0), seeked_frame->GetAudioSample(0, sample_index, 1.0), 0.0001);
+	CHECK_EQUAL(t2.GetFrame(301)->GetAudioSamplesCount(), next_frame->GetAudioSamplesCount());
+
+	t1.Close();
+	t2.Close();
+}
+
+TEST(Streaming_Releases_Frames)
+{
+	// Create a timeline with a clip
+	Timeline t(640, 480, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	stringstream path;
+	path << TEST_MEDIA_PATH << "front3.png";
+	Clip clip1(path.str());
+	t.AddClip(&clip1);
+	t.GetCache()->SetMaxBytes(0);
+	clip1.GetCache()->SetMaxBytes(0);
+	t.Open();
+
+	// Request the frames in order (i.e. an export)
+	t.SetStreaming(true);
+	CHECK_EQUAL(true, t.GetStreaming());
+	CHECK_EQUAL(true, clip1.Reader()->GetStreaming());
+	std::vector<std::shared_ptr<Frame>> frames = t.GetFrames(1, 10);
+	CHECK_EQUAL(10, (int) frames.size());
+	CHECK(t.GetCache()->GetFrame(1) != nullptr);
+	CHECK(clip1.GetCache()->GetFrame(1) != nullptr);
+
+	// Frames far behind the requested frames are dropped from the timeline and clip caches
+	frames = t.GetFrames(100, 10);
+	CHECK_EQUAL(100, frames.front()->number);
+	CHECK(t.GetCache()->GetFrame(1) == nullptr);
+	CHECK(clip1.GetCache()->GetFrame(1) == nullptr);
+	CHECK(t.GetCache()->GetFrame(100) != nullptr);
+
+	t.Close();
+}
+
+TEST(Solid_Color_Layer)
+{
+	// Create a reader of solid red frames (without any pixel memory)
+	CacheMemory cache;
+	for (int64_t number = 1; number <= 30; number++) {
+		std::shared_ptr<Frame> f(new Frame(number, 64, 36, "#000000", 1470, 2));
+		f->AddColor(64, 36, "#ff0000");
+		cache.Add(f);
+	}
+	DummyReader r(Fraction(30, 1), 64, 36, 44100, 2, 1.0, &cache);
+
+	// Create a timeline with a clip of the solid frames
+	Timeline t(64, 36, Fraction(30, 1), 44100, 2, LAYOUT_STEREO);
+	Clip clip1(&r);
+	t.AddClip(&clip1);
+	t.Open();
+
+	// The clip covers the whole frame, so the timeline frame is a solid color (no pixels are drawn)
+	std::shared_ptr<Frame> f = t.GetFrame(5);
+	CHECK_EQUAL(true, f->IsSolidColor());
+	CHECK_EQUAL(QColor("#ff0000").rgba(), QColor(QString::fromStdString(f->SolidColor())).rgba());
+	CHECK_EQUAL(QColor("#ff0000").rgba(), f->GetImage()->pixelColor(10, 10).rgba());
+
+	// A rotated clip is drawn
+	clip1.rotation.AddPoint(1, 45.0);
+	t.ClearAllCache();
+	f = t.GetFrame(6);
+	CHECK_EQUAL(false, f->IsSolidColor());
+
+	t.Close();
+}
+
 }  // SUITE